@@ -1,5 +1,6 @@
 #include <content_browser/importers/obj.hpp>
 
+#include <core/atl/small_vector.hpp>
 #include <cctype>
 
 namespace anton_engine::importers {
@@ -14,10 +15,11 @@ namespace anton_engine::importers {
 
     using stream_iterator = atl::Vector<u8>::const_iterator;
 
+    // Most faces are triangles or quads.
     struct Face_Internal {
-        atl::Vector<u32> vertex_indices;
-        atl::Vector<u32> texture_coordinate_indices;
-        atl::Vector<u32> normal_indices;
+        atl::Small_Vector<u32, 4> vertex_indices;
+        atl::Small_Vector<u32, 4> texture_coordinate_indices;
+        atl::Small_Vector<u32, 4> normal_indices;
     };
 
     struct Mesh_Internal {
@@ -5,10 +5,13 @@
 #include <scripts/camera_movement.hpp>
 #include <engine/components/camera.hpp>
 #include <engine/components/entity_name.hpp>
+#include <engine/components/static_mesh_component.hpp>
 #include <engine/components/transform.hpp>
 #include <scripts/debug_hotkeys.hpp>
+#include <core/atl/allocator.hpp>
 #include <core/diagnostic_macros.hpp>
 #include <engine/ecs/ecs.hpp>
+#include <engine/ecs/jobs_management.hpp>
 #include <engine/input.hpp>
 #include <engine/input/input_internal.hpp>
 #include <engine/material.hpp>
@@ -18,6 +21,7 @@
 #include <core/paths_internal.hpp>
 #include <rendering/renderer.hpp>
 #include <engine/resource_manager.hpp>
+#include <engine/transform_hierarchy.hpp>
 #include <shaders/shader.hpp>
 #include <engine/time_internal.hpp>
 #include <core/filesystem.hpp>
@@ -61,6 +65,7 @@ namespace anton_engine {
     static Resource_Manager<Shader>* shader_manager = nullptr;
     static Resource_Manager<Material>* material_manager = nullptr;
     static ECS* ecs = nullptr;
+    static Transform_Hierarchy* transform_hierarchy = nullptr;
     static atl::Vector<Viewport*> viewports;
     static imgui::Context* imgui_context = nullptr;
     static rendering::Font_Face* comic_sans_face = nullptr;
@@ -126,6 +131,7 @@ namespace anton_engine {
                     if (viewport) {
                         if(viewport->is_active()) {
                             Viewport_Camera::update(viewport_camera, transform);
+                            ecs.mark_dirty<Transform>(entity);
                         }
 
                         Vector2 const viewport_size = viewport->get_size();
@@ -139,6 +145,10 @@ namespace anton_engine {
                 }
             }
 
+            if (transform_hierarchy) {
+                transform_hierarchy->update();
+            }
+
             rendering::update_dynamic_lights();
 
             {
@@ -186,15 +196,17 @@ namespace anton_engine {
                 glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
                 Matrix4 const imgui_projection =
                     math::transform::orthographic(window_pos.x, window_pos.x + window_size.x, window_pos.y + window_size.y, window_pos.y, 1.0f, -1.0f);
-                imgui_shader.set_matrix4("proj_mat", imgui_projection);
+                static Name const proj_mat_uniform = "proj_mat"_name;
+                static Name const texture_bound_uniform = "texture_bound"_name;
+                imgui_shader.set_matrix4(proj_mat_uniform, imgui_projection);
 
-                imgui_shader.set_int("texture_bound", 0);
+                imgui_shader.set_int(texture_bound_uniform, 0);
                 u32 last_bound_texture = 0;
                 for (imgui::Draw_Command draw_command: draw_commands) {
                     if(last_bound_texture != draw_command.texture) {
                         imgui::commit_draw();
                         glBindTextureUnit(0, draw_command.texture);
-                        imgui_shader.set_int("texture_bound", draw_command.texture != 0);
+                        imgui_shader.set_int(texture_bound_uniform, draw_command.texture != 0);
                         last_bound_texture = draw_command.texture;
                     }
                     imgui::Draw_Elements_Command viewport_cmd = cmd;
@@ -211,6 +223,8 @@ namespace anton_engine {
         }
 
         ecs->remove_requested_entities();
+        // Nothing allocated from the frame allocator outlives the frame.
+        atl::get_frame_allocator().reset();
     }
 
     // TODO: Forward decl of load_world. Remove (eventually)
@@ -262,7 +276,7 @@ namespace anton_engine {
         atl::String const bindings_file_path = fs::concat_paths(paths::executable_directory(), u8"input_bindings.config");
         atl::String const config_file = assets::read_file_raw_string(bindings_file_path);
         {
-            auto find_property = [](auto& properties, auto predicate) -> atl::Vector<utils::xml::Tag_Property>::iterator {
+            auto find_property = [](auto& properties, auto predicate) -> utils::xml::Tag_Property* {
                 auto end = properties.end();
                 for (auto iter = properties.begin(); iter != end; ++iter) {
                     if (predicate(*iter)) {
@@ -303,10 +317,10 @@ namespace anton_engine {
                         ANTON_LOG_INFO("Missing scale property, skipping...");
                         continue;
                     }
-                    input::add_axis(axis_prop->value.data(), key_from_string(key_prop->value), atl::str_to_f32(sensitivity_prop->value),
+                    input::add_axis(Name(axis_prop->value), key_from_string(key_prop->value), atl::str_to_f32(sensitivity_prop->value),
                                     atl::str_to_f32(accumulation_speed_prop->value), false);
                 } else {
-                    input::add_action(action_prop->value.data(), key_from_string(key_prop->value));
+                    input::add_action(Name(action_prop->value), key_from_string(key_prop->value));
                 }
             }
         }
@@ -343,8 +357,13 @@ namespace anton_engine {
         mesh_manager = new Resource_Manager<Mesh>();
         shader_manager = new Resource_Manager<Shader>();
         material_manager = new Resource_Manager<Material>();
-        ecs = new ECS();
+        ecs = new ECS(ANTON_ECS_ARCHETYPE_STORAGE ? Storage_Mode::archetype : Storage_Mode::sparse_set);
+        if (ecs->get_storage_mode() == Storage_Mode::sparse_set) {
+            // Keeps the transforms of static meshes at the same indices as the meshes, which lets the renderer skip the lookups.
+            ecs->group<Static_Mesh_Component, Transform>();
+        }
         shared_state = new Editor_Shared_State;
+        init_jobs();
 
         {
             imgui::setup_rendering();
@@ -365,15 +384,23 @@ namespace anton_engine {
         imgui::end_frame(*imgui_context);
 
         load_world();
+        // Created after the world has been loaded since deserialization replaces the containers
+        // and with them the change tracking of Transform.
+        if (ecs->get_storage_mode() == Storage_Mode::sparse_set) {
+            transform_hierarchy = new Transform_Hierarchy(*ecs);
+        }
     }
 
     static void terminate() {
+        terminate_jobs();
 #if SERIALIZE_ON_QUIT
         std::filesystem::path serialization_out_path = utils::concat_paths(paths::project_directory(), "ecs.bin");
         std::ofstream file(serialization_out_path, std::ios::binary | std::ios::trunc);
         serialization::Binary_Output_Archive out_archive(file);
         serialize(out_archive, Engine::get_ecs());
 #endif
+        delete transform_hierarchy;
+        transform_hierarchy = nullptr;
         rendering::terminate_font_rendering();
         windowing::terminate();
     }
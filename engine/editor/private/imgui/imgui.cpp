@@ -1,7 +1,7 @@
 #include <imgui/imgui.hpp>
 
 #include <core/assert.hpp>
-#include <core/hashing/murmurhash2.hpp>
+#include <core/hashing/wyhash.hpp>
 #include <core/intrinsics.hpp>
 #include <core/math/math.hpp>
 #include <core/atl/string.hpp>
@@ -140,7 +140,8 @@ namespace anton_engine::imgui {
 
     static i64 hash_string(atl::String_View string) {
         // TODO: Choose better seed. Currently random prime.
-        return murmurhash2_32(string.data(), string.size_bytes(), 758943349);
+        // Truncated to 32 bits so that the ids never collide with -1, which means no window or widget.
+        return static_cast<u32>(wyhash(string.data(), string.size_bytes(), 758943349));
     }
 
     Context* create_context(Font_Style font_style) {
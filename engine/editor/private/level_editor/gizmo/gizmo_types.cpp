@@ -217,11 +217,16 @@ namespace anton_engine::gizmo {
 
         Shader& uniform_color_shader = get_builtin_shader(Builtin_Shader::uniform_color_line_3d);
         uniform_color_shader.use();
-        uniform_color_shader.set_matrix4("model_mat", Matrix4::identity);
-        uniform_color_shader.set_matrix4("vp_mat", vp_mat);
-        uniform_color_shader.set_vec4("color", Color::green);
-        uniform_color_shader.set_vec3("camera_pos", camera_pos);
-        uniform_color_shader.set_float("line_width", 0.018f);
+        static Name const model_mat_uniform = "model_mat"_name;
+        static Name const vp_mat_uniform = "vp_mat"_name;
+        static Name const color_uniform = "color"_name;
+        static Name const camera_pos_uniform = "camera_pos"_name;
+        static Name const line_width_uniform = "line_width"_name;
+        uniform_color_shader.set_matrix4(model_mat_uniform, Matrix4::identity);
+        uniform_color_shader.set_matrix4(vp_mat_uniform, vp_mat);
+        uniform_color_shader.set_vec4(color_uniform, Color::green);
+        uniform_color_shader.set_vec3(camera_pos_uniform, camera_pos);
+        uniform_color_shader.set_float(line_width_uniform, 0.018f);
 
         glNamedBufferSubData(vbo, sizeof(Gizmos_Vertex_Data), sizeof(Line_Data), &lines);
         glBindVertexArray(line_vao);
@@ -307,10 +312,10 @@ namespace anton_engine::gizmo {
         //     float scale = compute_scale(world_transform, arrow.size, vp_mat, viewport_size);
         //     uniform_color_shader.set_matrix4(
         //         "model_mat", math::transform::scale(Vector3{1.0f, 1.0f, (arrow.draw_style == Arrow_3D_Style::cone ? 8.0f : 8.5f)} * scale) * world_transform);
-        //     uniform_color_shader.set_matrix4("vp_mat", vp_mat);
-        //     uniform_color_shader.set_vec4("color", Color(1.0f, 147.0f / 255.0f, 1.0f / 255.0f));
-        //     uniform_color_shader.set_vec3("camera_pos", camera_pos);
-        //     uniform_color_shader.set_float("line_width", scale * 0.01f);
+        //     uniform_color_shader.set_matrix4("vp_mat"_name, vp_mat);
+        //     uniform_color_shader.set_vec4("color"_name, Color(1.0f, 147.0f / 255.0f, 1.0f / 255.0f));
+        //     uniform_color_shader.set_vec3("camera_pos"_name, camera_pos);
+        //     uniform_color_shader.set_float("line_width"_name, scale * 0.01f);
         //     glBindVertexArray(line_vao);
         //     u64 const base_offset = offsetof(Gizmos_Vertex_Data, intersection_meshes);
         //     glBindVertexBuffer(0, vbo, base_offset + offsetof(Intersection_Meshes, vertices), sizeof(Vector3));
@@ -326,7 +331,7 @@ namespace anton_engine::gizmo {
         //     glMultiDrawArrays(GL_TRIANGLE_STRIP, first, count, 12);
         //     switch (arrow.draw_style) {
         //         case Arrow_3D_Style::cube: {
-        //             uniform_color_shader.set_matrix4("model_mat", math::transform::scale(Vector3{2.0f, 2.0f, 2.0f} * scale) *
+        //             uniform_color_shader.set_matrix4("model_mat"_name, math::transform::scale(Vector3{2.0f, 2.0f, 2.0f} * scale) *
         //                                                               math::transform::translate(Vector3{0.0f, 0.0f, -0.85f} * scale) * world_transform);
         //             glMultiDrawArrays(GL_TRIANGLE_STRIP, first, count, 12);
         //         } break;
@@ -341,9 +346,11 @@ namespace anton_engine::gizmo {
 
         Shader& uniform_color_shader = get_builtin_shader(Builtin_Shader::uniform_color_3d);
         uniform_color_shader.use();
-        uniform_color_shader.set_vec4("color", arrow.color);
+        static Name const color_uniform = "color"_name;
+        static Name const mvp_mat_uniform = "mvp_mat"_name;
+        uniform_color_shader.set_vec4(color_uniform, arrow.color);
         float scale = compute_scale(world_transform, arrow.size, view_projection_matrix, viewport_size);
-        uniform_color_shader.set_matrix4("mvp_mat", math::transform::scale(scale) * world_transform * view_projection_matrix);
+        uniform_color_shader.set_matrix4(mvp_mat_uniform, math::transform::scale(scale) * world_transform * view_projection_matrix);
         glBindVertexArray(vao);
         switch (arrow.draw_style) {
             case Arrow_3D_Style::cone: {
@@ -439,11 +446,16 @@ namespace anton_engine::gizmo {
         Shader& uniform_color_shader = get_builtin_shader(Builtin_Shader::uniform_color_line_3d);
         uniform_color_shader.use();
         float scale = compute_scale(world_transform, dial.size, vp_mat, viewport_size);
-        uniform_color_shader.set_matrix4("model_mat", math::transform::scale(scale) * world_transform);
-        uniform_color_shader.set_matrix4("vp_mat", vp_mat);
-        uniform_color_shader.set_vec4("color", dial.color);
-        uniform_color_shader.set_vec3("camera_pos", camera_pos);
-        uniform_color_shader.set_float("line_width", scale * 0.018f);
+        static Name const model_mat_uniform = "model_mat"_name;
+        static Name const vp_mat_uniform = "vp_mat"_name;
+        static Name const color_uniform = "color"_name;
+        static Name const camera_pos_uniform = "camera_pos"_name;
+        static Name const line_width_uniform = "line_width"_name;
+        uniform_color_shader.set_matrix4(model_mat_uniform, math::transform::scale(scale) * world_transform);
+        uniform_color_shader.set_matrix4(vp_mat_uniform, vp_mat);
+        uniform_color_shader.set_vec4(color_uniform, dial.color);
+        uniform_color_shader.set_vec3(camera_pos_uniform, camera_pos);
+        uniform_color_shader.set_float(line_width_uniform, scale * 0.018f);
         glBindVertexArray(line_vao);
         // TODO: Temporarily rebind on each draw because debug geometry binds its own offsets.
         u64 const base_offset = offsetof(Gizmos_Vertex_Data, dial);
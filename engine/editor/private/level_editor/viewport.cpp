@@ -7,6 +7,7 @@
 #include <engine/components/camera.hpp>
 #include <engine/components/static_mesh_component.hpp>
 #include <engine/components/transform.hpp>
+#include <engine/components/world_transform.hpp>
 #include <engine/ecs/ecs.hpp>
 #include <editor.hpp>
 #include <editor_preferences.hpp>
@@ -330,6 +331,7 @@ namespace anton_engine {
                         //    ecs.get_component<Transform>(entity);
                         //}
                         transform_ref.local_position = gizmo_ctx.grab.cached_transform.local_position + delta_position;
+                        ecs.mark_dirty<Transform>(selected_entities[0]);
                     } break;
                     case Gizmo_Transform_Type::rotate: {
                     } break;
@@ -342,6 +344,7 @@ namespace anton_engine {
                         //    ecs.get_component<Transform>(entity);
                         //}
                         transform_ref.local_scale = gizmo_ctx.grab.cached_transform.local_scale + delta_position;
+                        ecs.mark_dirty<Transform>(selected_entities[0]);
                     } break;
                     }
                 }
@@ -355,7 +358,8 @@ namespace anton_engine {
                               Matrix4 const projection, Color const outline_color) {
         Shader& uniform_color_shader = get_builtin_shader(Builtin_Shader::uniform_color_3d);
         uniform_color_shader.use();
-        uniform_color_shader.set_vec4("color", outline_color);
+        static Name const color_uniform = "color"_name;
+        uniform_color_shader.set_vec4(color_uniform, outline_color);
 
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT);
@@ -368,7 +372,7 @@ namespace anton_engine {
         //     if (transform && static_mesh) {
         //         Mesh const& mesh = mesh_manager.get(static_mesh->mesh_handle);
         //         Matrix4 const mvp_mat = transform->to_matrix() * view * projection;
-        //         uniform_color_shader.set_matrix4("mvp_mat", mvp_mat);
+        //         uniform_color_shader.set_matrix4("mvp_mat"_name, mvp_mat);
         //         rendering::render_mesh(mesh);
         //     }
         // }
@@ -525,7 +529,8 @@ namespace anton_engine {
         view_mat[3][0] = 0.0f;
         view_mat[3][1] = 0.0f;
         view_mat[3][2] = 0.0f;
-        skybox_shader.set_matrix4("vp_mat", view_mat * proj_mat);
+        static Name const vp_mat_uniform = "vp_mat"_name;
+        skybox_shader.set_matrix4(vp_mat_uniform, view_mat * proj_mat);
         glBindTextureUnit(0, cube_map_texture);
         rendering::bind_persistent_geometry_buffers();
         rendering::add_draw_command(rendering::Draw_Persistent_Geometry_Command{(u32)cube_handle, 1, 0});
@@ -541,14 +546,21 @@ namespace anton_engine {
         grid_shader.use();
         Matrix4 const model_mat = math::transform::rotate_x(math::constants::half_pi) * math::transform::scale(camera.far_plane) *
                                   math::transform::translate({camera_pos.x, 0.0f, camera_pos.z});
-        grid_shader.set_matrix4("model_mat", model_mat);
-        grid_shader.set_matrix4("vp_mat", view_proj_mat);
-        grid_shader.set_vec3("camera_pos", camera_pos);
-        grid_shader.set_vec2("rcp_res", {1.0f / viewport_size.x, 1.0f / viewport_size.y});
+        static Name const model_mat_uniform = "model_mat"_name;
+        static Name const vp_mat_uniform = "vp_mat"_name;
+        static Name const camera_pos_uniform = "camera_pos"_name;
+        static Name const rcp_res_uniform = "rcp_res"_name;
+        static Name const grid_flags_uniform = "grid_flags"_name;
+        static Name const axis_x_color_uniform = "axis_x_color"_name;
+        static Name const axis_z_color_uniform = "axis_z_color"_name;
+        grid_shader.set_matrix4(model_mat_uniform, model_mat);
+        grid_shader.set_matrix4(vp_mat_uniform, view_proj_mat);
+        grid_shader.set_vec3(camera_pos_uniform, camera_pos);
+        grid_shader.set_vec2(rcp_res_uniform, {1.0f / viewport_size.x, 1.0f / viewport_size.y});
         Grid_Settings const grid = get_editor_preferences().grid_settings;
-        grid_shader.set_uint("grid_flags", grid.grid_flags);
-        grid_shader.set_vec4("axis_x_color", grid.axis_x_color);
-        grid_shader.set_vec4("axis_z_color", grid.axis_z_color);
+        grid_shader.set_uint(grid_flags_uniform, grid.grid_flags);
+        grid_shader.set_vec4(axis_x_color_uniform, grid.axis_x_color);
+        grid_shader.set_vec4(axis_z_color_uniform, grid.axis_z_color);
         glDisable(GL_CULL_FACE);
         glEnable(GL_BLEND);
         glDepthMask(GL_FALSE);
@@ -582,7 +594,7 @@ namespace anton_engine {
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         ECS& ecs = Editor::get_ecs();
-        ECS snapshot = ecs.snapshot<Transform, Static_Mesh_Component>();
+        ECS snapshot = ecs.snapshot<Transform, World_Transform, Static_Mesh_Component>(Snapshot_Mode::shared);
         rendering::render_scene(snapshot, camera_transform, view_mat, proj_mat);
 
         bind_framebuffer(multisampled_framebuffer);
@@ -593,10 +605,14 @@ namespace anton_engine {
 
         Shader& deferred_shading = get_builtin_shader(Builtin_Shader::deferred_shading);
         deferred_shading.use();
-        deferred_shading.set_vec3("camera.position", camera_transform.local_position);
-        deferred_shading.set_vec2("viewport_size", viewport_size);
-        deferred_shading.set_matrix4("inv_view_mat", inv_view_mat);
-        deferred_shading.set_matrix4("inv_proj_mat", inv_proj_mat);
+        static Name const camera_position_uniform = "camera.position"_name;
+        static Name const viewport_size_uniform = "viewport_size"_name;
+        static Name const inv_view_mat_uniform = "inv_view_mat"_name;
+        static Name const inv_proj_mat_uniform = "inv_proj_mat"_name;
+        deferred_shading.set_vec3(camera_position_uniform, camera_transform.local_position);
+        deferred_shading.set_vec2(viewport_size_uniform, viewport_size);
+        deferred_shading.set_matrix4(inv_view_mat_uniform, inv_view_mat);
+        deferred_shading.set_matrix4(inv_proj_mat_uniform, inv_proj_mat);
         rendering::render_texture_quad();
         // TODO: Vertex buffers rebind after call to render_texture_quad
         rendering::bind_transient_geometry_buffers();
@@ -614,7 +630,8 @@ namespace anton_engine {
         glBindTextureUnit(0, framebuffer->get_color_texture(0));
         Shader& gamma_correction_shader = get_builtin_shader(Builtin_Shader::gamma_correction);
         gamma_correction_shader.use();
-        gamma_correction_shader.set_float("gamma", 1 / 2.2f);
+        static Name const gamma_uniform = "gamma"_name;
+        gamma_correction_shader.set_float(gamma_uniform, 1 / 2.2f);
         rendering::bind_mesh_vao();
         rendering::render_texture_quad();
 
@@ -10,9 +10,16 @@
 
 namespace anton_engine {
     void Viewport_Camera::update(Viewport_Camera& camera, Transform& transform) {
+        static Name const mouse_x_axis = "mouse_x"_name;
+        static Name const mouse_y_axis = "mouse_y"_name;
+        static Name const move_forward_axis = "move_forward"_name;
+        static Name const move_sideways_axis = "move_sideways"_name;
+        static Name const move_vertical_axis = "move_vertical"_name;
+        static Name const scroll_axis = "scroll"_name;
+
         // Look around
-        float horizontal_rotation = input::get_axis("mouse_x");
-        float vertical_rotation = input::get_axis("mouse_y");
+        float horizontal_rotation = input::get_axis(mouse_x_axis);
+        float vertical_rotation = input::get_axis(mouse_y_axis);
         transform.rotate(Vector3::up, math::radians(-horizontal_rotation));
         camera.camera_side = Vector3(Vector4(camera.camera_side) * math::transform::rotate_y(math::radians(horizontal_rotation)));
         transform.rotate(camera.camera_side, math::radians(vertical_rotation));
@@ -20,14 +27,14 @@ namespace anton_engine {
         // Move
         Vector3 camera_front = get_camera_front(transform);
         float camera_speed = 0.15f * 60 * get_delta_time();
-        float forward = input::get_axis("move_forward");
+        float forward = input::get_axis(move_forward_axis);
         transform.translate(camera_front * camera_speed * forward);
-        float sideways = input::get_axis("move_sideways");
+        float sideways = input::get_axis(move_sideways_axis);
         transform.translate(camera.camera_side * camera_speed * sideways);
-        float vertical = input::get_axis("move_vertical");
+        float vertical = input::get_axis(move_vertical_axis);
         transform.translate(Vector3::up * camera_speed * vertical);
 
-        float scroll = input::get_axis("scroll");
+        float scroll = input::get_axis(scroll_axis);
         transform.translate(camera_front * scroll);
     }
 } // namespace anton_engine
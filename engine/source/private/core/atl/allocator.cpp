@@ -1,8 +1,16 @@
 #include <core/atl/allocator.hpp>
 
+#include <build_config.hpp>
+#include <core/anton_crt.hpp>
+#include <core/assert.hpp>
 #include <core/atl/detail/utility_common.hpp>
+#include <core/atl/vector.hpp>
 #include <core/math/math.hpp>
+
+#include <atomic>
+#include <mutex>
 #include <new>
+#include <thread>
 
 namespace anton_engine::atl {
     static Allocator default_allocator;
@@ -47,6 +55,474 @@ namespace anton_engine::atl {
         return this == &other;
     }
 
+    // Frame_Allocator
+
+    struct Frame_Allocator::Block {
+        Block* next;
+        // Size of the memory that follows the header.
+        isize size;
+
+        [[nodiscard]] char* data() {
+            return reinterpret_cast<char*>(this + 1);
+        }
+    };
+
+    struct Frame_Allocator::Thread_Arena {
+        std::thread::id thread;
+        Block* first_block = nullptr;
+        Block* current_block = nullptr;
+        // Offset of the first free byte in current_block.
+        isize offset = 0;
+    };
+
+    struct Frame_Allocator::Arenas {
+        std::mutex mutex;
+        Vector<Thread_Arena*> arenas;
+    };
+
+    constexpr isize frame_block_alignment = 16;
+    constexpr u8 frame_poison_value = 0xCD;
+    static std::atomic<u64> next_frame_allocator_id = 0;
+
+    static void poison_frame_memory([[maybe_unused]] void* const memory, [[maybe_unused]] isize const size) {
+#if ANTON_FRAME_ALLOCATOR_POISON
+        memset(memory, frame_poison_value, static_cast<usize>(size));
+#endif
+    }
+
+    Frame_Allocator::Frame_Allocator(isize const block_size): arenas(new Arenas), block_size(block_size), id(next_frame_allocator_id.fetch_add(1)) {}
+
+    Frame_Allocator::~Frame_Allocator() {
+        Memory_Allocator* const allocator = get_default_allocator();
+        for (Thread_Arena* const arena: arenas->arenas) {
+            for (Block* block = arena->first_block; block;) {
+                Block* const next = block->next;
+                allocator->deallocate(block, static_cast<isize>(sizeof(Block)) + block->size, frame_block_alignment);
+                block = next;
+            }
+            delete arena;
+        }
+        delete arenas;
+    }
+
+    void* Frame_Allocator::allocate(isize const size, isize const alignment) {
+        if (size <= 0 || alignment <= 0) {
+            return nullptr;
+        }
+
+        Thread_Arena& arena = get_thread_arena();
+        while (true) {
+            Block* const block = arena.current_block;
+            if (block) {
+                usize const address = reinterpret_cast<usize>(block->data() + arena.offset);
+                isize const padding = static_cast<isize>((alignment - address % alignment) % alignment);
+                if (arena.offset + padding + size <= block->size) {
+                    void* const memory = block->data() + arena.offset + padding;
+                    arena.offset += padding + size;
+                    return memory;
+                }
+
+                if (block->next) {
+                    arena.current_block = block->next;
+                    arena.offset = 0;
+                    continue;
+                }
+            }
+
+            // Overflow. Continue in a new block.
+            isize const new_block_size = math::max(block_size, size + alignment);
+            void* const memory = get_default_allocator()->allocate(static_cast<isize>(sizeof(Block)) + new_block_size, frame_block_alignment);
+            Block* const new_block = new (memory) Block{nullptr, new_block_size};
+            poison_frame_memory(new_block->data(), new_block_size);
+            if (block) {
+                block->next = new_block;
+            } else {
+                arena.first_block = new_block;
+            }
+            arena.current_block = new_block;
+            arena.offset = 0;
+        }
+    }
+
+    void Frame_Allocator::deallocate(void* const memory, isize const size, isize) {
+        if (!memory || size <= 0) {
+            return;
+        }
+
+        Thread_Arena& arena = get_thread_arena();
+        Block* const block = arena.current_block;
+        char* const bytes = static_cast<char*>(memory);
+        if (block && bytes + size == block->data() + arena.offset) {
+            arena.offset = bytes - block->data();
+            poison_frame_memory(memory, size);
+        }
+    }
+
+    bool Frame_Allocator::is_equal(Memory_Allocator const& other) const {
+        return this == &other;
+    }
+
+    void Frame_Allocator::reset() {
+        std::lock_guard<std::mutex> lock(arenas->mutex);
+        for (Thread_Arena* const arena: arenas->arenas) {
+            if (!arena->current_block) {
+                continue;
+            }
+
+#if ANTON_FRAME_ALLOCATOR_POISON
+            for (Block* block = arena->first_block; block != arena->current_block; block = block->next) {
+                poison_frame_memory(block->data(), block->size);
+            }
+            poison_frame_memory(arena->current_block->data(), arena->offset);
+#endif
+            arena->current_block = arena->first_block;
+            arena->offset = 0;
+        }
+    }
+
+    Frame_Allocator::Thread_Arena& Frame_Allocator::get_thread_arena() {
+        // Caches the arena of the allocator the thread has used most recently.
+        thread_local u64 cached_id = static_cast<u64>(-1);
+        thread_local Thread_Arena* cached_arena = nullptr;
+        if (cached_id == id) {
+            return *cached_arena;
+        }
+
+        std::thread::id const thread = std::this_thread::get_id();
+        std::lock_guard<std::mutex> lock(arenas->mutex);
+        Thread_Arena* arena = nullptr;
+        for (Thread_Arena* const a: arenas->arenas) {
+            if (a->thread == thread) {
+                arena = a;
+                break;
+            }
+        }
+
+        if (!arena) {
+            arena = new Thread_Arena;
+            arena->thread = thread;
+            arenas->arenas.push_back(arena);
+        }
+
+        cached_id = id;
+        cached_arena = arena;
+        return *arena;
+    }
+
+    Frame_Allocator& get_frame_allocator() {
+        static Frame_Allocator frame_allocator;
+        return frame_allocator;
+    }
+
+    // Pool_Allocator
+
+    struct Pool_Allocator::Free_Block {
+        Free_Block* next;
+    };
+
+    [[nodiscard]] static isize align_size(isize const size, isize const alignment) {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    Pool_Allocator::Pool_Allocator(isize const size, isize const alignment, isize const blocks_per_chunk): blocks_per_chunk(blocks_per_chunk) {
+        ANTON_ASSERT(blocks_per_chunk > 0, "Pool_Allocator requires at least 1 block per chunk.");
+        block_alignment = math::max(alignment, static_cast<isize>(alignof(Free_Block)));
+        block_size = align_size(math::max(size, static_cast<isize>(sizeof(Free_Block))), block_alignment);
+        chunk_header_size = align_size(sizeof(void*), block_alignment);
+    }
+
+    Pool_Allocator::~Pool_Allocator() {
+        Memory_Allocator* const allocator = get_default_allocator();
+        isize const chunk_size = chunk_header_size + block_size * blocks_per_chunk;
+        while (chunks) {
+            void* const next = *static_cast<void**>(chunks);
+            allocator->deallocate(chunks, chunk_size, block_alignment);
+            chunks = next;
+        }
+    }
+
+    void* Pool_Allocator::allocate(isize const size, isize const alignment) {
+        if (size <= 0 || alignment <= 0) {
+            return nullptr;
+        }
+
+        ANTON_ASSERT(size <= block_size && alignment <= block_alignment, "Requested memory does not fit in a block of the pool.");
+        if (!free_blocks) {
+            isize const chunk_size = chunk_header_size + block_size * blocks_per_chunk;
+            char* const chunk = static_cast<char*>(get_default_allocator()->allocate(chunk_size, block_alignment));
+            *reinterpret_cast<void**>(chunk) = chunks;
+            chunks = chunk;
+            // Link the blocks in address order.
+            for (isize i = blocks_per_chunk - 1; i >= 0; --i) {
+                Free_Block* const block = new (chunk + chunk_header_size + i * block_size) Free_Block{free_blocks};
+                free_blocks = block;
+            }
+        }
+
+        Free_Block* const block = free_blocks;
+        free_blocks = block->next;
+        return block;
+    }
+
+    void Pool_Allocator::deallocate(void* const memory, isize, isize) {
+        if (!memory) {
+            return;
+        }
+
+        free_blocks = new (memory) Free_Block{free_blocks};
+    }
+
+    bool Pool_Allocator::is_equal(Memory_Allocator const& other) const {
+        return this == &other;
+    }
+
+    // TLSF_Allocator
+
+    struct TLSF_Allocator::Block {
+        // Valid only if the previous physical block is free.
+        Block* previous_physical;
+        // Size of the memory following the header.
+        // Bit 0 is set if the block is free, bit 1 is set if the previous physical block is free.
+        usize size_and_flags;
+        // The links of the free lists are stored in the memory of the free blocks.
+        Block* next_free;
+        Block* previous_free;
+
+        [[nodiscard]] usize size() const;
+        void set_size(usize size);
+        [[nodiscard]] char* memory();
+        [[nodiscard]] Block* next_physical();
+    };
+
+    constexpr usize tlsf_free_bit = 1;
+    constexpr usize tlsf_previous_free_bit = 2;
+    constexpr usize tlsf_flag_bits = tlsf_free_bit | tlsf_previous_free_bit;
+    constexpr i64 tlsf_granularity_log2 = 4;
+    constexpr usize tlsf_granularity = 1 << tlsf_granularity_log2;
+    // Size of the header of a block. The free list links are part of the memory of the block.
+    constexpr usize tlsf_header_size = 2 * sizeof(void*);
+    constexpr usize tlsf_min_block_size = 2 * sizeof(void*);
+    // Sizes below are split linearly into the second level lists of the first first level list.
+    constexpr i64 tlsf_small_size_log2 = TLSF_Allocator::tlsf_second_level_count_log2 + tlsf_granularity_log2;
+    constexpr usize tlsf_small_size = usize(1) << tlsf_small_size_log2;
+
+    usize TLSF_Allocator::Block::size() const {
+        return size_and_flags & ~tlsf_flag_bits;
+    }
+
+    void TLSF_Allocator::Block::set_size(usize const size) {
+        size_and_flags = size | (size_and_flags & tlsf_flag_bits);
+    }
+
+    char* TLSF_Allocator::Block::memory() {
+        return reinterpret_cast<char*>(this) + tlsf_header_size;
+    }
+
+    TLSF_Allocator::Block* TLSF_Allocator::Block::next_physical() {
+        return reinterpret_cast<Block*>(memory() + size());
+    }
+
+    // The bit scans are on the path of every allocation, hence prefer the instructions to the generic math functions.
+    [[nodiscard]] static i64 tlsf_floor_log2(usize const v) {
+#if defined(__clang__) || defined(__GNUC__)
+        return 63 - __builtin_clzll(v);
+#else
+        return 63 - static_cast<i64>(math::clz(static_cast<u64>(v)));
+#endif
+    }
+
+    [[nodiscard]] static i64 tlsf_find_first_set(u32 const v) {
+#if defined(__clang__) || defined(__GNUC__)
+        return __builtin_ctz(v);
+#else
+        return static_cast<i64>(math::popcount((v & (~v + 1)) - 1));
+#endif
+    }
+
+    // Computes the first and second level indices of the list that holds the blocks of size.
+    static void tlsf_mapping(usize const size, i64& first_level, i64& second_level) {
+        if (size < tlsf_small_size) {
+            first_level = 0;
+            second_level = static_cast<i64>(size >> tlsf_granularity_log2);
+        } else {
+            i64 const log2 = tlsf_floor_log2(size);
+            second_level = static_cast<i64>((size >> (log2 - TLSF_Allocator::tlsf_second_level_count_log2)) ^ TLSF_Allocator::tlsf_second_level_count);
+            first_level = log2 - tlsf_small_size_log2 + 1;
+        }
+    }
+
+    TLSF_Allocator::TLSF_Allocator(isize const capacity): capacity(capacity / tlsf_granularity * tlsf_granularity) {
+        ANTON_VERIFY(this->capacity >= static_cast<isize>(2 * tlsf_header_size + tlsf_min_block_size), "TLSF_Allocator capacity is too small.");
+        ANTON_VERIFY(this->capacity < (isize(1) << (tlsf_first_level_count + tlsf_small_size_log2 - 1)), "TLSF_Allocator capacity is too large.");
+        memory = static_cast<char*>(get_default_allocator()->allocate(this->capacity, tlsf_granularity));
+        // A single free block spans the range. A zero-sized used block at the end terminates the physical list
+        // so that blocks never have to check whether they are the last one.
+        Block* const block = reinterpret_cast<Block*>(memory);
+        block->previous_physical = nullptr;
+        block->size_and_flags = (static_cast<usize>(this->capacity) - 2 * tlsf_header_size) | tlsf_free_bit;
+        Block* const sentinel = block->next_physical();
+        sentinel->previous_physical = block;
+        sentinel->size_and_flags = tlsf_previous_free_bit;
+        insert_free_block(block);
+    }
+
+    TLSF_Allocator::~TLSF_Allocator() {
+        get_default_allocator()->deallocate(memory, capacity, tlsf_granularity);
+    }
+
+    void* TLSF_Allocator::allocate(isize const size, isize const alignment) {
+        if (size <= 0 || alignment <= 0) {
+            return nullptr;
+        }
+
+        usize const adjusted_size = static_cast<usize>(align_size(math::max(size, static_cast<isize>(tlsf_min_block_size)), tlsf_granularity));
+        // Blocks are aligned to the granularity. Stricter alignments need room for a free block before the aligned memory.
+        bool const overaligned = static_cast<usize>(alignment) > tlsf_granularity;
+        usize const search_size = overaligned ? adjusted_size + static_cast<usize>(alignment) + tlsf_header_size : adjusted_size;
+        Block* block = find_free_block(static_cast<isize>(search_size));
+        ANTON_VERIFY(block, "TLSF_Allocator is out of memory.");
+        remove_free_block(block);
+
+        if (overaligned) {
+            usize const address = reinterpret_cast<usize>(block->memory());
+            usize const aligned_address = static_cast<usize>(align_size(static_cast<isize>(address), alignment));
+            usize gap = aligned_address - address;
+            if (gap != 0 && gap < tlsf_header_size + tlsf_min_block_size) {
+                gap += static_cast<usize>(alignment);
+            }
+
+            if (gap != 0) {
+                // Split the front off into a free block. The previous physical block of block is not free
+                // since adjacent free blocks are always coalesced.
+                Block* const aligned_block = reinterpret_cast<Block*>(block->memory() + gap - tlsf_header_size);
+                aligned_block->previous_physical = block;
+                aligned_block->size_and_flags = (block->size() - gap) | tlsf_free_bit | tlsf_previous_free_bit;
+                aligned_block->next_physical()->previous_physical = aligned_block;
+                block->set_size(gap - tlsf_header_size);
+                insert_free_block(block);
+                block = aligned_block;
+            }
+        }
+
+        trim_free_tail(block, static_cast<isize>(adjusted_size));
+        block->size_and_flags &= ~tlsf_free_bit;
+        block->next_physical()->size_and_flags &= ~tlsf_previous_free_bit;
+        return block->memory();
+    }
+
+    void TLSF_Allocator::deallocate(void* const mem, isize, isize) {
+        if (!mem) {
+            return;
+        }
+
+        Block* block = reinterpret_cast<Block*>(static_cast<char*>(mem) - tlsf_header_size);
+        ANTON_ASSERT(!(block->size_and_flags & tlsf_free_bit), "Deallocating memory that has already been deallocated.");
+        block->size_and_flags |= tlsf_free_bit;
+        if (block->size_and_flags & tlsf_previous_free_bit) {
+            Block* const previous = block->previous_physical;
+            remove_free_block(previous);
+            previous->set_size(previous->size() + tlsf_header_size + block->size());
+            block = previous;
+        }
+
+        Block* const next = block->next_physical();
+        if (next->size_and_flags & tlsf_free_bit) {
+            remove_free_block(next);
+            block->set_size(block->size() + tlsf_header_size + next->size());
+        }
+
+        Block* const following = block->next_physical();
+        following->previous_physical = block;
+        following->size_and_flags |= tlsf_previous_free_bit;
+        insert_free_block(block);
+    }
+
+    bool TLSF_Allocator::is_equal(Memory_Allocator const& other) const {
+        return this == &other;
+    }
+
+    void TLSF_Allocator::insert_free_block(Block* const block) {
+        i64 first_level;
+        i64 second_level;
+        tlsf_mapping(block->size(), first_level, second_level);
+        Block*& head = free_lists[first_level][second_level];
+        block->next_free = head;
+        block->previous_free = nullptr;
+        if (head) {
+            head->previous_free = block;
+        }
+        head = block;
+        first_level_bitmap |= u32(1) << first_level;
+        second_level_bitmaps[first_level] |= u32(1) << second_level;
+    }
+
+    void TLSF_Allocator::remove_free_block(Block* const block) {
+        if (block->next_free) {
+            block->next_free->previous_free = block->previous_free;
+        }
+
+        if (block->previous_free) {
+            block->previous_free->next_free = block->next_free;
+            return;
+        }
+
+        i64 first_level;
+        i64 second_level;
+        tlsf_mapping(block->size(), first_level, second_level);
+        free_lists[first_level][second_level] = block->next_free;
+        if (!block->next_free) {
+            second_level_bitmaps[first_level] &= ~(u32(1) << second_level);
+            if (second_level_bitmaps[first_level] == 0) {
+                first_level_bitmap &= ~(u32(1) << first_level);
+            }
+        }
+    }
+
+    TLSF_Allocator::Block* TLSF_Allocator::find_free_block(isize const size) {
+        // Round the size up to the next list so that every block in the list found is large enough.
+        usize rounded_size = static_cast<usize>(size);
+        if (rounded_size >= tlsf_small_size) {
+            rounded_size += (usize(1) << (tlsf_floor_log2(rounded_size) - tlsf_second_level_count_log2)) - 1;
+        }
+
+        i64 first_level;
+        i64 second_level;
+        tlsf_mapping(rounded_size, first_level, second_level);
+        if (first_level >= tlsf_first_level_count) {
+            return nullptr;
+        }
+
+        u32 second_level_map = second_level_bitmaps[first_level] & (~u32(0) << second_level);
+        if (!second_level_map) {
+            u32 const first_level_map = first_level + 1 < tlsf_first_level_count ? first_level_bitmap & (~u32(0) << (first_level + 1)) : 0;
+            if (!first_level_map) {
+                return nullptr;
+            }
+
+            first_level = tlsf_find_first_set(first_level_map);
+            second_level_map = second_level_bitmaps[first_level];
+        }
+
+        second_level = tlsf_find_first_set(second_level_map);
+        return free_lists[first_level][second_level];
+    }
+
+    void TLSF_Allocator::trim_free_tail(Block* const block, isize const size) {
+        usize const block_size = block->size();
+        usize const used_size = static_cast<usize>(size);
+        if (block_size < used_size + tlsf_header_size + tlsf_min_block_size) {
+            return;
+        }
+
+        // The next physical block of a free block is never free, hence the tail does not need to be coalesced.
+        Block* const tail = reinterpret_cast<Block*>(block->memory() + used_size);
+        tail->previous_physical = block;
+        tail->size_and_flags = (block_size - used_size - tlsf_header_size) | tlsf_free_bit;
+        tail->next_physical()->previous_physical = tail;
+        block->set_size(used_size);
+        insert_free_block(tail);
+    }
+
     // Buffer Allocator
 
     static char* adjust_to_alignment(char* address, usize alignment) {
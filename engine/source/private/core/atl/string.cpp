@@ -10,6 +10,7 @@
 #include <core/atl/type_traits.hpp>
 #include <core/unicode/common.hpp>
 #include <core/anton_crt.hpp>
+#include <core/assert.hpp>
 
 // TODO: Replace with format.
 #include <stdio.h> // sprintf
@@ -27,98 +28,73 @@ namespace anton_engine::atl {
     String::String(): String(allocator_type()) {}
 
     String::String(allocator_type const& allocator): _allocator(allocator) {
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data, 0, _capacity);
+        _inline_data[0] = '\0';
     }
 
     String::String(Reserve_Tag, size_type n): String(atl::reserve, n, allocator_type()) {}
 
-    String::String(Reserve_Tag, size_type n, allocator_type const&) {
-        _capacity = math::max(_capacity - 1, n) + 1;
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data, 0, _capacity);
+    String::String(Reserve_Tag, size_type n, allocator_type const& allocator): _allocator(allocator) {
+        _inline_data[0] = '\0';
+        ensure_capacity_exact(n);
     }
 
     String::String(value_type const* str): String(str, allocator_type()) {}
 
     String::String(value_type const* cstr, allocator_type const& allocator): _allocator(allocator) {
-        _size = strlen(cstr);
         if constexpr (ANTON_STRING_VERIFY_ENCODING) {
             // TODO: Implement
         }
-        _capacity = math::max(_capacity - 1, _size) + 1;
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(cstr, cstr + _size, _data);
+        initialize(cstr, strlen(cstr));
     }
 
     String::String(value_type const* cstr, size_type n): String(cstr, n, allocator_type()) {}
 
     String::String(value_type const* cstr, size_type n, allocator_type const& allocator): _allocator(allocator) {
-        _size = n;
-        _capacity = math::max(_capacity - 1, n) + 1;
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(cstr, cstr + n, _data);
+        initialize(cstr, n);
     }
 
     String::String(String_View const sv): String(sv, allocator_type()) {}
 
     String::String(String_View const sv, allocator_type const& allocator): _allocator(allocator) {
-        _size = sv.size_bytes();
-        _capacity = math::max(_capacity - 1, _size) + 1;
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(sv.bytes_begin(), sv.bytes_end(), _data);
+        initialize(sv.data(), sv.size_bytes());
     }
 
     String::String(String const& other): String(other, allocator_type()) {}
 
     String::String(String const& other, allocator_type const& allocator): _allocator(allocator) {
-        _size = other._size;
-        _capacity = other._capacity;
-        _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(other._data, other._data + other._size, _data);
+        initialize(other.data(), other._size);
     }
 
-    String::String(String&& other) noexcept: _allocator(atl::move(other._allocator)), _data(other._data), _size(other._size) {
-        other._data = nullptr;
+    String::String(String&& other) noexcept: _allocator(atl::move(other._allocator)), _capacity(other._capacity), _size(other._size) {
+        // The union holds either the pointer to the heap buffer or the inline buffer, so copying it
+        // transfers the contents in both cases.
+        memcpy(_inline_data, other._inline_data, sizeof(_inline_data));
+        other._capacity = inline_capacity;
         other._size = 0;
-        other._capacity = 0;
+        other._inline_data[0] = '\0';
     }
 
     String::String(String&& other, allocator_type const& allocator): _allocator(allocator) {
         if (_allocator == other._allocator) {
-            _data = other._data;
-            other._data = nullptr;
             _capacity = other._capacity;
-            other._capacity = 0;
             _size = other._size;
+            memcpy(_inline_data, other._inline_data, sizeof(_inline_data));
+            other._capacity = inline_capacity;
             other._size = 0;
+            other._inline_data[0] = '\0';
         } else {
-            _size = other._size;
-            _capacity = other._capacity;
-            _data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-            memset(_data + _size, 0, _capacity - _size);
-            atl::move(other._data, other._data + other._size, _data);
+            initialize(other.data(), other._size);
         }
     }
 
     String::~String() {
-        if (_data != nullptr) {
-            _allocator.deallocate(_data, _capacity, alignof(value_type));
-        }
+        release();
     }
 
     String& String::operator=(String const& other) {
-        value_type* new_data = reinterpret_cast<value_type*>(_allocator.allocate(other._capacity, alignof(value_type)));
-        _allocator.deallocate(_data, _capacity, alignof(value_type));
-        _data = new_data;
-        _size = other._size;
-        _capacity = other._capacity;
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(other._data, other._data + other._size, _data);
+        if (this != &other) {
+            assign(other.data(), other._size);
+        }
         return *this;
     }
 
@@ -128,73 +104,61 @@ namespace anton_engine::atl {
     }
 
     String& String::operator=(String_View const sv) {
-        _size = sv.size_bytes();
-        size_type const old_capacity = _capacity;
-        _capacity = 64;
-        while(_capacity < _size + 1) {
-            _capacity *= 2;
-        }
-
-        value_type* new_data = reinterpret_cast<value_type*>(_allocator.allocate(_capacity, alignof(value_type)));
-        _allocator.deallocate(_data, old_capacity, alignof(value_type));
-        _data = new_data;
-
-        memset(_data + _size, 0, _capacity - _size);
-        atl::copy(sv.data(), sv.data() + sv.size_bytes(), _data);
+        assign(sv.data(), sv.size_bytes());
         return *this;
     }
 
     // Implicit conversion operator
     String::operator String_View() const {
-        return {_data, _size};
+        return {data(), _size};
     }
 
     auto String::bytes() -> UTF8_Bytes {
-        return {_data, _data + _size};
+        return {data(), data() + _size};
     }
 
     auto String::bytes() const -> UTF8_Const_Bytes {
-        return {_data, _data + _size};
+        return {data(), data() + _size};
     }
 
     auto String::const_bytes() const -> UTF8_Const_Bytes {
-        return {_data, _data + _size};
+        return {data(), data() + _size};
     }
 
     auto String::chars() const -> UTF8_Chars {
-        return {_data, _data + _size};
+        return {data(), data() + _size};
     }
 
     auto String::bytes_begin() -> byte_iterator {
-        return _data;
+        return data();
     }
 
     auto String::bytes_begin() const -> byte_const_iterator {
-        return _data;
+        return const_cast<value_type*>(data());
     }
 
     auto String::bytes_cbegin() const -> byte_const_iterator {
-        return _data;
+        return const_cast<value_type*>(data());
     }
 
     auto String::bytes_end() -> byte_iterator {
-        return _data + _size;
+        return data() + _size;
     }
 
     auto String::bytes_end() const -> byte_const_iterator {
-        return _data + _size;
+        return const_cast<value_type*>(data()) + _size;
     }
 
     auto String::bytes_cend() const -> byte_const_iterator {
-        return _data + _size;
+        return const_cast<value_type*>(data()) + _size;
     }
 
     auto String::chars_begin() const -> char_iterator {
-        return char_iterator{_data, 0};
+        return char_iterator{data(), 0};
     }
 
     auto String::chars_end() const -> char_iterator {
-        return char_iterator{_data + _size, _size};
+        return char_iterator{data() + _size, _size};
     }
 
     auto String::capacity() const -> size_type {
@@ -218,38 +182,62 @@ namespace anton_engine::atl {
     }
 
     void String::force_size(size_type n) {
+        ANTON_ASSERT(n <= _capacity, "String::force_size: requested size is greater than the capacity.");
         _size = n;
+        data()[_size] = '\0';
     }
 
     void String::clear() {
-        memset(_data, 0, _size);
         _size = 0;
+        data()[0] = '\0';
     }
 
     void String::append(char8 const c) {
-        ensure_capacity(_size + 1);
-        _data[_size] = c;
+        if (_size == _capacity) {
+            ensure_capacity(_size + 1);
+        }
+        value_type* const d = data();
+        d[_size] = c;
         _size += 1;
+        d[_size] = '\0';
     }
 
     void String::append(char32 const c) {
         ensure_capacity(_size + 4);
-        i64 const bytes_written =  unicode::convert_utf32_to_utf8(&c, 4, _data + _size);
+        value_type* const d = data();
+        i64 const bytes_written = unicode::convert_utf32_to_utf8(&c, 4, d + _size);
         _size += bytes_written;
+        d[_size] = '\0';
     }
 
     void String::append(String_View str) {
-        ensure_capacity(_size + str.size_bytes() + 1);
-        atl::copy(str.bytes_begin(), str.bytes_end(), _data + _size);
-        _size += str.size_bytes();
+        size_type const n = str.size_bytes();
+        if (n == 0) {
+            return;
+        }
+
+        if (n > _capacity - _size) {
+            // str might point into this string, therefore we copy it before releasing the old buffer.
+            size_type const new_capacity = math::max(_size + n, 2 * _capacity);
+            value_type* const new_data = static_cast<value_type*>(_allocator.allocate(new_capacity + 1, alignof(value_type)));
+            memcpy(new_data, data(), _size);
+            memcpy(new_data + _size, str.data(), n);
+            release();
+            _heap_data = new_data;
+            _capacity = new_capacity;
+        } else {
+            memcpy(data() + _size, str.data(), n);
+        }
+        _size += n;
+        data()[_size] = '\0';
     }
 
     auto String::data() -> value_type* {
-        return _data;
+        return is_inline() ? _inline_data : _heap_data;
     }
 
     auto String::data() const -> value_type const* {
-        return _data;
+        return is_inline() ? _inline_data : _heap_data;
     }
 
     String::allocator_type& String::get_allocator() {
@@ -260,30 +248,62 @@ namespace anton_engine::atl {
         return _allocator;
     }
 
+    bool String::is_inline() const {
+        return _capacity == inline_capacity;
+    }
+
+    void String::initialize(value_type const* const first, size_type const n) {
+        _size = n;
+        if (n > inline_capacity) {
+            _capacity = n;
+            _heap_data = static_cast<value_type*>(_allocator.allocate(n + 1, alignof(value_type)));
+        }
+        value_type* const d = data();
+        if (n > 0) {
+            memcpy(d, first, n);
+        }
+        d[n] = '\0';
+    }
+
+    void String::assign(value_type const* const first, size_type const n) {
+        if (n > _capacity) {
+            // first might point into this string, therefore we copy it before releasing the old buffer.
+            value_type* const new_data = static_cast<value_type*>(_allocator.allocate(n + 1, alignof(value_type)));
+            memcpy(new_data, first, n);
+            release();
+            _heap_data = new_data;
+            _capacity = n;
+        } else if (n > 0) {
+            memmove(data(), first, n);
+        }
+        _size = n;
+        data()[_size] = '\0';
+    }
+
+    void String::release() {
+        if (!is_inline()) {
+            _allocator.deallocate(_heap_data, _capacity + 1, alignof(value_type));
+        }
+    }
+
+    void String::reallocate(size_type const new_capacity) {
+        value_type* const new_data = static_cast<value_type*>(_allocator.allocate(new_capacity + 1, alignof(value_type)));
+        memcpy(new_data, data(), _size + 1);
+        release();
+        _heap_data = new_data;
+        _capacity = new_capacity;
+    }
+
     void String::ensure_capacity(size_type requested_capacity) {
-        if (requested_capacity >= _capacity) {
-            size_type new_capacity = _capacity;
-            while (new_capacity <= requested_capacity) {
-                new_capacity *= 2;
-            }
-
-            value_type* new_data = static_cast<value_type*>(_allocator.allocate(new_capacity, alignof(value_type)));
-            memset(new_data + _size, 0, new_capacity - _size);
-            atl::move(_data, _data + _size, new_data);
-            _allocator.deallocate(_data, _capacity, alignof(value_type));
-            _data = new_data;
-            _capacity = new_capacity;
+        if (requested_capacity > _capacity) {
+            reallocate(math::max(requested_capacity, 2 * _capacity));
         }
     }
 
     void String::ensure_capacity_exact(size_type requested_capacity) {
+        // _capacity is at least inline_capacity, hence heap buffers are never mistaken for the inline storage.
         if (requested_capacity > _capacity) {
-            value_type* new_data = static_cast<value_type*>(_allocator.allocate(requested_capacity, alignof(value_type)));
-            memset(new_data + _size, 0, requested_capacity - _size);
-            atl::move(_data, _data + _size, new_data);
-            _allocator.deallocate(_data, _capacity, alignof(value_type));
-            _data = new_data;
-            _capacity = requested_capacity;
+            reallocate(requested_capacity);
         }
     }
 
@@ -304,17 +324,25 @@ namespace anton_engine::atl {
 
     void swap(atl::String& str1, atl::String& str2) {
         atl::swap(str1._allocator, str2._allocator);
-        atl::swap(str1._data, str2._data);
         atl::swap(str1._capacity, str2._capacity);
         atl::swap(str1._size, str2._size);
+        // Swapping the raw bytes of the union swaps both the heap pointers and the inline buffers.
+        char8 buffer[sizeof(str1._inline_data)];
+        memcpy(buffer, str1._inline_data, sizeof(buffer));
+        memcpy(str1._inline_data, str2._inline_data, sizeof(buffer));
+        memcpy(str2._inline_data, buffer, sizeof(buffer));
     }
 
     bool operator==(String const& lhs, String const& rhs) {
-        if (lhs.size_bytes() != rhs.size_bytes()) {
-            return false;
-        }
+        return String_View(lhs) == String_View(rhs);
+    }
+
+    bool operator==(String const& lhs, char8 const* const rhs) {
+        return String_View(lhs) == String_View(rhs);
+    }
 
-        return compare_equal(lhs.data(), rhs.data());
+    bool operator==(char8 const* const lhs, String const& rhs) {
+        return String_View(lhs) == String_View(rhs);
     }
 
     String operator+(String const& lhs, String const& rhs) {
@@ -0,0 +1,60 @@
+#include <core/math/transform.hpp>
+
+#include <core/math/simd.hpp>
+
+namespace anton_engine::math::transform {
+    void scale_rotate_translate(Transform_Arrays const& transforms, i64 const count, Matrix4* const out) {
+        i64 i = 0;
+#if ANTON_HAS_SSE2
+        // Computes the elements of the matrices of 4 transforms at a time, one transform per lane,
+        // and transposes them into rows of the output matrices.
+        __m128 const zero = _mm_setzero_ps();
+        __m128 const one = _mm_set1_ps(1.0f);
+        __m128 const two = _mm_set1_ps(2.0f);
+        for (; i + 4 <= count; i += 4) {
+            __m128 const x = _mm_loadu_ps(transforms.rotation[0] + i);
+            __m128 const y = _mm_loadu_ps(transforms.rotation[1] + i);
+            __m128 const z = _mm_loadu_ps(transforms.rotation[2] + i);
+            __m128 const w = _mm_loadu_ps(transforms.rotation[3] + i);
+            __m128 const x2 = _mm_mul_ps(two, x);
+            __m128 const y2 = _mm_mul_ps(two, y);
+            __m128 const z2 = _mm_mul_ps(two, z);
+            __m128 const xx = _mm_mul_ps(x2, x);
+            __m128 const yy = _mm_mul_ps(y2, y);
+            __m128 const zz = _mm_mul_ps(z2, z);
+            __m128 const xy = _mm_mul_ps(x2, y);
+            __m128 const xz = _mm_mul_ps(x2, z);
+            __m128 const yz = _mm_mul_ps(y2, z);
+            __m128 const xw = _mm_mul_ps(x2, w);
+            __m128 const yw = _mm_mul_ps(y2, w);
+            __m128 const zw = _mm_mul_ps(z2, w);
+
+            __m128 const sx = _mm_loadu_ps(transforms.scale[0] + i);
+            __m128 const sy = _mm_loadu_ps(transforms.scale[1] + i);
+            __m128 const sz = _mm_loadu_ps(transforms.scale[2] + i);
+            __m128 rows[4][4] = {
+                {_mm_mul_ps(sx, _mm_sub_ps(_mm_sub_ps(one, yy), zz)), _mm_mul_ps(sx, _mm_add_ps(xy, zw)), _mm_mul_ps(sx, _mm_sub_ps(xz, yw)), zero},
+                {_mm_mul_ps(sy, _mm_sub_ps(xy, zw)), _mm_mul_ps(sy, _mm_sub_ps(_mm_sub_ps(one, xx), zz)), _mm_mul_ps(sy, _mm_add_ps(yz, xw)), zero},
+                {_mm_mul_ps(sz, _mm_add_ps(xz, yw)), _mm_mul_ps(sz, _mm_sub_ps(yz, xw)), _mm_mul_ps(sz, _mm_sub_ps(_mm_sub_ps(one, xx), yy)), zero},
+                {_mm_loadu_ps(transforms.translation[0] + i), _mm_loadu_ps(transforms.translation[1] + i), _mm_loadu_ps(transforms.translation[2] + i), one},
+            };
+
+            float* const dst = reinterpret_cast<float*>(out + i);
+            for (i64 row = 0; row < 4; ++row) {
+                // After the transpose rows[row][k] holds the row of the matrix of the k-th transform.
+                _MM_TRANSPOSE4_PS(rows[row][0], rows[row][1], rows[row][2], rows[row][3]);
+                for (i64 k = 0; k < 4; ++k) {
+                    _mm_storeu_ps(dst + 16 * k + 4 * row, rows[row][k]);
+                }
+            }
+        }
+#endif
+
+        for (; i < count; ++i) {
+            Quaternion const rotation(transforms.rotation[0][i], transforms.rotation[1][i], transforms.rotation[2][i], transforms.rotation[3][i]);
+            Vector3 const translation(transforms.translation[0][i], transforms.translation[1][i], transforms.translation[2][i]);
+            Vector3 const scale(transforms.scale[0][i], transforms.scale[1][i], transforms.scale[2][i]);
+            out[i] = scale_rotate_translate(scale, rotation, translation);
+        }
+    }
+} // namespace anton_engine::math::transform
@@ -0,0 +1,118 @@
+#include <core/name.hpp>
+
+#include <core/anton_crt.hpp>
+#include <core/assert.hpp>
+#include <core/atl/allocator.hpp>
+
+#include <atomic>
+#include <mutex>
+#include <new>
+
+namespace anton_engine {
+    // The capacities are fixed so that the slots and the entries never move,
+    // which lets lookups and get_string read them without locking.
+    constexpr i64 max_names = 32768;
+    // Power of 2 greater than max_names so that probing always finds an empty slot.
+    constexpr i64 slot_count = 2 * max_names;
+    constexpr i64 characters_capacity = 1024 * 1024;
+
+    struct Name_Entry {
+        char8 const* string;
+        i64 size;
+        u64 hash;
+    };
+
+    struct Name_Table {
+        std::mutex mutex;
+        // Index of the entry, which is also the id of the name, or 0 for empty slots.
+        // The empty name has entry 0 and is never inserted into the slots.
+        std::atomic<u32>* slots;
+        Name_Entry* entries;
+        i64 entry_count = 1;
+        char8* characters;
+        i64 characters_size = 1;
+
+        Name_Table() {
+            atl::Memory_Allocator* const allocator = atl::get_default_allocator();
+            slots = static_cast<std::atomic<u32>*>(allocator->allocate(slot_count * sizeof(std::atomic<u32>), alignof(std::atomic<u32>)));
+            for (i64 i = 0; i < slot_count; ++i) {
+                ::new (slots + i) std::atomic<u32>(0);
+            }
+            entries = static_cast<Name_Entry*>(allocator->allocate(max_names * sizeof(Name_Entry), alignof(Name_Entry)));
+            characters = static_cast<char8*>(allocator->allocate(characters_capacity, alignof(char8)));
+            // Entry of the empty name.
+            characters[0] = '\0';
+            entries[0] = {characters, 0, atl::hash(atl::String_View())};
+        }
+    };
+
+    // The table lives until the end of the program, hence it is never destroyed.
+    static Name_Table& get_name_table() {
+        static Name_Table* const table = new Name_Table;
+        return *table;
+    }
+
+    [[nodiscard]] static bool entry_equal(Name_Entry const& entry, atl::String_View const string, u64 const hash) {
+        return entry.hash == hash && entry.size == string.size_bytes() && memcmp(entry.string, string.data(), entry.size) == 0;
+    }
+
+    static u32 intern(atl::String_View const string, u64 const hash) {
+        if (string.size_bytes() == 0) {
+            return 0;
+        }
+
+        Name_Table& table = get_name_table();
+        u64 const mask = slot_count - 1;
+        u64 index = hash & mask;
+        // The slots are written only once, so when we find an empty slot the name is not interned
+        // or is being interned by another thread.
+        for (;; index = (index + 1) & mask) {
+            u32 const id = table.slots[index].load(std::memory_order_acquire);
+            if (id == 0) {
+                break;
+            }
+
+            if (entry_equal(table.entries[id], string, hash)) {
+                return id;
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(table.mutex);
+        // Other threads might have inserted names since we have probed, therefore we continue probing
+        // from the empty slot we have found. Any name inserted meanwhile is at that slot or after it.
+        for (;; index = (index + 1) & mask) {
+            u32 const id = table.slots[index].load(std::memory_order_relaxed);
+            if (id == 0) {
+                break;
+            }
+
+            if (entry_equal(table.entries[id], string, hash)) {
+                return id;
+            }
+        }
+
+        i64 const size = string.size_bytes();
+        ANTON_VERIFY(table.entry_count < max_names, "Name table is full.");
+        ANTON_VERIFY(table.characters_size + size + 1 <= characters_capacity, "Name table has run out of storage for the characters.");
+        char8* const characters = table.characters + table.characters_size;
+        memcpy(characters, string.data(), size);
+        characters[size] = '\0';
+        table.characters_size += size + 1;
+
+        u32 const id = static_cast<u32>(table.entry_count);
+        table.entries[id] = {characters, size, hash};
+        table.entry_count += 1;
+        // Publishes the entry to the lookups that do not lock.
+        table.slots[index].store(id, std::memory_order_release);
+        return id;
+    }
+
+    Name::Name(atl::String_View const string): _id(intern(string, atl::hash(string))) {}
+
+    Name::Name(Name_Literal const literal): _id(intern(literal.string, literal.hash)) {}
+
+    atl::String_View Name::get_string() const {
+        Name_Entry const& entry = get_name_table().entries[_id];
+        return {entry.string, entry.size};
+    }
+} // namespace anton_engine
@@ -10,6 +10,8 @@ namespace anton_engine::utils {
             Tag tag;
             tag.type = Tag_Type::opening;
             State state = State::tag_open;
+            // Names and values are assigned in one go once their end is found instead of being built code point by code point.
+            atl::String_View::char_iterator token_begin = i;
             for (; i != end; ++i) {
                 char32 c = *i;
                 if (c == U'>')
@@ -20,12 +22,11 @@ namespace anton_engine::utils {
                         tag.type = Tag_Type::closing;
                     } else {
                         state = State::tag_name;
-                        tag.name += c;
+                        token_begin = i;
                     }
                 } else if (state == State::tag_name) {
-                    if (std::isalnum(c)) {
-                        tag.name += c;
-                    } else {
+                    if (!std::isalnum(c)) {
+                        tag.name = atl::String_View(token_begin, i);
                         if (c == U'/') {
                             tag.type = Tag_Type::self_closing;
                             state = State::tag_close;
@@ -39,24 +40,24 @@ namespace anton_engine::utils {
                         state = State::tag_close;
                     } else if (std::isalnum(c)) {
                         tag.properties.emplace_back();
-                        tag.properties[tag.properties.size() - 1].name += c;
+                        token_begin = i;
                         state = State::property_name;
                     }
                 } else if (state == State::property_name) {
-                    if (std::isalnum(c)) {
-                        tag.properties[tag.properties.size() - 1].name += c;
-                    } else {
+                    if (!std::isalnum(c)) {
+                        tag.properties[tag.properties.size() - 1].name = atl::String_View(token_begin, i);
                         state = State::property_name_end;
                     }
                 } else if (state == State::property_name_end) {
                     if (c == '"') {
                         state = State::property_value;
+                        token_begin = i;
+                        ++token_begin;
                     }
                 } else if (state == State::property_value) {
                     if (c == '"') {
+                        tag.properties[tag.properties.size() - 1].value = atl::String_View(token_begin, i);
                         state = State::property_value_end;
-                    } else {
-                        tag.properties[tag.properties.size() - 1].value += c;
                     }
                 } else if (state == State::property_value_end) {
                     if (c == '/') {
@@ -64,11 +65,20 @@ namespace anton_engine::utils {
                         state = State::tag_close;
                     } else if (std::isalnum(c)) {
                         tag.properties.emplace_back();
-                        tag.properties[tag.properties.size() - 1].name += c;
+                        token_begin = i;
                         state = State::property_name;
                     }
                 }
             }
+
+            // The tag ended in the middle of a name or a value.
+            if (state == State::tag_name) {
+                tag.name = atl::String_View(token_begin, i);
+            } else if (state == State::property_name) {
+                tag.properties[tag.properties.size() - 1].name = atl::String_View(token_begin, i);
+            } else if (state == State::property_value) {
+                tag.properties[tag.properties.size() - 1].value = atl::String_View(token_begin, i);
+            }
             tags.push_back(atl::move(tag));
         }
 
@@ -81,6 +91,10 @@ namespace anton_engine::utils {
                 } else {
                     ++i;
                     parse_tag(i, end, tags);
+                    // The last tag was not closed.
+                    if (i == end) {
+                        break;
+                    }
                 }
             }
 
@@ -24,10 +24,20 @@ namespace anton_engine::assets {
             throw Exception(error_msg);
         }
 
-        atl::String out;
-        for(int c = fgetc(file); c != EOF; c = fgetc(file)) {
-            out.append((char8)c);
+        fseek(file, 0, SEEK_END);
+        i64 const file_size = ftell(file);
+        if (file_size < 0) {
+            fclose(file);
+            atl::String error_msg{u8"Could not determine the size of file "};
+            error_msg.append(path);
+            throw Exception(error_msg);
         }
+
+        fseek(file, 0, SEEK_SET);
+        atl::String out{atl::reserve, file_size};
+        // In text mode fread may read fewer bytes than the size of the file due to newline conversions.
+        i64 const bytes_read = fread(out.data(), 1, file_size, file);
+        out.force_size(bytes_read);
         fclose(file);
         return out;
     }
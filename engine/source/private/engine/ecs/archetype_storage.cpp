@@ -0,0 +1,374 @@
+#include <engine/ecs/archetype_storage.hpp>
+
+#include <core/atl/allocator.hpp>
+#include <core/math/math.hpp>
+
+namespace anton_engine {
+    static u8* allocate_chunk(Archetype_Storage::Archetype const& archetype) {
+        return static_cast<u8*>(atl::get_default_allocator()->allocate(archetype.chunk_bytes, archetype.chunk_alignment));
+    }
+
+    static void deallocate_chunk(Archetype_Storage::Archetype const& archetype, u8* const chunk) {
+        atl::get_default_allocator()->deallocate(chunk, archetype.chunk_bytes, archetype.chunk_alignment);
+    }
+
+    static Archetype_Storage::Archetype_Edge& find_edge(Archetype_Storage::Archetype& archetype, i64 const type_index) {
+        for (Archetype_Storage::Archetype_Edge& edge: archetype.edges) {
+            if (edge.type_index == type_index) {
+                return edge;
+            }
+        }
+        return archetype.edges.emplace_back(Archetype_Storage::Archetype_Edge{type_index, -1, -1});
+    }
+
+    static bool same_types(atl::Vector<i64> const& lhs, atl::Vector<i64> const& rhs) {
+        if (lhs.size() != rhs.size()) {
+            return false;
+        }
+
+        for (i64 i = 0; i < lhs.size(); ++i) {
+            if (lhs[i] != rhs[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Lays out the entity array followed by the component arrays so that as many rows as possible fit in chunk_size.
+    static void compute_chunk_layout(Archetype_Storage::Archetype& archetype) {
+        i64 row_bytes = sizeof(Entity);
+        archetype.chunk_alignment = alignof(Entity);
+        for (Component_Type_Info const* const info: archetype.infos) {
+            row_bytes += info->size;
+            archetype.chunk_alignment = math::max(archetype.chunk_alignment, info->alignment);
+        }
+
+        archetype.offsets.resize(archetype.infos.size());
+        for (i64 capacity = math::max(Archetype_Storage::chunk_size / row_bytes, (i64)1);; --capacity) {
+            i64 offset = capacity * static_cast<i64>(sizeof(Entity));
+            for (i64 i = 0; i < archetype.infos.size(); ++i) {
+                i64 const alignment = archetype.infos[i]->alignment;
+                offset = (offset + alignment - 1) / alignment * alignment;
+                archetype.offsets[i] = offset;
+                offset += capacity * archetype.infos[i]->size;
+            }
+
+            if (offset <= Archetype_Storage::chunk_size || capacity == 1) {
+                archetype.capacity = capacity;
+                archetype.chunk_bytes = math::max(offset, Archetype_Storage::chunk_size);
+                return;
+            }
+        }
+    }
+
+    Archetype_Storage::Archetype_Storage() {
+        // The archetype without any components always has index 0.
+        find_or_create_archetype({}, {});
+    }
+
+    Archetype_Storage::Archetype_Storage(Archetype_Storage const& other)
+        : archetypes(other.archetypes), locations(other.locations), component_types(other.component_types) {
+        for (Archetype& archetype: archetypes) {
+            for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                u8* const source = archetype.chunks[chunk];
+                archetype.chunks[chunk] = allocate_chunk(archetype);
+                i64 const rows = chunk_rows(archetype, chunk);
+                Entity const* const source_entities = reinterpret_cast<Entity const*>(source);
+                atl::copy(source_entities, source_entities + rows, chunk_entities(archetype, chunk));
+                for (i64 column = 0; column < archetype.infos.size(); ++column) {
+                    Component_Type_Info const* const info = archetype.infos[column];
+                    for (i64 row = 0; row < rows; ++row) {
+                        i64 const offset = archetype.offsets[column] + row * info->size;
+                        info->copy(archetype.chunks[chunk] + offset, source + offset);
+                    }
+                }
+            }
+        }
+    }
+
+    Archetype_Storage::~Archetype_Storage() {
+        for (Archetype& archetype: archetypes) {
+            for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                i64 const rows = chunk_rows(archetype, chunk);
+                for (i64 column = 0; column < archetype.infos.size(); ++column) {
+                    Component_Type_Info const* const info = archetype.infos[column];
+                    for (i64 row = 0; row < rows; ++row) {
+                        info->destruct(archetype.chunks[chunk] + archetype.offsets[column] + row * info->size);
+                    }
+                }
+                deallocate_chunk(archetype, archetype.chunks[chunk]);
+            }
+        }
+    }
+
+    void Archetype_Storage::create(Entity const entity) {
+        ANTON_ASSERT(!contains(entity), "Entity has already been added to the storage");
+        i64 const index = entity_index(entity);
+        if (index >= locations.size()) {
+            locations.resize(index + 1, Entity_Location{-1, 0});
+        }
+        locations[index] = Entity_Location{0, push_row(0, entity)};
+    }
+
+    Archetype_Storage::Row_Range Archetype_Storage::create_many(Entity const* const entities, i64 const count,
+                                                                Component_Type_Info const* const* const type_infos, void const* const* const prototypes,
+                                                                i64 const type_count) {
+        if (count == 0) {
+            return {-1, 0};
+        }
+
+        // Insertion sort of the types by type index. Entities are rarely created with more than a handful of components.
+        atl::Vector<i64> types(atl::reserve, type_count);
+        atl::Vector<Component_Type_Info const*> infos(atl::reserve, type_count);
+        atl::Vector<void const*> sorted_prototypes(atl::reserve, type_count);
+        for (i64 i = 0; i < type_count; ++i) {
+            types.push_back(type_infos[i]->type_index);
+            infos.push_back(type_infos[i]);
+            sorted_prototypes.push_back(prototypes[i]);
+            for (i64 j = i; j > 0 && types[j] < types[j - 1]; --j) {
+                atl::swap(types[j], types[j - 1]);
+                atl::swap(infos[j], infos[j - 1]);
+                atl::swap(sorted_prototypes[j], sorted_prototypes[j - 1]);
+            }
+        }
+
+        for (i64 i = 1; i < type_count; ++i) {
+            ANTON_ASSERT(types[i] != types[i - 1], "Attempting to add duplicate component");
+        }
+
+        i64 max_index = 0;
+        for (i64 i = 0; i < count; ++i) {
+            ANTON_ASSERT(!contains(entities[i]), "Entity has already been added to the storage");
+            max_index = math::max(max_index, static_cast<i64>(entity_index(entities[i])));
+        }
+
+        if (max_index >= locations.size()) {
+            locations.resize(max_index + 1, Entity_Location{-1, 0});
+        }
+
+        i64 const index = find_or_create_archetype(types, infos);
+        i64 const first_row = push_rows(index, entities, count);
+        Archetype const& archetype = archetypes[index];
+        // Construct the components one column at a time in runs of rows that are contiguous within a chunk.
+        i64 column = 0;
+        i64 constructed_rows = 0;
+        try {
+            for (; column < infos.size(); ++column) {
+                Component_Type_Info const* const info = infos[column];
+                for (constructed_rows = 0; info->size != 0 && constructed_rows < count;) {
+                    i64 const row = first_row + constructed_rows;
+                    i64 const run = math::min(count - constructed_rows, archetype.capacity - row % archetype.capacity);
+                    info->construct_n(component_address(archetype, column, row), run, sorted_prototypes[column]);
+                    constructed_rows += run;
+                }
+            }
+        } catch (...) {
+            for (i64 c = 0; c <= column && c < infos.size(); ++c) {
+                i64 const rows = c < column ? count : constructed_rows;
+                for (i64 row = first_row; row < first_row + rows; ++row) {
+                    infos[c]->destruct(component_address(archetype, c, row));
+                }
+            }
+
+            for (i64 i = 0; i < count; ++i) {
+                pop_row(index);
+            }
+            throw;
+        }
+
+        for (i64 i = 0; i < count; ++i) {
+            locations[entity_index(entities[i])] = Entity_Location{index, first_row + i};
+        }
+        return {index, first_row};
+    }
+
+    void Archetype_Storage::destroy(Entity const entity) {
+        Entity_Location const* const location = find_location(entity);
+        if (!location) {
+            return;
+        }
+
+        Archetype const& archetype = archetypes[location->archetype];
+        for (i64 column = 0; column < archetype.infos.size(); ++column) {
+            archetype.infos[column]->destruct(component_address(archetype, column, location->row));
+        }
+
+        erase_row(location->archetype, location->row);
+        locations[entity_index(entity)].archetype = -1;
+    }
+
+    Component_Container_Base* Archetype_Storage::make_container(Component_Type_Info const* const info) const {
+        Component_Container_Base* const container = info->make_container();
+        for (Archetype const& archetype: archetypes) {
+            i64 const column = find_column(archetype, info->type_index);
+            if (column == -1) {
+                continue;
+            }
+
+            for (i64 row = 0; row < archetype.size; ++row) {
+                Entity const entity = chunk_entities(archetype, row / archetype.capacity)[row % archetype.capacity];
+                info->add_to_container(*container, entity, component_address(archetype, column, row));
+            }
+        }
+        return container;
+    }
+
+    i64 Archetype_Storage::find_or_create_archetype(atl::Vector<i64> const& types, atl::Vector<Component_Type_Info const*> const& infos) {
+        for (i64 i = 0; i < archetypes.size(); ++i) {
+            if (same_types(archetypes[i].types, types)) {
+                return i;
+            }
+        }
+
+        for (Component_Type_Info const* const info: infos) {
+            bool registered = false;
+            for (Component_Type_Info const* const registered_info: component_types) {
+                registered = registered || registered_info->type_index == info->type_index;
+            }
+
+            if (!registered) {
+                component_types.push_back(info);
+            }
+        }
+
+        Archetype& archetype = archetypes.emplace_back();
+        archetype.types = types;
+        archetype.infos = infos;
+        compute_chunk_layout(archetype);
+        return archetypes.size() - 1;
+    }
+
+    i64 Archetype_Storage::add_transition(i64 const archetype, Component_Type_Info const* const info) {
+        if (i64 const target = find_edge(archetypes[archetype], info->type_index).add; target != -1) {
+            return target;
+        }
+
+        atl::Vector<i64> types(atl::reserve, archetypes[archetype].types.size() + 1);
+        atl::Vector<Component_Type_Info const*> infos(atl::reserve, archetypes[archetype].types.size() + 1);
+        bool inserted = false;
+        for (i64 i = 0; i < archetypes[archetype].types.size(); ++i) {
+            if (!inserted && info->type_index < archetypes[archetype].types[i]) {
+                types.push_back(info->type_index);
+                infos.push_back(info);
+                inserted = true;
+            }
+            types.push_back(archetypes[archetype].types[i]);
+            infos.push_back(archetypes[archetype].infos[i]);
+        }
+
+        if (!inserted) {
+            types.push_back(info->type_index);
+            infos.push_back(info);
+        }
+
+        // find_or_create_archetype may reallocate archetypes.
+        i64 const target = find_or_create_archetype(types, infos);
+        find_edge(archetypes[archetype], info->type_index).add = target;
+        find_edge(archetypes[target], info->type_index).remove = archetype;
+        return target;
+    }
+
+    i64 Archetype_Storage::remove_transition(i64 const archetype, i64 const type_index) {
+        if (i64 const target = find_edge(archetypes[archetype], type_index).remove; target != -1) {
+            return target;
+        }
+
+        atl::Vector<i64> types(atl::reserve, archetypes[archetype].types.size());
+        atl::Vector<Component_Type_Info const*> infos(atl::reserve, archetypes[archetype].types.size());
+        for (i64 i = 0; i < archetypes[archetype].types.size(); ++i) {
+            if (archetypes[archetype].types[i] != type_index) {
+                types.push_back(archetypes[archetype].types[i]);
+                infos.push_back(archetypes[archetype].infos[i]);
+            }
+        }
+
+        // find_or_create_archetype may reallocate archetypes.
+        i64 const target = find_or_create_archetype(types, infos);
+        find_edge(archetypes[archetype], type_index).remove = target;
+        find_edge(archetypes[target], type_index).add = archetype;
+        return target;
+    }
+
+    i64 Archetype_Storage::push_row(i64 const index, Entity const entity) {
+#if ANTON_ECS_ITERATION_DEBUG
+        structure_version += 1;
+#endif
+        Archetype& archetype = archetypes[index];
+        if (archetype.size == archetype.chunks.size() * archetype.capacity) {
+            archetype.chunks.push_back(allocate_chunk(archetype));
+        }
+
+        i64 const row = archetype.size;
+        archetype.size += 1;
+        chunk_entities(archetype, row / archetype.capacity)[row % archetype.capacity] = entity;
+        return row;
+    }
+
+    i64 Archetype_Storage::push_rows(i64 const index, Entity const* const entities, i64 const count) {
+#if ANTON_ECS_ITERATION_DEBUG
+        structure_version += 1;
+#endif
+        Archetype& archetype = archetypes[index];
+        i64 const first_row = archetype.size;
+        i64 const chunk_count = (first_row + count + archetype.capacity - 1) / archetype.capacity;
+        archetype.chunks.reserve(chunk_count);
+        while (archetype.chunks.size() < chunk_count) {
+            archetype.chunks.push_back(allocate_chunk(archetype));
+        }
+
+        for (i64 copied = 0; copied < count;) {
+            i64 const row = first_row + copied;
+            i64 const run = math::min(count - copied, archetype.capacity - row % archetype.capacity);
+            memcpy(chunk_entities(archetype, row / archetype.capacity) + row % archetype.capacity, entities + copied, run * sizeof(Entity));
+            copied += run;
+        }
+
+        archetype.size += count;
+        return first_row;
+    }
+
+    void Archetype_Storage::pop_row(i64 const index) {
+        Archetype& archetype = archetypes[index];
+        archetype.size -= 1;
+        if (archetype.size == (archetype.chunks.size() - 1) * archetype.capacity) {
+            deallocate_chunk(archetype, archetype.chunks[archetype.chunks.size() - 1]);
+            archetype.chunks.pop_back();
+        }
+    }
+
+    void Archetype_Storage::erase_row(i64 const index, i64 const row) {
+#if ANTON_ECS_ITERATION_DEBUG
+        structure_version += 1;
+#endif
+        Archetype& archetype = archetypes[index];
+        i64 const last = archetype.size - 1;
+        if (row != last) {
+            for (i64 column = 0; column < archetype.infos.size(); ++column) {
+                archetype.infos[column]->relocate(component_address(archetype, column, row), component_address(archetype, column, last));
+            }
+
+            Entity const moved = chunk_entities(archetype, last / archetype.capacity)[last % archetype.capacity];
+            chunk_entities(archetype, row / archetype.capacity)[row % archetype.capacity] = moved;
+            locations[entity_index(moved)].row = row;
+        }
+
+        pop_row(index);
+    }
+
+    void Archetype_Storage::move_entity(Entity const entity, i64 const target_archetype, i64 const target_row) {
+        Entity_Location& location = locations[entity_index(entity)];
+        Archetype const& source = archetypes[location.archetype];
+        Archetype const& target = archetypes[target_archetype];
+        for (i64 column = 0; column < source.infos.size(); ++column) {
+            void* const component = component_address(source, column, location.row);
+            if (i64 const target_column = find_column(target, source.types[column]); target_column != -1) {
+                source.infos[column]->relocate(component_address(target, target_column, target_row), component);
+            } else {
+                source.infos[column]->destruct(component);
+            }
+        }
+
+        erase_row(location.archetype, location.row);
+        location = Entity_Location{target_archetype, target_row};
+    }
+} // namespace anton_engine
@@ -0,0 +1,171 @@
+#include <engine/ecs/command_buffer.hpp>
+
+#include <core/assert.hpp>
+#include <core/atl/allocator.hpp>
+#include <core/math/math.hpp>
+
+#include <mutex>
+
+namespace anton_engine {
+    // Placeholder entities returned by Command_Buffer::create use this generation
+    // and the index of the placeholder within the buffer. ECS::create never hands out
+    // a generation above max_entity_generation, so a placeholder never aliases a live entity.
+    constexpr u64 placeholder_generation = max_entity_generation + 1;
+    static_assert(placeholder_generation == 0xFFFFFFFF, "placeholder generation must fit in the generation bits of Entity");
+    constexpr i64 arena_block_alignment = 16;
+
+    [[nodiscard]] static bool is_placeholder(Entity const entity) {
+        return entity != null_entity && entity_generation(entity) == placeholder_generation;
+    }
+
+    Command_Buffer::~Command_Buffer() {
+        clear();
+        for (Arena_Block const& block: blocks) {
+            atl::get_default_allocator()->deallocate(block.memory, block.size, arena_block_alignment);
+        }
+    }
+
+    Entity Command_Buffer::create() {
+        Entity const entity = make_entity(created_count, placeholder_generation);
+        created_count += 1;
+        return entity;
+    }
+
+    void Command_Buffer::destroy(Entity const entity) {
+        commands.push_back(Command{Command_Type::destroy, entity, -1, nullptr, nullptr, nullptr});
+    }
+
+    bool Command_Buffer::empty() const {
+        return commands.size() == 0 && created_count == 0;
+    }
+
+    void Command_Buffer::clear() {
+        for (Command const& command: commands) {
+            if (command.payload) {
+                command.destruct(command.payload);
+            }
+        }
+
+        commands.clear();
+        current_block = 0;
+        block_offset = 0;
+        created_count = 0;
+    }
+
+    void* Command_Buffer::allocate(i64 const size, i64 const alignment) {
+        while (true) {
+            if (current_block == blocks.size()) {
+                i64 const block_size = math::max(arena_block_size, size + alignment);
+                u8* const memory = static_cast<u8*>(atl::get_default_allocator()->allocate(block_size, arena_block_alignment));
+                blocks.push_back(Arena_Block{memory, block_size});
+            }
+
+            Arena_Block const& block = blocks[current_block];
+            u64 const address = reinterpret_cast<u64>(block.memory + block_offset);
+            i64 const padding = static_cast<i64>((alignment - address % alignment) % alignment);
+            if (block_offset + padding + size <= block.size) {
+                void* const payload = block.memory + block_offset + padding;
+                block_offset += padding + size;
+                return payload;
+            }
+
+            current_block += 1;
+            block_offset = 0;
+        }
+    }
+
+    struct Thread_Command_Buffers {
+        std::mutex mutex;
+        atl::Vector<Command_Buffer*> buffers;
+
+        ~Thread_Command_Buffers() {
+            for (Command_Buffer* const buffer: buffers) {
+                delete buffer;
+            }
+        }
+    };
+
+    static Thread_Command_Buffers thread_command_buffers;
+
+    Command_Buffer& get_thread_command_buffer() {
+        static thread_local Command_Buffer* buffer = nullptr;
+        if (!buffer) {
+            buffer = new Command_Buffer;
+            std::lock_guard<std::mutex> lock(thread_command_buffers.mutex);
+            thread_command_buffers.buffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+
+    void playback_command_buffers(ECS& ecs, Command_Buffer* const* const buffers, i64 const count) {
+        using Command = Command_Buffer::Command;
+
+        // Create the entities first so that the commands may refer to them.
+        i64 command_count = 0;
+        i64 type_count = 0;
+        atl::Vector<Entity> created;
+        for (i64 i = 0; i < count; ++i) {
+            Command_Buffer& buffer = *buffers[i];
+            created.clear();
+            for (i64 j = 0; j < buffer.created_count; ++j) {
+                created.push_back(ecs.create());
+            }
+
+            for (Command& command: buffer.commands) {
+                if (is_placeholder(command.entity)) {
+                    ANTON_ASSERT(entity_index(command.entity) < buffer.created_count, "Placeholder entity has been created by another command buffer.");
+                    command.entity = created[entity_index(command.entity)];
+                }
+                type_count = math::max(type_count, command.type_index + 1);
+            }
+            command_count += buffer.commands.size();
+        }
+
+        // Stable counting sort by component type. Bucket 0 holds the destroy commands, which are applied last.
+        // The temporaries live only until the end of the playback, hence they come from the frame allocator.
+        atl::Vector<i64, atl::Polymorphic_Allocator> offsets(atl::reserve, type_count + 2, &atl::get_frame_allocator());
+        offsets.resize(type_count + 2, 0);
+        for (i64 i = 0; i < count; ++i) {
+            for (Command const& command: buffers[i]->commands) {
+                offsets[command.type_index + 2] += 1;
+            }
+        }
+
+        for (i64 i = 1; i < offsets.size(); ++i) {
+            offsets[i] += offsets[i - 1];
+        }
+
+        atl::Vector<Command*, atl::Polymorphic_Allocator> sorted(atl::reserve, command_count, &atl::get_frame_allocator());
+        sorted.resize(command_count, nullptr);
+        for (i64 i = 0; i < count; ++i) {
+            for (Command& command: buffers[i]->commands) {
+                sorted[offsets[command.type_index + 1]] = &command;
+                offsets[command.type_index + 1] += 1;
+            }
+        }
+
+        i64 const destroy_count = offsets[0];
+        for (i64 first = destroy_count; first < command_count;) {
+            i64 last = first + 1;
+            while (last < command_count && sorted[last]->type_index == sorted[first]->type_index) {
+                last += 1;
+            }
+
+            sorted[first]->apply(ecs, sorted.data() + first, sorted.data() + last);
+            first = last;
+        }
+
+        for (i64 i = 0; i < destroy_count; ++i) {
+            ecs.destroy(sorted[i]->entity);
+        }
+
+        for (i64 i = 0; i < count; ++i) {
+            buffers[i]->clear();
+        }
+    }
+
+    void playback_thread_command_buffers(ECS& ecs) {
+        std::lock_guard<std::mutex> lock(thread_command_buffers.mutex);
+        playback_command_buffers(ecs, thread_command_buffers.buffers.data(), thread_command_buffers.buffers.size());
+    }
+} // namespace anton_engine
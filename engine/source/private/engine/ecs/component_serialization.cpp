@@ -1,5 +1,63 @@
 #include <engine/ecs/component_serialization.hpp>
 
+#include <core/atl/fixed_array.hpp>
+#include <engine/components/hierarchy.hpp>
+#include <engine/ecs/component_container.hpp>
+#include <engine/ecs/entity.hpp>
+
 namespace anton_engine {
     get_component_serialization_funcs_t get_component_serialization_funcs = nullptr;
-}
+
+    // Layout of Hierarchy in archives of version 0, which stored up to 16 children of an entity in the component.
+    struct Hierarchy_V0 {
+        Entity parent;
+        atl::Fixed_Array<Entity, 16> children;
+    };
+
+    static void deserialize_hierarchy_v0(serialization::Binary_Input_Archive& archive, Component_Container_Base*& container) {
+        // The components have been written with the default serialization followed by the entities.
+        i64 capacity;
+        i64 size;
+        archive.read(capacity);
+        archive.read(size);
+        atl::Vector<Hierarchy_V0> legacy(size);
+        for (Hierarchy_V0& hierarchy: legacy) {
+            archive.read(hierarchy);
+        }
+
+        atl::Vector<Entity> entities;
+        deserialize(archive, entities);
+        Component_Container<Hierarchy>* const hierarchies = new Component_Container<Hierarchy>();
+        for (i64 i = 0; i < entities.size(); ++i) {
+            Hierarchy hierarchy;
+            hierarchy.parent = legacy[i].parent;
+            hierarchies->add(entities[i], hierarchy);
+        }
+
+        // Thread the children of every entity into a list in their original order.
+        for (i64 i = 0; i < entities.size(); ++i) {
+            Entity previous = null_entity;
+            for (Entity const child: legacy[i].children) {
+                if (!hierarchies->has(child)) {
+                    continue;
+                }
+
+                if (previous != null_entity) {
+                    hierarchies->get(previous).next_sibling = child;
+                } else {
+                    hierarchies->get(entities[i]).first_child = child;
+                }
+                hierarchies->get(child).previous_sibling = previous;
+                previous = child;
+            }
+        }
+        container = hierarchies;
+    }
+
+    atl::Slice<Component_Migration const> get_component_migrations() {
+        static Component_Migration const migrations[] = {
+            {type_identifier<Hierarchy>(), 1, deserialize_hierarchy_v0},
+        };
+        return {migrations, 1};
+    }
+} // namespace anton_engine
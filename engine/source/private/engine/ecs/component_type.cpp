@@ -0,0 +1,22 @@
+#include <engine/ecs/component_type.hpp>
+
+#include <core/atl/vector.hpp>
+
+#include <mutex>
+
+namespace anton_engine {
+    static std::mutex registry_mutex;
+    static atl::Vector<u64> registered_families;
+
+    i64 register_component_type(u64 const family) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (i64 i = 0; i < registered_families.size(); ++i) {
+            if (registered_families[i] == family) {
+                return i;
+            }
+        }
+
+        registered_families.push_back(family);
+        return registered_families.size() - 1;
+    }
+} // namespace anton_engine
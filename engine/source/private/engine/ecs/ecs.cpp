@@ -14,16 +14,285 @@
 #endif // ANTON_WITH_EDITOR
 
 namespace anton_engine {
+    ECS::ECS(Storage_Mode const mode) {
+        if (mode == Storage_Mode::archetype) {
+            archetypes = new Archetype_Storage();
+        }
+    }
+
     ECS::~ECS() {
+        delete archetypes;
+        archetypes = nullptr;
+        for (Group_Data* const group: groups) {
+            delete group;
+        }
+        for (Query_Data* const query: queries) {
+            delete query;
+        }
         for (auto& container_data: containers) {
-            atl::destruct(container_data.container);
+            if (container_data.owns_container) {
+                delete container_data.container;
+            }
+            delete container_data.snapshot_cache;
             container_data.container = nullptr;
+            container_data.snapshot_cache = nullptr;
         }
     }
 
     Entity ECS::create() {
-        // TODO: More clever entity creation (generations and reusing ids)
-        return _entities.emplace_back(id_generator.next());
+        Entity entity;
+        if (free_entities.size() > 0) {
+            Entity const recycled = free_entities[free_entities.size() - 1];
+            free_entities.pop_back();
+            ANTON_ASSERT(entity_generation(recycled) < max_entity_generation, "Recycling an entity index whose generations are exhausted");
+            entity = make_entity(entity_index(recycled), entity_generation(recycled) + 1);
+        } else {
+            entity = make_entity(id_generator.next(), 0);
+        }
+
+        _entities.push_back(entity);
+        if (archetypes) {
+            archetypes->create(entity);
+        } else {
+            claim_signature(entity);
+        }
+        return entity;
+    }
+
+    u64 const* ECS::find_signature(Entity const entity) const {
+        i64 const index = entity_index(entity);
+        if (index >= signature_owners.size() || signature_owners[index] != entity) {
+            return nullptr;
+        }
+        return signatures.data() + index * signature_stride;
+    }
+
+    void ECS::claim_signature(Entity const entity) {
+        i64 const index = entity_index(entity);
+        if (index >= signature_owners.size()) {
+            signature_owners.resize(index + 1, null_entity);
+            signatures.resize((index + 1) * signature_stride, 0);
+        }
+
+        ANTON_ASSERT(signature_owners[index] == null_entity || signature_owners[index] == entity, "Entity index is used by another entity");
+        signature_owners[index] = entity;
+    }
+
+    void ECS::release_signature(Entity const entity) {
+        i64 const index = entity_index(entity);
+        if (index >= signature_owners.size() || signature_owners[index] != entity) {
+            return;
+        }
+
+        for (Query_Data* const query: queries) {
+            if (index < query->positions.size() && query->positions[index] != -1) {
+                i64 const position = query->positions[index];
+                Entity const moved = query->entities[query->entities.size() - 1];
+                query->entities.erase_unsorted(position);
+                query->positions[entity_index(moved)] = position;
+                query->positions[index] = -1;
+            }
+        }
+
+        for (i64 i = 0; i < signature_stride; ++i) {
+            signatures[index * signature_stride + i] = 0;
+        }
+        signature_owners[index] = null_entity;
+    }
+
+    void ECS::set_signature_bit(Entity const entity, i64 const type_index) {
+        if (type_index >= signature_stride * 64) {
+            // Widen every signature to make room for the new component type.
+            i64 const stride = type_index / 64 + 1;
+            atl::Vector<u64> widened(signature_owners.size() * stride, 0);
+            for (i64 index = 0; index < signature_owners.size(); ++index) {
+                for (i64 i = 0; i < signature_stride; ++i) {
+                    widened[index * stride + i] = signatures[index * signature_stride + i];
+                }
+            }
+            signatures = atl::move(widened);
+            signature_stride = stride;
+        }
+
+        claim_signature(entity);
+        i64 const index = entity_index(entity);
+        signatures[index * signature_stride + type_index / 64] |= u64(1) << (type_index % 64);
+        for (Query_Data* const query: queries) {
+            bool const tests_type = type_index / 64 < query->mask.size() && ((query->mask[type_index / 64] >> (type_index % 64)) & 1);
+            if (!tests_type || !matches_query(*query, entity)) {
+                continue;
+            }
+
+            if (index >= query->positions.size()) {
+                query->positions.resize(index + 1, -1);
+            }
+
+            if (query->positions[index] == -1) {
+                query->positions[index] = query->entities.size();
+                query->entities.push_back(entity);
+            }
+        }
+    }
+
+    void ECS::clear_signature_bit(Entity const entity, i64 const type_index) {
+        i64 const index = entity_index(entity);
+        if (index >= signature_owners.size() || signature_owners[index] != entity || type_index >= signature_stride * 64) {
+            return;
+        }
+
+        for (Query_Data* const query: queries) {
+            bool const tests_type = type_index / 64 < query->mask.size() && ((query->mask[type_index / 64] >> (type_index % 64)) & 1);
+            if (tests_type && index < query->positions.size() && query->positions[index] != -1) {
+                i64 const position = query->positions[index];
+                Entity const moved = query->entities[query->entities.size() - 1];
+                query->entities.erase_unsorted(position);
+                query->positions[entity_index(moved)] = position;
+                query->positions[index] = -1;
+            }
+        }
+
+        signatures[index * signature_stride + type_index / 64] &= ~(u64(1) << (type_index % 64));
+    }
+
+    void ECS::rebuild_signatures() {
+        signatures.clear();
+        signature_owners.clear();
+        signature_stride = 1;
+        for (Entity const entity: _entities) {
+            claim_signature(entity);
+        }
+
+        for (Components_Container_Data const& data: containers) {
+            Entity const* const entities = data.container->entities();
+            for (i64 i = 0; i < data.container->size(); ++i) {
+                set_signature_bit(entities[i], data.type_index);
+            }
+        }
+    }
+
+    bool ECS::matches_query(Query_Data const& query, Entity const entity) const {
+        u64 const* const signature = find_signature(entity);
+        if (!signature || query.mask.size() > signature_stride) {
+            return false;
+        }
+
+        for (i64 i = 0; i < query.mask.size(); ++i) {
+            if ((signature[i] & query.mask[i]) != query.mask[i]) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    ECS::Query_Data* ECS::find_or_create_query(i64 const* const types, i64 const count) {
+        i64 max_type = 0;
+        for (i64 i = 0; i < count; ++i) {
+            max_type = math::max(max_type, types[i]);
+        }
+
+        atl::Vector<u64> mask(max_type / 64 + 1, 0);
+        for (i64 i = 0; i < count; ++i) {
+            mask[types[i] / 64] |= u64(1) << (types[i] % 64);
+        }
+
+        for (Query_Data* const query: queries) {
+            bool same = query->mask.size() == mask.size();
+            for (i64 i = 0; same && i < mask.size(); ++i) {
+                same = query->mask[i] == mask[i];
+            }
+
+            if (same) {
+                return query;
+            }
+        }
+
+        Query_Data* const query = queries.emplace_back(new Query_Data);
+        query->mask = atl::move(mask);
+        // Every matching entity has all of the components, therefore scanning the smallest container finds all of them.
+        Component_Container_Base const* smallest = nullptr;
+        for (i64 i = 0; i < count; ++i) {
+            Component_Container_Base const* const container = containers[container_table[types[i]]].container;
+            if (!smallest || container->size() < smallest->size()) {
+                smallest = container;
+            }
+        }
+
+        for (i64 i = 0; i < smallest->size(); ++i) {
+            Entity const entity = smallest->entities()[i];
+            if (matches_query(*query, entity)) {
+                i64 const index = entity_index(entity);
+                if (index >= query->positions.size()) {
+                    query->positions.resize(index + 1, -1);
+                }
+                query->positions[index] = query->entities.size();
+                query->entities.push_back(entity);
+            }
+        }
+        return query;
+    }
+
+    ECS::Observer_Handle ECS::add_observer(i64 const type_index, Observer_Event const event, Observer_Callback const callback, void* const user_data) {
+        ANTON_ASSERT(callback != nullptr, "Observer callback must not be nullptr");
+        u64 const id = next_observer_id;
+        next_observer_id += 1;
+        observers.push_back(Observer{id, type_index, event, callback, user_data});
+        if (type_index >= observed_events.size()) {
+            observed_events.resize(type_index + 1, 0);
+        }
+        observed_events[type_index] |= 1 << static_cast<u8>(event);
+        return Observer_Handle{id};
+    }
+
+    void ECS::remove_observer(Observer_Handle const handle) {
+        for (i64 i = 0; i < observers.size(); ++i) {
+            if (observers[i].id != handle.value) {
+                continue;
+            }
+
+            Observer const removed = observers[i];
+            observers.erase(observers.begin() + i, observers.begin() + i + 1);
+            bool still_observed = false;
+            for (Observer const& observer: observers) {
+                still_observed = still_observed || (observer.type_index == removed.type_index && observer.event == removed.event);
+            }
+
+            if (!still_observed) {
+                observed_events[removed.type_index] &= ~(1 << static_cast<u8>(removed.event));
+            }
+            return;
+        }
+    }
+
+    void ECS::notify(i64 const type_index, Observer_Event const event, Entity const entity) {
+        // Observers may register or remove other observers, therefore copy each one before calling it.
+        for (i64 i = 0; i < observers.size(); ++i) {
+            Observer const observer = observers[i];
+            if (observer.type_index == type_index && observer.event == event) {
+                observer.callback(*this, entity, observer.user_data);
+            }
+        }
+    }
+
+    void ECS::notify_destroyed(atl::Slice<Entity const> const entities) {
+        for (i64 type_index = 0; type_index < observed_events.size(); ++type_index) {
+            if (!is_observed(type_index, Observer_Event::destroy)) {
+                continue;
+            }
+
+            for (Entity const entity: entities) {
+                bool has;
+                if (archetypes) {
+                    has = archetypes->has(entity, type_index);
+                } else {
+                    i64 const container = type_index < container_table.size() ? container_table[type_index] : -1;
+                    has = container != -1 && containers[container].container->has(entity);
+                }
+
+                if (has) {
+                    notify(type_index, Observer_Event::destroy, entity);
+                }
+            }
+        }
     }
 
     static void serialize_component_container(u64 identifier, serialization::Binary_Output_Archive& archive, Component_Container_Base const* container) {
@@ -35,7 +304,15 @@ namespace anton_engine {
         iter->serialize(archive, container);
     }
 
-    static void deserialize_component_container(u64 identifier, serialization::Binary_Input_Archive& archive, Component_Container_Base*& container) {
+    static void deserialize_component_container(u64 identifier, serialization::Binary_Input_Archive& archive, Component_Container_Base*& container,
+                                                i64 const version) {
+        for (Component_Migration const& migration: get_component_migrations()) {
+            if (migration.identifier == identifier && version < migration.version) {
+                migration.deserialize(archive, container);
+                return;
+            }
+        }
+
         ANTON_ASSERT(get_component_serialization_funcs != nullptr, "Function get_component_serialization_funcs has not been loaded");
         auto& serialization_funcs = get_component_serialization_funcs();
         auto iter = atl::find_if(serialization_funcs.begin(), serialization_funcs.end(),
@@ -44,8 +321,27 @@ namespace anton_engine {
         iter->deserialize(archive, container);
     }
 
+    // Precedes the version in the archives. Archives without a version start with the capacity of the entities,
+    // which is never negative.
+    constexpr i64 versioned_archive_tag = -1;
+
     void serialize(serialization::Binary_Output_Archive& archive, ECS const& ecs) {
+        archive.write(versioned_archive_tag);
+        archive.write(ecs_archive_version);
         serialize(archive, ecs._entities);
+        if (ecs.archetypes) {
+            // Write the same format as the sparse set storage by converting the components to containers.
+            atl::Vector<Component_Type_Info const*> const& types = ecs.archetypes->get_component_types();
+            archive.write(types.size());
+            for (Component_Type_Info const* const info: types) {
+                Component_Container_Base* const container = ecs.archetypes->make_container(info);
+                archive.write(info->family);
+                serialize_component_container(info->family, archive, container);
+                delete container;
+            }
+            return;
+        }
+
         archive.write(ecs.containers.size());
         for (auto const& data: ecs.containers) {
             archive.write(data.family);
@@ -54,16 +350,58 @@ namespace anton_engine {
     }
 
     void deserialize(serialization::Binary_Input_Archive& archive, ECS& ecs) {
-        deserialize(archive, ecs._entities);
+        ANTON_VERIFY(!ecs.archetypes, "Deserialization is not available with Storage_Mode::archetype.");
+        i64 version = 0;
+        i64 tag;
+        archive.read(tag);
+        if (tag == versioned_archive_tag) {
+            archive.read(version);
+            ANTON_VERIFY(version <= ecs_archive_version, "The archive has been written by a newer version of the engine.");
+            deserialize(archive, ecs._entities);
+        } else {
+            // The tag is the capacity of the entities.
+            i64 size;
+            archive.read(size);
+            ecs._entities.clear();
+            ecs._entities.resize(size);
+            for (Entity& entity: ecs._entities) {
+                deserialize(archive, entity);
+            }
+        }
+
         i64 containers_count;
         archive.read(containers_count);
+        // Groups refer to the containers that are about to be replaced.
+        for (ECS::Group_Data* const group: ecs.groups) {
+            delete group;
+        }
+        ecs.groups.clear();
+        for (ECS::Query_Data* const query: ecs.queries) {
+            delete query;
+        }
+        ecs.queries.clear();
         ecs.containers.resize(containers_count);
-        for (auto& data: ecs.containers) {
+        ecs.container_table.clear();
+        for (i64 i = 0; i < ecs.containers.size(); ++i) {
+            auto& data = ecs.containers[i];
             archive.read(data.family);
-            deserialize_component_container(data.family, archive, data.container);
+            data.type_index = register_component_type(data.family);
+            data.group = -1;
+            ecs.set_container_index(data.type_index, i);
+            deserialize_component_container(data.family, archive, data.container, version);
         }
+        ecs.rebuild_signatures();
     }
 
+#if ANTON_ECS_ITERATION_DEBUG
+    namespace detail {
+        i64& parallel_each_depth() {
+            static thread_local i64 depth = 0;
+            return depth;
+        }
+    } // namespace detail
+#endif
+
     ECS& get_ecs() {
 #if ANTON_WITH_EDITOR
         return Editor::get_ecs();
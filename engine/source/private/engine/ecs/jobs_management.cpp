@@ -1,22 +1,408 @@
 #include <engine/ecs/jobs.hpp>
 #include <engine/ecs/jobs_management.hpp>
 
+#include <core/assert.hpp>
 #include <core/atl/vector.hpp>
 
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace anton_engine {
-    static atl::Vector<Job*> jobs;
+    // Number of job slots owned by every thread. Slots are reused in a round-robin fashion.
+    constexpr i64 job_pool_size = 4096;
+    constexpr i64 max_continuations = 8;
+
+    struct alignas(64) Job_Data {
+        Job* job = nullptr;
+        Job_Data* parent = nullptr;
+        // The job itself and its unfinished children.
+        std::atomic<i64> unfinished = 0;
+        std::atomic<u32> generation = 0;
+        // false while the job or its continuations may still be referenced by the scheduler.
+        std::atomic<bool> reusable = true;
+        // Guards completed and continuations.
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        bool completed = false;
+        i64 continuation_count = 0;
+        Job_Data* continuations[max_continuations];
+        // Index of the slot across all pools.
+        u32 slot = 0;
+    };
+
+    // Chase-Lev work-stealing deque.
+    // The owning thread pushes and pops at the bottom, other threads steal from the top.
+    class Job_Deque {
+    public:
+        constexpr static i64 capacity = job_pool_size;
+
+        // Returns: false if the deque is full.
+        bool push(Job_Data* const job) {
+            i64 const b = bottom.load(std::memory_order_relaxed);
+            i64 const t = top.load(std::memory_order_acquire);
+            if (b - t >= capacity) {
+                return false;
+            }
+
+            buffer[b & (capacity - 1)].store(job, std::memory_order_release);
+            bottom.store(b + 1, std::memory_order_release);
+            return true;
+        }
+
+        Job_Data* pop() {
+            i64 const b = bottom.load(std::memory_order_relaxed) - 1;
+            bottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            i64 t = top.load(std::memory_order_relaxed);
+            if (t > b) {
+                bottom.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            Job_Data* job = buffer[b & (capacity - 1)].load(std::memory_order_relaxed);
+            if (t == b) {
+                // Last job. Race against the thieves.
+                if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                    job = nullptr;
+                }
+                bottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        Job_Data* steal() {
+            i64 t = top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            i64 const b = bottom.load(std::memory_order_acquire);
+            if (t >= b) {
+                return nullptr;
+            }
+
+            Job_Data* const job = buffer[t & (capacity - 1)].load(std::memory_order_acquire);
+            if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                return nullptr;
+            }
+            return job;
+        }
+
+    private:
+        alignas(64) std::atomic<i64> top = 0;
+        alignas(64) std::atomic<i64> bottom = 0;
+        std::atomic<Job_Data*> buffer[capacity];
+    };
+
+    struct Job_Thread {
+        Job_Deque deque;
+        Job_Data* pool = nullptr;
+        i64 next_slot = 0;
+    };
+
+    static Job_Thread* job_threads = nullptr;
+    static i64 job_thread_count = 0;
+    static atl::Vector<std::thread> workers;
+    static std::atomic<bool> workers_running = false;
+    // Jobs that have been scheduled, but have not completed yet.
+    static std::atomic<i64> outstanding_jobs = 0;
+    // Jobs sitting in the deques.
+    static std::atomic<i64> queued_jobs = 0;
+    static std::atomic<i64> sleeping_workers = 0;
+    static std::mutex sleep_mutex;
+    static std::condition_variable wake_condition;
+
+    // Index of the calling thread in job_threads. 0 is the main thread. -1 for threads unknown to the job system.
+    static thread_local i64 thread_index = -1;
+    static thread_local u64 steal_seed = 0;
+    static thread_local Job_Data* current_job = nullptr;
+
+    static void lock_job(Job_Data& job) {
+        while (job.lock.test_and_set(std::memory_order_acquire)) {
+            std::this_thread::yield();
+        }
+    }
+
+    static void unlock_job(Job_Data& job) {
+        job.lock.clear(std::memory_order_release);
+    }
+
+    static Job_Data* find_job_data(Job_Handle const handle) {
+        ANTON_ASSERT(handle.slot < job_thread_count * job_pool_size, "Invalid job handle");
+        Job_Data* const base = job_threads[handle.slot / job_pool_size].pool;
+        return base + handle.slot % job_pool_size;
+    }
+
+    static Job_Handle make_handle(Job_Data* const data) {
+        return Job_Handle{data->slot, data->generation.load(std::memory_order_relaxed)};
+    }
+
+    static Job_Data* find_job() {
+        Job_Thread& self = job_threads[thread_index];
+        if (Job_Data* const job = self.deque.pop()) {
+            queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+
+        // xorshift to pick the first victim so that thieves do not all pile onto the same deque.
+        steal_seed ^= steal_seed << 13;
+        steal_seed ^= steal_seed >> 7;
+        steal_seed ^= steal_seed << 17;
+        i64 const first = static_cast<i64>(steal_seed % static_cast<u64>(job_thread_count));
+        for (i64 i = 0; i < job_thread_count; ++i) {
+            i64 const victim = (first + i) % job_thread_count;
+            if (victim == thread_index) {
+                continue;
+            }
+
+            if (Job_Data* const job = job_threads[victim].deque.steal()) {
+                queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static void execute_job(Job_Data* job);
+
+    static void push_job(Job_Data* const job) {
+        if (!job_threads[thread_index].deque.push(job)) {
+            // The deque is full. Run the job right away instead of queueing it.
+            execute_job(job);
+            return;
+        }
+
+        queued_jobs.fetch_add(1, std::memory_order_seq_cst);
+        if (sleeping_workers.load(std::memory_order_seq_cst) > 0) {
+            // Synchronize with the workers going to sleep so that the notification cannot be lost.
+            { std::lock_guard<std::mutex> lock(sleep_mutex); }
+            wake_condition.notify_one();
+        }
+    }
+
+    // Executes a queued job or yields if there is none.
+    static void help_or_yield() {
+        if (Job_Data* const job = find_job()) {
+            execute_job(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+
+    static void finish_job(Job_Data* const job) {
+        if (job->unfinished.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+
+        Job_Data* const parent = job->parent;
+        Job_Data* continuations[max_continuations];
+        lock_job(*job);
+        job->completed = true;
+        i64 const continuation_count = job->continuation_count;
+        for (i64 i = 0; i < continuation_count; ++i) {
+            continuations[i] = job->continuations[i];
+        }
+        unlock_job(*job);
+        // The slot may be reused from now on.
+        job->reusable.store(true, std::memory_order_release);
+
+        for (i64 i = 0; i < continuation_count; ++i) {
+            push_job(continuations[i]);
+        }
+
+        outstanding_jobs.fetch_sub(1, std::memory_order_release);
+        if (parent) {
+            finish_job(parent);
+        }
+    }
+
+    static void execute_job(Job_Data* const job) {
+        // Jobs executed while waiting nest on the same thread.
+        Job_Data* const previous_job = current_job;
+        current_job = job;
+        job->job->execute();
+        current_job = previous_job;
+        finish_job(job);
+    }
+
+    static Job_Data* allocate_job(Job* const job, Job_Data* const parent) {
+        ANTON_VERIFY(thread_index != -1, "Jobs may only be scheduled from the main thread or from within jobs.");
+        Job_Thread& self = job_threads[thread_index];
+        Job_Data* data = nullptr;
+        while (!data) {
+            // Skip the slots that are still in flight. They might belong to a running ancestor that
+            // will not complete until the job being allocated has completed.
+            for (i64 i = 0; i < job_pool_size; ++i) {
+                Job_Data* const candidate = self.pool + self.next_slot;
+                self.next_slot = (self.next_slot + 1) % job_pool_size;
+                if (candidate->reusable.load(std::memory_order_acquire)) {
+                    data = candidate;
+                    break;
+                }
+            }
+
+            if (!data) {
+                // All job_pool_size jobs of this thread are in flight. Drain the local queue to free the slots up.
+                bool executed = false;
+                while (Job_Data* const job = self.deque.pop()) {
+                    queued_jobs.fetch_sub(1, std::memory_order_relaxed);
+                    execute_job(job);
+                    executed = true;
+                }
+
+                if (!executed) {
+                    help_or_yield();
+                }
+            }
+        }
+
+        lock_job(*data);
+        // Bump the generation first so that stale handles keep reporting the previous job as completed.
+        data->generation.fetch_add(1, std::memory_order_relaxed);
+        data->reusable.store(false, std::memory_order_relaxed);
+        data->completed = false;
+        data->continuation_count = 0;
+        data->job = job;
+        data->parent = parent;
+        data->unfinished.store(1, std::memory_order_relaxed);
+        unlock_job(*data);
+        outstanding_jobs.fetch_add(1, std::memory_order_relaxed);
+        return data;
+    }
+
+    static void worker_main(i64 const index) {
+        thread_index = index;
+        steal_seed = 0x9E3779B97F4A7C15ULL * static_cast<u64>(index + 1);
+        while (workers_running.load(std::memory_order_acquire)) {
+            if (Job_Data* const job = find_job()) {
+                execute_job(job);
+                continue;
+            }
+
+            // Spin for a short while before going to sleep. Jobs tend to arrive in bursts.
+            for (i64 i = 0; i < 64 && queued_jobs.load(std::memory_order_relaxed) == 0; ++i) {
+                std::this_thread::yield();
+            }
+
+            if (queued_jobs.load(std::memory_order_relaxed) > 0) {
+                continue;
+            }
+
+            sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+            {
+                std::unique_lock<std::mutex> lock(sleep_mutex);
+                wake_condition.wait(lock, [] {
+                    return queued_jobs.load(std::memory_order_seq_cst) > 0 || !workers_running.load(std::memory_order_seq_cst);
+                });
+            }
+            sleeping_workers.fetch_sub(1, std::memory_order_seq_cst);
+        }
+    }
+
+    void init_jobs(i64 thread_count) {
+        ANTON_VERIFY(job_threads == nullptr, "Jobs have already been initialized.");
+        if (thread_count <= 0) {
+            thread_count = static_cast<i64>(std::thread::hardware_concurrency());
+            thread_count = thread_count > 0 ? thread_count : 1;
+        }
+
+        job_thread_count = thread_count;
+        job_threads = new Job_Thread[thread_count];
+        for (i64 i = 0; i < thread_count; ++i) {
+            job_threads[i].pool = new Job_Data[job_pool_size];
+            for (i64 j = 0; j < job_pool_size; ++j) {
+                job_threads[i].pool[j].slot = static_cast<u32>(i * job_pool_size + j);
+            }
+        }
+
+        thread_index = 0;
+        steal_seed = 0x9E3779B97F4A7C15ULL;
+        workers_running.store(true, std::memory_order_release);
+        workers.reserve(thread_count - 1);
+        for (i64 i = 1; i < thread_count; ++i) {
+            workers.emplace_back(worker_main, i);
+        }
+    }
+
+    void terminate_jobs() {
+        if (job_threads == nullptr) {
+            return;
+        }
+
+        execute_jobs();
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            workers_running.store(false, std::memory_order_seq_cst);
+        }
+        wake_condition.notify_all();
+        for (std::thread& worker: workers) {
+            worker.join();
+        }
+        workers.clear();
 
-    i64 schedule_job(Job* job) {
-        jobs.push_back(job);
-		// TODO: Generate id
-        return 0;
+        for (i64 i = 0; i < job_thread_count; ++i) {
+            delete[] job_threads[i].pool;
+        }
+        delete[] job_threads;
+        job_threads = nullptr;
+        job_thread_count = 0;
+        thread_index = -1;
     }
 
     void execute_jobs() {
-        for (Job* job: jobs) {
-            job->execute();
+        while (outstanding_jobs.load(std::memory_order_acquire) > 0) {
+            help_or_yield();
+        }
+    }
+
+    Job_Handle schedule_job(Job* const job, Job_Handle const parent) {
+        Job_Data* parent_data = nullptr;
+        if (parent != null_job_handle) {
+            parent_data = find_job_data(parent);
+            ANTON_ASSERT(parent_data->generation.load(std::memory_order_relaxed) == parent.generation &&
+                             parent_data->unfinished.load(std::memory_order_relaxed) > 0,
+                         "Parent job has already completed.");
+            parent_data->unfinished.fetch_add(1, std::memory_order_relaxed);
         }
 
-        jobs.clear();
+        Job_Data* const data = allocate_job(job, parent_data);
+        Job_Handle const handle = make_handle(data);
+        push_job(data);
+        return handle;
+    }
+
+    Job_Handle add_continuation(Job_Handle const predecessor, Job* const continuation) {
+        Job_Data* const data = allocate_job(continuation, nullptr);
+        Job_Handle const handle = make_handle(data);
+        Job_Data& predecessor_data = *find_job_data(predecessor);
+        lock_job(predecessor_data);
+        if (predecessor_data.generation.load(std::memory_order_relaxed) != predecessor.generation || predecessor_data.completed) {
+            unlock_job(predecessor_data);
+            push_job(data);
+        } else {
+            ANTON_VERIFY(predecessor_data.continuation_count < max_continuations, "Too many continuations added to a single job.");
+            predecessor_data.continuations[predecessor_data.continuation_count] = data;
+            predecessor_data.continuation_count += 1;
+            unlock_job(predecessor_data);
+        }
+        return handle;
+    }
+
+    bool is_job_completed(Job_Handle const handle) {
+        Job_Data const& data = *find_job_data(handle);
+        return data.generation.load(std::memory_order_acquire) != handle.generation || data.unfinished.load(std::memory_order_acquire) == 0;
+    }
+
+    void wait_for_job(Job_Handle const handle) {
+        while (!is_job_completed(handle)) {
+            help_or_yield();
+        }
+    }
+
+    Job_Handle get_current_job() {
+        return current_job ? make_handle(current_job) : null_job_handle;
+    }
+
+    i64 get_job_thread_count() {
+        return job_thread_count;
     }
 } // namespace anton_engine
@@ -1,8 +1,17 @@
 #ifndef ENGINE_ECS_JOB_MANAGEMENT_HPP_INCLUDE
 #define ENGINE_ECS_JOB_MANAGEMENT_HPP_INCLUDE
 
+#include <core/types.hpp>
+
 namespace anton_engine {
+    // Starts the worker threads. The calling thread becomes the main thread of the job system.
+    // thread_count: Number of threads executing jobs including the main thread.
+    //               0 to use one thread per hardware thread.
+    void init_jobs(i64 thread_count = 0);
+    // Waits for all jobs to complete and stops the worker threads.
+    void terminate_jobs();
+    // Executes jobs on the main thread until all jobs scheduled so far have completed.
     void execute_jobs();
-}
+} // namespace anton_engine
 
 #endif // !ENGINE_ECS_JOB_MANAGEMENT_HPP_INCLUDE
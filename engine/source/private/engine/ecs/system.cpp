@@ -1,14 +1,127 @@
 #include <engine/ecs/system.hpp>
 #include <engine/ecs/system_management.hpp>
 
+#include <build_config.hpp>
+#include <core/atl/string.hpp>
 #include <core/logging.hpp>
+#include <engine/ecs/ecs.hpp>
+#include <engine/ecs/jobs.hpp>
+
+#include <atomic>
 
 namespace anton_engine {
+    class System_Job: public Job {
+    public:
+        void execute() override;
+
+        System* system = nullptr;
+        // Indices of the systems that may start only after this one has completed.
+        atl::Vector<i64> successors;
+        i64 predecessor_count = 0;
+        std::atomic<i64> pending_predecessors = 0;
+    };
+
+    // Starts the systems that do not depend on any other system.
+    class System_Frame_Job: public Job {
+    public:
+        void execute() override;
+    };
+
     static atl::Vector<System*> systems;
+    // System_Job is neither copyable nor movable.
+    static System_Job* system_jobs = nullptr;
+    static System_Frame_Job system_frame_job;
 
     // From game dll
     create_systems_type create_systems = nullptr;
 
+#if ANTON_ECS_ACCESS_DEBUG
+    // System being updated on the calling thread and the job that updates it. Jobs the system waits for may run
+    // on the same thread while it is being updated, therefore accesses are checked only from within that job.
+    static thread_local System const* updated_system = nullptr;
+    static thread_local Job_Handle updated_system_job = null_job_handle;
+
+    namespace detail {
+        void verify_component_access(i64 const type_index, bool const write) {
+            if (!updated_system || get_current_job() != updated_system_job) {
+                return;
+            }
+
+            for (System::Component_Access const& access: updated_system->get_component_access()) {
+                if (access.type_index == type_index) {
+                    ANTON_VERIFY(access.write || !write, "System modifies a component it has declared with reads.");
+                    return;
+                }
+            }
+            ANTON_FAIL(false, "System accesses a component it has not declared.");
+        }
+    } // namespace detail
+#endif
+
+    static void update_system(System* const system) {
+#if ANTON_ECS_ACCESS_DEBUG
+        System const* const previous_system = updated_system;
+        Job_Handle const previous_job = updated_system_job;
+        updated_system = system->declares_access() ? system : nullptr;
+        updated_system_job = get_current_job();
+#endif
+        system->update();
+#if ANTON_ECS_ACCESS_DEBUG
+        updated_system = previous_system;
+        updated_system_job = previous_job;
+#endif
+    }
+
+    void System_Job::execute() {
+        update_system(system);
+        for (i64 const successor: successors) {
+            if (system_jobs[successor].pending_predecessors.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                // Parenting the successor to the running job keeps the frame job incomplete until it finishes.
+                schedule_job(system_jobs + successor, get_current_job());
+            }
+        }
+    }
+
+    void System_Frame_Job::execute() {
+        Job_Handle const frame = get_current_job();
+        for (i64 i = 0; i < systems.size(); ++i) {
+            if (system_jobs[i].predecessor_count == 0) {
+                schedule_job(system_jobs + i, frame);
+            }
+        }
+    }
+
+    static bool accesses_conflict(System const& lhs, System const& rhs) {
+        if (!lhs.declares_access() || !rhs.declares_access()) {
+            return true;
+        }
+
+        for (System::Component_Access const& l: lhs.get_component_access()) {
+            for (System::Component_Access const& r: rhs.get_component_access()) {
+                if (l.type_index == r.type_index && (l.write || r.write)) {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    // Builds the dependency graph of the systems. A system depends on every conflicting system created before it,
+    // which keeps the order of conflicting systems deterministic.
+    static void build_system_schedule() {
+        delete[] system_jobs;
+        system_jobs = new System_Job[systems.size()];
+        for (i64 i = 0; i < systems.size(); ++i) {
+            system_jobs[i].system = systems[i];
+            for (i64 j = 0; j < i; ++j) {
+                if (accesses_conflict(*systems[j], *systems[i])) {
+                    system_jobs[j].successors.push_back(i);
+                    system_jobs[i].predecessor_count += 1;
+                }
+            }
+        }
+    }
+
     void init_systems() {
         systems = create_systems();
     }
@@ -17,11 +130,87 @@ namespace anton_engine {
         for (System* system: systems) {
             system->start();
         }
+
+        // Built after start so that the access the systems declare in start is taken into account.
+        build_system_schedule();
+#if ANTON_DEBUG
+        dump_system_schedule();
+#endif
     }
 
     void update_systems() {
+        if (systems.size() == 0) {
+            return;
+        }
+
+        ANTON_ASSERT(system_jobs != nullptr, "update_systems called before start_systems");
+        if (get_job_thread_count() <= 1) {
+            for (System* system: systems) {
+                update_system(system);
+            }
+            return;
+        }
+
+        ECS& ecs = get_ecs();
         for (System* system: systems) {
-            system->update();
+            for (System::Component_Access const& access: system->get_component_access()) {
+                access.prepare(ecs);
+            }
+        }
+
+        for (i64 i = 0; i < systems.size(); ++i) {
+            system_jobs[i].pending_predecessors.store(system_jobs[i].predecessor_count, std::memory_order_relaxed);
+        }
+
+        wait_for_job(schedule_job(&system_frame_job));
+    }
+
+    void dump_system_schedule() {
+        // Stage of a system is the length of the longest chain of systems it depends on.
+        // Systems in the same stage never conflict.
+        atl::Vector<i64> stages(systems.size(), 0);
+        i64 stage_count = 0;
+        for (i64 i = 0; i < systems.size(); ++i) {
+            for (i64 const successor: system_jobs[i].successors) {
+                stages[successor] = stages[successor] > stages[i] + 1 ? stages[successor] : stages[i] + 1;
+            }
+            stage_count = stage_count > stages[i] + 1 ? stage_count : stages[i] + 1;
+        }
+
+        atl::String dump = "System schedule (";
+        dump += atl::to_string(systems.size());
+        dump += " systems, ";
+        dump += atl::to_string(stage_count);
+        dump += " stages):";
+        for (i64 stage = 0; stage < stage_count; ++stage) {
+            dump += "\n  stage ";
+            dump += atl::to_string(stage);
+            dump += ":";
+            for (i64 i = 0; i < systems.size(); ++i) {
+                if (stages[i] != stage) {
+                    continue;
+                }
+
+                dump += "\n    system ";
+                dump += atl::to_string(i);
+                if (!systems[i]->declares_access()) {
+                    dump += " exclusive";
+                }
+
+                for (System::Component_Access const& access: systems[i]->get_component_access()) {
+                    dump += access.write ? " w:" : " r:";
+                    dump += atl::to_string(access.type_index);
+                }
+
+                if (system_jobs[i].successors.size() > 0) {
+                    dump += " ->";
+                    for (i64 const successor: system_jobs[i].successors) {
+                        dump += " ";
+                        dump += atl::to_string(successor);
+                    }
+                }
+            }
         }
+        ANTON_LOG_INFO(dump);
     }
 } // namespace anton_engine
@@ -6,6 +6,11 @@ namespace anton_engine {
     ENGINE_API extern create_systems_type create_systems;
 
     void init_systems();
+    // Starts the systems and builds the schedule from the component access they have declared.
     void start_systems();
+    // Updates the systems on the job threads. Returns after all systems have been updated.
     void update_systems();
+    // Logs the systems grouped into stages of systems that may run concurrently
+    // along with their component accesses and dependencies.
+    void dump_system_schedule();
 } // namespace anton_engine
@@ -19,12 +19,12 @@
 
 namespace anton_engine::input {
     struct Action_Mapping {
-        atl::String action;
+        Name action;
         Key key;
     };
 
     struct Axis_Mapping {
-        atl::String axis;
+        Name axis;
         Key key;
         // Scale by which to multiply raw value
         f32 raw_value_scale;
@@ -62,15 +62,15 @@ namespace anton_engine::input {
     };
 
     struct Axis {
-        atl::String axis;
+        Name axis;
         float value = 0.0f;
         float raw_value = 0.0f;
 
-        Axis(atl::String_View const a): axis(a) {}
+        Axis(Name const a): axis(a) {}
     };
 
     struct Action {
-        atl::String action;
+        Name action;
         Key captured_key = Key::none;
         bool down = false;
         bool pressed = false;
@@ -78,7 +78,7 @@ namespace anton_engine::input {
         bool bind_press_event = true;
         bool bind_release_event = true;
 
-        Action(atl::String_View const a): action(a) {}
+        Action(Name const a): action(a) {}
     };
 
     static atl::Flat_Hash_Map<Key, Key_State> key_states;
@@ -122,7 +122,7 @@ namespace anton_engine::input {
         key_events_queue.push_back(k);
     }
 
-    static Action_Mapping const* find_mapping_with_key(atl::Vector<Action_Mapping> const& mappings, atl::String_View const action, Key key) {
+    static Action_Mapping const* find_mapping_with_key(atl::Vector<Action_Mapping> const& mappings, Name const action, Key key) {
         for (auto& mapping: mappings) {
             if (mapping.key == key && mapping.action == action) {
                 return &mapping;
@@ -313,8 +313,8 @@ namespace anton_engine::input {
 
     // PUBLIC INTERFACE
 
-    void add_axis(atl::String_View const name, Key const k, f32 const raw_value_scale, f32 const accumulation_speed, bool const snap) {
-        Axis_Mapping const new_binding{name.data(), k, raw_value_scale, accumulation_speed, 0.0f, 0.0f, snap};
+    void add_axis(Name const name, Key const k, f32 const raw_value_scale, f32 const accumulation_speed, bool const snap) {
+        Axis_Mapping const new_binding{name, k, raw_value_scale, accumulation_speed, 0.0f, 0.0f, snap};
         bool duplicate = false;
         for (Axis_Mapping& axis_binding: axis_mappings) {
             duplicate = duplicate || (axis_binding.axis == new_binding.axis && axis_binding.key == new_binding.key);
@@ -334,8 +334,8 @@ namespace anton_engine::input {
         }
     }
 
-    void add_action(atl::String_View const name, Key const k) {
-        Action_Mapping const new_binding{name.data(), k};
+    void add_action(Name const name, Key const k) {
+        Action_Mapping const new_binding{name, k};
         bool duplicate = false;
         for (Action_Mapping& action_binding: action_mappings) {
             duplicate = duplicate || (action_binding.action == new_binding.action && action_binding.key == new_binding.key);
@@ -353,33 +353,33 @@ namespace anton_engine::input {
         }
     }
 
-    f32 get_axis(atl::String_View const axis_name) {
+    f32 get_axis(Name const axis_name) {
         for (Axis& axis: axes) {
             if (axis_name == axis.axis) {
                 return axis.value;
             }
         }
-        ANTON_LOG_WARNING("Unknown axis " + atl::String(axis_name.data()));
+        ANTON_LOG_WARNING("Unknown axis " + atl::String(axis_name.get_string()));
         return 0;
     }
 
-    f32 get_axis_raw(atl::String_View const axis_name) {
+    f32 get_axis_raw(Name const axis_name) {
         for (Axis& axis: axes) {
             if (axis_name == axis.axis) {
                 return axis.raw_value;
             }
         }
-        ANTON_LOG_WARNING("Unknown axis " + atl::String(axis_name.data()));
+        ANTON_LOG_WARNING("Unknown axis " + atl::String(axis_name.get_string()));
         return 0;
     }
 
-    Action_State get_action(atl::String_View const action_name) {
+    Action_State get_action(Name const action_name) {
         for (Action& action: actions) {
             if (action_name == action.action) {
                 return {action.down, action.pressed, action.released};
             }
         }
-        ANTON_LOG_WARNING("Unknown action " + atl::String(action_name.data()));
+        ANTON_LOG_WARNING("Unknown action " + atl::String(action_name.get_string()));
         return {};
     }
 
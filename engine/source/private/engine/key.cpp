@@ -166,153 +166,154 @@ namespace anton_engine {
         return key_string.find_or_emplace(key)->value;
     }
 
-    static atl::Flat_Hash_Map<u64, Key> construct_string_key_map() {
-        atl::Flat_Hash_Map<u64, Key> string_key;
-        string_key.emplace(atl::hash("none"), Key::none);
-        string_key.emplace(atl::hash("any_key"), Key::any_key);
-        string_key.emplace(atl::hash("mouse_x"), Key::mouse_x);
-        string_key.emplace(atl::hash("mouse_y"), Key::mouse_y);
-        string_key.emplace(atl::hash("mouse_scroll"), Key::mouse_scroll);
-        string_key.emplace(atl::hash("mouse_horiz_scroll"), Key::mouse_horiz_scroll);
-        string_key.emplace(atl::hash("left_mouse_button"), Key::left_mouse_button);
-        string_key.emplace(atl::hash("right_mouse_button"), Key::right_mouse_button);
-        string_key.emplace(atl::hash("middle_mouse_button"), Key::middle_mouse_button);
-        string_key.emplace(atl::hash("thumb_mouse_button_1"), Key::thumb_mouse_button_1);
-        string_key.emplace(atl::hash("thumb_mouse_button_2"), Key::thumb_mouse_button_2);
-        string_key.emplace(atl::hash("mouse_button_6"), Key::mouse_button_6);
-        string_key.emplace(atl::hash("mouse_button_7"), Key::mouse_button_7);
-        string_key.emplace(atl::hash("mouse_button_8"), Key::mouse_button_8);
-        string_key.emplace(atl::hash("escape"), Key::escape);
-        string_key.emplace(atl::hash("enter"), Key::enter);
-        string_key.emplace(atl::hash("tab"), Key::tab);
-        string_key.emplace(atl::hash("caps_lock"), Key::caps_lock);
-        string_key.emplace(atl::hash("spacebar"), Key::spacebar);
-        string_key.emplace(atl::hash("backspace"), Key::backspace);
-        string_key.emplace(atl::hash("left_alt"), Key::left_alt);
-        string_key.emplace(atl::hash("right_alt"), Key::right_alt);
-        string_key.emplace(atl::hash("left_shift"), Key::left_shift);
-        string_key.emplace(atl::hash("right_shift"), Key::right_shift);
-        string_key.emplace(atl::hash("left_control"), Key::left_control);
-        string_key.emplace(atl::hash("right_control"), Key::right_control);
-        string_key.emplace(atl::hash("numpad_0"), Key::numpad_0);
-        string_key.emplace(atl::hash("numpad_1"), Key::numpad_1);
-        string_key.emplace(atl::hash("numpad_2"), Key::numpad_2);
-        string_key.emplace(atl::hash("numpad_3"), Key::numpad_3);
-        string_key.emplace(atl::hash("numpad_4"), Key::numpad_4);
-        string_key.emplace(atl::hash("numpad_5"), Key::numpad_5);
-        string_key.emplace(atl::hash("numpad_6"), Key::numpad_6);
-        string_key.emplace(atl::hash("numpad_7"), Key::numpad_7);
-        string_key.emplace(atl::hash("numpad_8"), Key::numpad_8);
-        string_key.emplace(atl::hash("numpad_9"), Key::numpad_9);
-        string_key.emplace(atl::hash("numpad_add"), Key::numpad_add);
-        string_key.emplace(atl::hash("numpad_subtract"), Key::numpad_subtract);
-        string_key.emplace(atl::hash("numpad_divide"), Key::numpad_divide);
-        string_key.emplace(atl::hash("numpad_multiply"), Key::numpad_multiply);
-        string_key.emplace(atl::hash("numpad_decimal"), Key::numpad_decimal);
-        string_key.emplace(atl::hash("numpad_enter"), Key::numpad_enter);
-        string_key.emplace(atl::hash("numlock"), Key::numlock);
-        string_key.emplace(atl::hash("left"), Key::left);
-        string_key.emplace(atl::hash("right"), Key::right);
-        string_key.emplace(atl::hash("up"), Key::up);
-        string_key.emplace(atl::hash("down"), Key::down);
-        string_key.emplace(atl::hash("insert"), Key::insert);
-        string_key.emplace(atl::hash("home"), Key::home);
-        string_key.emplace(atl::hash("page_up"), Key::page_up);
-        string_key.emplace(atl::hash("page_down"), Key::page_down);
-        string_key.emplace(atl::hash("end"), Key::end);
-        string_key.emplace(atl::hash("del"), Key::del);
-        string_key.emplace(atl::hash("zero"), Key::zero);
-        string_key.emplace(atl::hash("one"), Key::one);
-        string_key.emplace(atl::hash("two"), Key::two);
-        string_key.emplace(atl::hash("three"), Key::three);
-        string_key.emplace(atl::hash("four"), Key::four);
-        string_key.emplace(atl::hash("five"), Key::five);
-        string_key.emplace(atl::hash("six"), Key::six);
-        string_key.emplace(atl::hash("seven"), Key::seven);
-        string_key.emplace(atl::hash("eight"), Key::eight);
-        string_key.emplace(atl::hash("nine"), Key::nine);
-        string_key.emplace(atl::hash("a"), Key::a);
-        string_key.emplace(atl::hash("b"), Key::b);
-        string_key.emplace(atl::hash("c"), Key::c);
-        string_key.emplace(atl::hash("d"), Key::d);
-        string_key.emplace(atl::hash("e"), Key::e);
-        string_key.emplace(atl::hash("f"), Key::f);
-        string_key.emplace(atl::hash("g"), Key::g);
-        string_key.emplace(atl::hash("h"), Key::h);
-        string_key.emplace(atl::hash("i"), Key::i);
-        string_key.emplace(atl::hash("j"), Key::j);
-        string_key.emplace(atl::hash("k"), Key::k);
-        string_key.emplace(atl::hash("l"), Key::l);
-        string_key.emplace(atl::hash("m"), Key::m);
-        string_key.emplace(atl::hash("n"), Key::n);
-        string_key.emplace(atl::hash("o"), Key::o);
-        string_key.emplace(atl::hash("p"), Key::p);
-        string_key.emplace(atl::hash("q"), Key::q);
-        string_key.emplace(atl::hash("r"), Key::r);
-        string_key.emplace(atl::hash("s"), Key::s);
-        string_key.emplace(atl::hash("t"), Key::t);
-        string_key.emplace(atl::hash("u"), Key::u);
-        string_key.emplace(atl::hash("v"), Key::v);
-        string_key.emplace(atl::hash("w"), Key::w);
-        string_key.emplace(atl::hash("x"), Key::x);
-        string_key.emplace(atl::hash("y"), Key::y);
-        string_key.emplace(atl::hash("z"), Key::z);
-        string_key.emplace(atl::hash("slash"), Key::slash);
-        string_key.emplace(atl::hash("comma"), Key::comma);
-        string_key.emplace(atl::hash("dot"), Key::dot);
-        string_key.emplace(atl::hash("semicolon"), Key::semicolon);
-        string_key.emplace(atl::hash("left_bracket"), Key::left_bracket);
-        string_key.emplace(atl::hash("right_bracket"), Key::right_bracket);
-        string_key.emplace(atl::hash("minus"), Key::minus);
-        string_key.emplace(atl::hash("equals"), Key::equals);
-        string_key.emplace(atl::hash("apostrophe"), Key::apostrophe);
-        string_key.emplace(atl::hash("tick"), Key::tick);
-        string_key.emplace(atl::hash("backward_slash"), Key::backward_slash);
-        string_key.emplace(atl::hash("f1"), Key::f1);
-        string_key.emplace(atl::hash("f2"), Key::f2);
-        string_key.emplace(atl::hash("f3"), Key::f3);
-        string_key.emplace(atl::hash("f4"), Key::f4);
-        string_key.emplace(atl::hash("f5"), Key::f5);
-        string_key.emplace(atl::hash("f6"), Key::f6);
-        string_key.emplace(atl::hash("f7"), Key::f7);
-        string_key.emplace(atl::hash("f8"), Key::f8);
-        string_key.emplace(atl::hash("f9"), Key::f9);
-        string_key.emplace(atl::hash("f10"), Key::f10);
-        string_key.emplace(atl::hash("f11"), Key::f11);
-        string_key.emplace(atl::hash("f12"), Key::f12);
-        string_key.emplace(atl::hash("pause"), Key::pause);
-        string_key.emplace(atl::hash("gamepad_left_stick_x_axis"), Key::gamepad_left_stick_x_axis);
-        string_key.emplace(atl::hash("gamepad_left_stick_y_axis"), Key::gamepad_left_stick_y_axis);
-        string_key.emplace(atl::hash("gamepad_right_stick_x_axis"), Key::gamepad_right_stick_x_axis);
-        string_key.emplace(atl::hash("gamepad_right_stick_y_axis"), Key::gamepad_right_stick_y_axis);
-        string_key.emplace(atl::hash("gamepad_left_trigger"), Key::gamepad_left_trigger);
-        string_key.emplace(atl::hash("gamepad_right_trigger"), Key::gamepad_right_trigger);
-        string_key.emplace(atl::hash("gamepad_button_0"), Key::gamepad_button_0);
-        string_key.emplace(atl::hash("gamepad_button_1"), Key::gamepad_button_1);
-        string_key.emplace(atl::hash("gamepad_button_2"), Key::gamepad_button_2);
-        string_key.emplace(atl::hash("gamepad_button_3"), Key::gamepad_button_3);
-        string_key.emplace(atl::hash("gamepad_button_4"), Key::gamepad_button_4);
-        string_key.emplace(atl::hash("gamepad_button_5"), Key::gamepad_button_5);
-        string_key.emplace(atl::hash("gamepad_button_6"), Key::gamepad_button_6);
-        string_key.emplace(atl::hash("gamepad_button_7"), Key::gamepad_button_7);
-        string_key.emplace(atl::hash("gamepad_button_8"), Key::gamepad_button_8);
-        string_key.emplace(atl::hash("gamepad_button_9"), Key::gamepad_button_9);
-        string_key.emplace(atl::hash("gamepad_button_10"), Key::gamepad_button_10);
-        string_key.emplace(atl::hash("gamepad_button_11"), Key::gamepad_button_11);
-        string_key.emplace(atl::hash("gamepad_button_12"), Key::gamepad_button_12);
-        string_key.emplace(atl::hash("gamepad_button_13"), Key::gamepad_button_13);
-        string_key.emplace(atl::hash("gamepad_button_14"), Key::gamepad_button_14);
-        string_key.emplace(atl::hash("gamepad_button_15"), Key::gamepad_button_15);
-        string_key.emplace(atl::hash("gamepad_button_16"), Key::gamepad_button_16);
-        string_key.emplace(atl::hash("gamepad_button_17"), Key::gamepad_button_17);
-        string_key.emplace(atl::hash("gamepad_button_18"), Key::gamepad_button_18);
-        string_key.emplace(atl::hash("gamepad_button_19"), Key::gamepad_button_19);
+    static atl::Flat_Hash_Map<atl::String_View, Key> construct_string_key_map() {
+        atl::Flat_Hash_Map<atl::String_View, Key> string_key(atl::reserve, 139);
+        string_key.emplace("none", Key::none);
+        string_key.emplace("any_key", Key::any_key);
+        string_key.emplace("mouse_x", Key::mouse_x);
+        string_key.emplace("mouse_y", Key::mouse_y);
+        string_key.emplace("mouse_scroll", Key::mouse_scroll);
+        string_key.emplace("mouse_horiz_scroll", Key::mouse_horiz_scroll);
+        string_key.emplace("left_mouse_button", Key::left_mouse_button);
+        string_key.emplace("right_mouse_button", Key::right_mouse_button);
+        string_key.emplace("middle_mouse_button", Key::middle_mouse_button);
+        string_key.emplace("thumb_mouse_button_1", Key::thumb_mouse_button_1);
+        string_key.emplace("thumb_mouse_button_2", Key::thumb_mouse_button_2);
+        string_key.emplace("mouse_button_6", Key::mouse_button_6);
+        string_key.emplace("mouse_button_7", Key::mouse_button_7);
+        string_key.emplace("mouse_button_8", Key::mouse_button_8);
+        string_key.emplace("escape", Key::escape);
+        string_key.emplace("enter", Key::enter);
+        string_key.emplace("tab", Key::tab);
+        string_key.emplace("caps_lock", Key::caps_lock);
+        string_key.emplace("spacebar", Key::spacebar);
+        string_key.emplace("backspace", Key::backspace);
+        string_key.emplace("left_alt", Key::left_alt);
+        string_key.emplace("right_alt", Key::right_alt);
+        string_key.emplace("left_shift", Key::left_shift);
+        string_key.emplace("right_shift", Key::right_shift);
+        string_key.emplace("left_control", Key::left_control);
+        string_key.emplace("right_control", Key::right_control);
+        string_key.emplace("numpad_0", Key::numpad_0);
+        string_key.emplace("numpad_1", Key::numpad_1);
+        string_key.emplace("numpad_2", Key::numpad_2);
+        string_key.emplace("numpad_3", Key::numpad_3);
+        string_key.emplace("numpad_4", Key::numpad_4);
+        string_key.emplace("numpad_5", Key::numpad_5);
+        string_key.emplace("numpad_6", Key::numpad_6);
+        string_key.emplace("numpad_7", Key::numpad_7);
+        string_key.emplace("numpad_8", Key::numpad_8);
+        string_key.emplace("numpad_9", Key::numpad_9);
+        string_key.emplace("numpad_add", Key::numpad_add);
+        string_key.emplace("numpad_subtract", Key::numpad_subtract);
+        string_key.emplace("numpad_divide", Key::numpad_divide);
+        string_key.emplace("numpad_multiply", Key::numpad_multiply);
+        string_key.emplace("numpad_decimal", Key::numpad_decimal);
+        string_key.emplace("numpad_enter", Key::numpad_enter);
+        string_key.emplace("numlock", Key::numlock);
+        string_key.emplace("left", Key::left);
+        string_key.emplace("right", Key::right);
+        string_key.emplace("up", Key::up);
+        string_key.emplace("down", Key::down);
+        string_key.emplace("insert", Key::insert);
+        string_key.emplace("home", Key::home);
+        string_key.emplace("page_up", Key::page_up);
+        string_key.emplace("page_down", Key::page_down);
+        string_key.emplace("end", Key::end);
+        string_key.emplace("del", Key::del);
+        string_key.emplace("zero", Key::zero);
+        string_key.emplace("one", Key::one);
+        string_key.emplace("two", Key::two);
+        string_key.emplace("three", Key::three);
+        string_key.emplace("four", Key::four);
+        string_key.emplace("five", Key::five);
+        string_key.emplace("six", Key::six);
+        string_key.emplace("seven", Key::seven);
+        string_key.emplace("eight", Key::eight);
+        string_key.emplace("nine", Key::nine);
+        string_key.emplace("a", Key::a);
+        string_key.emplace("b", Key::b);
+        string_key.emplace("c", Key::c);
+        string_key.emplace("d", Key::d);
+        string_key.emplace("e", Key::e);
+        string_key.emplace("f", Key::f);
+        string_key.emplace("g", Key::g);
+        string_key.emplace("h", Key::h);
+        string_key.emplace("i", Key::i);
+        string_key.emplace("j", Key::j);
+        string_key.emplace("k", Key::k);
+        string_key.emplace("l", Key::l);
+        string_key.emplace("m", Key::m);
+        string_key.emplace("n", Key::n);
+        string_key.emplace("o", Key::o);
+        string_key.emplace("p", Key::p);
+        string_key.emplace("q", Key::q);
+        string_key.emplace("r", Key::r);
+        string_key.emplace("s", Key::s);
+        string_key.emplace("t", Key::t);
+        string_key.emplace("u", Key::u);
+        string_key.emplace("v", Key::v);
+        string_key.emplace("w", Key::w);
+        string_key.emplace("x", Key::x);
+        string_key.emplace("y", Key::y);
+        string_key.emplace("z", Key::z);
+        string_key.emplace("slash", Key::slash);
+        string_key.emplace("comma", Key::comma);
+        string_key.emplace("dot", Key::dot);
+        string_key.emplace("semicolon", Key::semicolon);
+        string_key.emplace("left_bracket", Key::left_bracket);
+        string_key.emplace("right_bracket", Key::right_bracket);
+        string_key.emplace("minus", Key::minus);
+        string_key.emplace("equals", Key::equals);
+        string_key.emplace("apostrophe", Key::apostrophe);
+        string_key.emplace("tick", Key::tick);
+        string_key.emplace("backward_slash", Key::backward_slash);
+        string_key.emplace("f1", Key::f1);
+        string_key.emplace("f2", Key::f2);
+        string_key.emplace("f3", Key::f3);
+        string_key.emplace("f4", Key::f4);
+        string_key.emplace("f5", Key::f5);
+        string_key.emplace("f6", Key::f6);
+        string_key.emplace("f7", Key::f7);
+        string_key.emplace("f8", Key::f8);
+        string_key.emplace("f9", Key::f9);
+        string_key.emplace("f10", Key::f10);
+        string_key.emplace("f11", Key::f11);
+        string_key.emplace("f12", Key::f12);
+        string_key.emplace("pause", Key::pause);
+        string_key.emplace("gamepad_left_stick_x_axis", Key::gamepad_left_stick_x_axis);
+        string_key.emplace("gamepad_left_stick_y_axis", Key::gamepad_left_stick_y_axis);
+        string_key.emplace("gamepad_right_stick_x_axis", Key::gamepad_right_stick_x_axis);
+        string_key.emplace("gamepad_right_stick_y_axis", Key::gamepad_right_stick_y_axis);
+        string_key.emplace("gamepad_left_trigger", Key::gamepad_left_trigger);
+        string_key.emplace("gamepad_right_trigger", Key::gamepad_right_trigger);
+        string_key.emplace("gamepad_button_0", Key::gamepad_button_0);
+        string_key.emplace("gamepad_button_1", Key::gamepad_button_1);
+        string_key.emplace("gamepad_button_2", Key::gamepad_button_2);
+        string_key.emplace("gamepad_button_3", Key::gamepad_button_3);
+        string_key.emplace("gamepad_button_4", Key::gamepad_button_4);
+        string_key.emplace("gamepad_button_5", Key::gamepad_button_5);
+        string_key.emplace("gamepad_button_6", Key::gamepad_button_6);
+        string_key.emplace("gamepad_button_7", Key::gamepad_button_7);
+        string_key.emplace("gamepad_button_8", Key::gamepad_button_8);
+        string_key.emplace("gamepad_button_9", Key::gamepad_button_9);
+        string_key.emplace("gamepad_button_10", Key::gamepad_button_10);
+        string_key.emplace("gamepad_button_11", Key::gamepad_button_11);
+        string_key.emplace("gamepad_button_12", Key::gamepad_button_12);
+        string_key.emplace("gamepad_button_13", Key::gamepad_button_13);
+        string_key.emplace("gamepad_button_14", Key::gamepad_button_14);
+        string_key.emplace("gamepad_button_15", Key::gamepad_button_15);
+        string_key.emplace("gamepad_button_16", Key::gamepad_button_16);
+        string_key.emplace("gamepad_button_17", Key::gamepad_button_17);
+        string_key.emplace("gamepad_button_18", Key::gamepad_button_18);
+        string_key.emplace("gamepad_button_19", Key::gamepad_button_19);
         return string_key;
     }
 
     Key key_from_string(atl::String_View const str) {
-        static atl::Flat_Hash_Map<u64, Key> string_key = construct_string_key_map();
-        u64 const h = atl::hash(str);
-        return string_key.find_or_emplace(h)->value;
+        static atl::Flat_Hash_Map<atl::String_View, Key> string_key = construct_string_key_map();
+        // Does not insert unknown strings since the map would keep views of the caller's memory.
+        auto const iter = string_key.find(str);
+        return iter != string_key.end() ? iter->value : Key::none;
     }
 } // namespace anton_engine
@@ -0,0 +1,209 @@
+#include <engine/transform_hierarchy.hpp>
+
+#include <core/anton_crt.hpp>
+#include <core/assert.hpp>
+#include <engine/components/hierarchy.hpp>
+#include <engine/components/world_transform.hpp>
+
+namespace anton_engine {
+    // Removes entity from the list of children of its parent.
+    static void unlink(ECS& ecs, Hierarchy& hierarchy) {
+        if (hierarchy.previous_sibling != null_entity) {
+            ecs.get_component<Hierarchy>(hierarchy.previous_sibling).next_sibling = hierarchy.next_sibling;
+        } else if (hierarchy.parent != null_entity) {
+            ecs.get_component<Hierarchy>(hierarchy.parent).first_child = hierarchy.next_sibling;
+        }
+
+        if (hierarchy.next_sibling != null_entity) {
+            ecs.get_component<Hierarchy>(hierarchy.next_sibling).previous_sibling = hierarchy.previous_sibling;
+        }
+
+        hierarchy.parent = null_entity;
+        hierarchy.previous_sibling = null_entity;
+        hierarchy.next_sibling = null_entity;
+    }
+
+    Transform_Hierarchy::Transform_Hierarchy(ECS& ecs): ecs(&ecs) {
+        observers[0] = ecs.on_construct<Transform>(on_structure_changed, this);
+        observers[1] = ecs.on_destroy<Transform>(on_structure_changed, this);
+        observers[2] = ecs.on_construct<Hierarchy>(on_structure_changed, this);
+        observers[3] = ecs.on_destroy<Hierarchy>(on_hierarchy_destroyed, this);
+        ecs.track_changes<Transform>();
+        // Creates the container, which lets snapshots include World_Transform before any entity has been updated.
+        ecs.view<World_Transform>();
+    }
+
+    Transform_Hierarchy::~Transform_Hierarchy() {
+        for (ECS::Observer_Handle const observer: observers) {
+            ecs->remove_observer(observer);
+        }
+    }
+
+    void Transform_Hierarchy::set_parent(Entity const child, Entity const parent) {
+        ECS& ecs = *this->ecs;
+        // Add the components before taking references to them since adding may relocate the components.
+        if (!ecs.has_component<Hierarchy>(child)) {
+            ecs.add_component<Hierarchy>(child);
+        }
+
+        if (parent != null_entity && !ecs.has_component<Hierarchy>(parent)) {
+            ecs.add_component<Hierarchy>(parent);
+        }
+
+        for (Entity ancestor = parent; ancestor != null_entity; ancestor = ecs.get_component<Hierarchy>(ancestor).parent) {
+            ANTON_ASSERT(ancestor != child, "Attempting to parent an entity to its own descendant.");
+        }
+
+        Hierarchy& hierarchy = ecs.get_component<Hierarchy>(child);
+        if (hierarchy.parent == parent) {
+            return;
+        }
+
+        unlink(ecs, hierarchy);
+        if (parent != null_entity) {
+            Hierarchy& parent_hierarchy = ecs.get_component<Hierarchy>(parent);
+            if (parent_hierarchy.first_child != null_entity) {
+                ecs.get_component<Hierarchy>(parent_hierarchy.first_child).previous_sibling = child;
+            }
+            hierarchy.parent = parent;
+            hierarchy.next_sibling = parent_hierarchy.first_child;
+            parent_hierarchy.first_child = child;
+        }
+        structure_changed = true;
+    }
+
+    void Transform_Hierarchy::update() {
+        ECS& ecs = *this->ecs;
+        // The entities whose transforms have been added or modified since the last update are dirty.
+        // A rebuild marks all entities dirty.
+        u64 const change_tick = ecs.advance_change_tick();
+        i64 first_dirty = nodes.size();
+        if (structure_changed) {
+            rebuild();
+            structure_changed = false;
+            first_dirty = 0;
+        } else {
+            ecs.each_changed<Transform>(last_change_tick, [this, &first_dirty](Entity const entity, Transform const&) {
+                i64 const node = find_node(entity);
+                if (node != -1) {
+                    dirty[node] = 1;
+                    first_dirty = node < first_dirty ? node : first_dirty;
+                }
+            });
+        }
+        last_change_tick = change_tick;
+
+        // Parents precede their children, therefore a single pass propagates the dirty flags down the subtrees
+        // and every parent world matrix is up to date by the time its children are computed.
+        for (i64 i = first_dirty; i < nodes.size(); ++i) {
+            i64 const parent = parents[i];
+            if (parent != -1 && dirty[parent]) {
+                dirty[i] = 1;
+            }
+
+            if (!dirty[i]) {
+                continue;
+            }
+
+            Matrix4 const local = to_matrix(ecs.get_component<Transform>(nodes[i]));
+            world_matrices[i] = parent != -1 ? local * world_matrices[parent] : local;
+            ecs.get_component<World_Transform>(nodes[i]).matrix = world_matrices[i];
+        }
+
+        if (first_dirty < nodes.size()) {
+            memset(dirty.data() + first_dirty, 0, nodes.size() - first_dirty);
+        }
+    }
+
+    Matrix4 Transform_Hierarchy::get_world_matrix(Entity const entity) const {
+        i64 const node = find_node(entity);
+        return node != -1 ? world_matrices[node] : Matrix4::identity;
+    }
+
+    i64 Transform_Hierarchy::find_node(Entity const entity) const {
+        u64 const index = entity_index(entity);
+        if (index >= static_cast<u64>(node_indices.size())) {
+            return -1;
+        }
+
+        i64 const node = node_indices[index];
+        return node != -1 && nodes[node] == entity ? node : -1;
+    }
+
+    void Transform_Hierarchy::rebuild() {
+        ECS& ecs = *this->ecs;
+        i64 const transform_count = ecs.count<Transform>();
+        Entity const* const entities = ecs.entities<Transform>();
+        u64 index_count = 0;
+        for (i64 i = 0; i < transform_count; ++i) {
+            u64 const index = entity_index(entities[i]) + 1;
+            index_count = index > index_count ? index : index_count;
+        }
+
+        node_indices.resize(index_count);
+        for (i64& node: node_indices) {
+            node = -1;
+        }
+
+        nodes.clear();
+        parents.clear();
+        auto const push_node = [this](Entity const entity, i64 const parent) {
+            node_indices[entity_index(entity)] = nodes.size();
+            nodes.push_back(entity);
+            parents.push_back(parent);
+        };
+
+        // Roots are the entities whose parents do not have Transform.
+        for (i64 i = 0; i < transform_count; ++i) {
+            Hierarchy const* const hierarchy = ecs.try_get_component<Hierarchy>(entities[i]);
+            if (!hierarchy || hierarchy->parent == null_entity || !ecs.has_component<Transform>(hierarchy->parent)) {
+                push_node(entities[i], -1);
+            }
+        }
+
+        // Breadth-first traversal appends the children after all nodes of the previous depth.
+        for (i64 i = 0; i < nodes.size(); ++i) {
+            Hierarchy const* const hierarchy = ecs.try_get_component<Hierarchy>(nodes[i]);
+            if (!hierarchy) {
+                continue;
+            }
+
+            for (Entity child = hierarchy->first_child; child != null_entity; child = ecs.get_component<Hierarchy>(child).next_sibling) {
+                if (ecs.has_component<Transform>(child)) {
+                    push_node(child, i);
+                }
+            }
+        }
+
+        for (Entity const entity: nodes) {
+            if (!ecs.has_component<World_Transform>(entity)) {
+                ecs.add_component<World_Transform>(entity);
+            }
+        }
+
+        world_matrices.resize(nodes.size());
+        dirty.resize(nodes.size());
+        for (u8& flag: dirty) {
+            flag = 1;
+        }
+    }
+
+    void Transform_Hierarchy::on_structure_changed(ECS&, Entity, void* const user_data) {
+        static_cast<Transform_Hierarchy*>(user_data)->structure_changed = true;
+    }
+
+    void Transform_Hierarchy::on_hierarchy_destroyed(ECS& ecs, Entity const entity, void* const user_data) {
+        // Detach the entity from its parent and turn its children into roots.
+        Hierarchy& hierarchy = ecs.get_component<Hierarchy>(entity);
+        unlink(ecs, hierarchy);
+        for (Entity child = hierarchy.first_child; child != null_entity;) {
+            Hierarchy& child_hierarchy = ecs.get_component<Hierarchy>(child);
+            child = child_hierarchy.next_sibling;
+            child_hierarchy.parent = null_entity;
+            child_hierarchy.previous_sibling = null_entity;
+            child_hierarchy.next_sibling = null_entity;
+        }
+        hierarchy.first_child = null_entity;
+        static_cast<Transform_Hierarchy*>(user_data)->structure_changed = true;
+    }
+} // namespace anton_engine
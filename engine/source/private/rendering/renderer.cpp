@@ -3,6 +3,7 @@
 #include <core/exception.hpp>
 #include <core/types.hpp>
 #include <core/atl/algorithm.hpp>
+#include <core/atl/allocator.hpp>
 #include <core/atl/string.hpp>
 #include <core/atl/utility.hpp>
 #include <core/atl/vector.hpp>
@@ -16,6 +17,7 @@
 #include <engine/components/spot_light_component.hpp>
 #include <engine/components/static_mesh_component.hpp>
 #include <engine/components/transform.hpp>
+#include <engine/components/world_transform.hpp>
 #include <engine/ecs/ecs.hpp>
 #include <engine.hpp>
 #include <rendering/framebuffer.hpp>
@@ -32,8 +34,6 @@
 #include <core/utils/enum.hpp>
 #include <core/atl/flat_hash_map.hpp>
 
-#include <algorithm> // std::sort
-
 #if ANTON_WITH_EDITOR
 #    include <editor.hpp>
 #endif
@@ -476,6 +476,22 @@ namespace anton_engine::rendering {
         return matrix_head_offset;
     }
 
+    // Reserves matrices and materials for count draws at the same offset in their buffers.
+    // Returns: Offset of the reserved range to be used as base_instance in draw commands.
+    [[nodiscard]] static u32 reserve_matrices_and_materials(i64 const count) {
+        ANTON_ASSERT(count <= matrix_buffer.size, "Too many draws for the draw data buffers.");
+        i64 const matrix_head_offset = matrix_buffer.head - matrix_buffer.buffer;
+        i64 const material_head_offset = material_buffer.head - material_buffer.buffer;
+        i64 offset = matrix_head_offset > material_head_offset ? matrix_head_offset : material_head_offset;
+        if (matrix_buffer.size - offset < count) {
+            offset = 0;
+        }
+
+        matrix_buffer.head = matrix_buffer.buffer + offset + count;
+        material_buffer.head = material_buffer.buffer + offset + count;
+        return offset;
+    }
+
     u64 write_persistent_geometry(atl::Slice<Vertex const> const vertices, atl::Slice<u32 const> const indices) {
         // TODO: Checks, safety, fencing, anything? Right now I'm pretty sure I'll not overwrite,
         //       but we'll need all of that in the future.
@@ -543,20 +559,190 @@ namespace anton_engine::rendering {
         }
     }
 
-    void render_scene(ECS snapshot, Transform const camera_transform, Matrix4 const view, Matrix4 const projection) {
-        snapshot.sort<Static_Mesh_Component>(
-            [](auto begin, auto end, auto predicate) { std::sort(begin, end, predicate); },
-            [](Static_Mesh_Component const lhs, Static_Mesh_Component const rhs) -> bool {
-                return lhs.shader_handle < rhs.shader_handle || (lhs.shader_handle == rhs.shader_handle && lhs.material_handle < rhs.material_handle) ||
-                       (lhs.shader_handle == rhs.shader_handle && lhs.material_handle == rhs.material_handle && lhs.mesh_handle < rhs.mesh_handle);
-            });
+    // Packs the state draws are sorted by into a single key with the shader in the highest bits followed by the material and the mesh.
+    // Handles that do not fit in their fields are clamped, which may only cost additional state changes.
+    [[nodiscard]] static u64 make_render_key(Static_Mesh_Component const& static_mesh) {
+        auto const field = [](u64 const value, u64 const bits) -> u64 {
+            u64 const max = (u64(1) << bits) - 1;
+            return value < max ? value : max;
+        };
+
+        return field(static_mesh.shader_handle.value, 16) << 48 | field(static_mesh.material_handle.value, 24) << 24 |
+               field(static_mesh.mesh_handle.value, 24);
+    }
+
+    // Sorts keys and the corresponding values by keys with insertion sort unless that takes more than budget moves.
+    // Returns: true if the keys have been sorted. Otherwise the keys and values are left in an unspecified order.
+    static bool insertion_sort_keys(u64* const keys, u32* const values, i64 const count, i64 budget) {
+        for (i64 i = 1; i < count; ++i) {
+            u64 const key = keys[i];
+            u32 const value = values[i];
+            i64 j = i;
+            for (; j > 0 && keys[j - 1] > key; --j) {
+                keys[j] = keys[j - 1];
+                values[j] = values[j - 1];
+            }
+            keys[j] = key;
+            values[j] = value;
+            budget -= i - j;
+            if (budget < 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Stable LSD radix sort of keys and the corresponding values by keys, one byte per pass.
+    // Passes in which all keys have the same byte are skipped, which for render keys is most of them.
+    static void radix_sort_keys(atl::Vector<u64>& keys, atl::Vector<u32>& values, atl::Vector<u64>& keys_scratch, atl::Vector<u32>& values_scratch) {
+        i64 const count = keys.size();
+        if (count == 0) {
+            return;
+        }
+
+        i64 histograms[8][256] = {};
+        for (u64 const key: keys) {
+            for (i64 pass = 0; pass < 8; ++pass) {
+                histograms[pass][(key >> (pass * 8)) & 0xFF] += 1;
+            }
+        }
+
+        keys_scratch.resize(count);
+        values_scratch.resize(count);
+        for (i64 pass = 0; pass < 8; ++pass) {
+            i64* const offsets = histograms[pass];
+            if (offsets[(keys[0] >> (pass * 8)) & 0xFF] == count) {
+                continue;
+            }
+
+            i64 offset = 0;
+            for (i64 digit = 0; digit < 256; ++digit) {
+                i64 const digit_count = offsets[digit];
+                offsets[digit] = offset;
+                offset += digit_count;
+            }
+
+            for (i64 i = 0; i < count; ++i) {
+                i64 const destination = offsets[(keys[i] >> (pass * 8)) & 0xFF]++;
+                keys_scratch[destination] = keys[i];
+                values_scratch[destination] = values[i];
+            }
+
+            atl::swap(keys, keys_scratch);
+            atl::swap(values, values_scratch);
+        }
+    }
+
+    // Draw order of the previous frame and the keys and scratch buffers used to sort it.
+    static atl::Vector<u32> draw_order;
+    static atl::Vector<u64> draw_keys;
+    static atl::Vector<u32> draw_order_scratch;
+    static atl::Vector<u64> draw_keys_scratch;
+    // Local transforms of the draws without World_Transform stored as separate arrays of components and their matrices.
+    static atl::Vector<float> local_transform_components;
+    static atl::Vector<Matrix4> local_matrices;
+
+    void render_scene(ECS const& snapshot, Transform const camera_transform, Matrix4 const view, Matrix4 const projection) {
+        // Sort indices instead of the snapshot itself so that the snapshot stays read-only
+        // and shared snapshots do not have to be copied again in the next frame.
+        Static_Mesh_Component const* const static_meshes = snapshot.components<Static_Mesh_Component>();
+        Entity const* const static_mesh_entities = snapshot.entities<Static_Mesh_Component>();
+        // Static meshes that belong to a group owning Transform have their transforms at the same indices.
+        Transform const* const transforms = snapshot.components<Transform>();
+        Entity const* const transform_entities = snapshot.entities<Transform>();
+        i64 const transform_count = snapshot.count<Transform>();
+        i64 const static_mesh_count = snapshot.count<Static_Mesh_Component>();
+        // The keys rarely change between frames. Start from the order of the previous frame, which usually
+        // is already sorted or needs a few fixups, and fall back to radix sort when it is far from sorted.
+        if (draw_order.size() != static_mesh_count) {
+            draw_order.resize(static_mesh_count);
+            for (i64 i = 0; i < static_mesh_count; ++i) {
+                draw_order[i] = static_cast<u32>(i);
+            }
+        }
+
+        draw_keys.resize(static_mesh_count);
+        for (i64 i = 0; i < static_mesh_count; ++i) {
+            draw_keys[i] = make_render_key(static_meshes[draw_order[i]]);
+        }
+
+        if (!insertion_sort_keys(draw_keys.data(), draw_order.data(), static_mesh_count, static_mesh_count)) {
+            radix_sort_keys(draw_keys, draw_order, draw_keys_scratch, draw_order_scratch);
+        }
+
+        struct Draw_Instance {
+            Static_Mesh_Component static_mesh;
+            // nullptr if the entity has not been updated by Transform_Hierarchy yet.
+            World_Transform const* world_transform;
+        };
+
+        // Gather the components in draw order in a single pass. Entities without World_Transform are drawn
+        // with their local transforms, which are gathered into arrays of components for the batch conversion.
+        atl::Vector<Draw_Instance, atl::Polymorphic_Allocator> draws(atl::reserve, static_mesh_count, &atl::get_frame_allocator());
+        local_transform_components.resize(10 * static_mesh_count);
+        float* const components = local_transform_components.data();
+        i64 const stride = static_mesh_count;
+        math::transform::Transform_Arrays const local_transforms = {
+            {components, components + stride, components + 2 * stride, components + 3 * stride},
+            {components + 4 * stride, components + 5 * stride, components + 6 * stride},
+            {components + 7 * stride, components + 8 * stride, components + 9 * stride},
+        };
+        i64 local_count = 0;
+        for (u32 const index: draw_order) {
+            Transform const* transform = nullptr;
+            if (index < transform_count && transform_entities[index] == static_mesh_entities[index]) {
+                transform = transforms + index;
+            } else {
+                transform = snapshot.try_get_component<Transform>(static_mesh_entities[index]);
+            }
+
+            if (!transform) {
+                continue;
+            }
+
+            World_Transform const* const world_transform = snapshot.try_get_component<World_Transform>(static_mesh_entities[index]);
+            draws.push_back(Draw_Instance{static_meshes[index], world_transform});
+            if (!world_transform) {
+                float* const local = components + local_count;
+                local[0] = transform->local_rotation.x;
+                local[stride] = transform->local_rotation.y;
+                local[2 * stride] = transform->local_rotation.z;
+                local[3 * stride] = transform->local_rotation.w;
+                local[4 * stride] = transform->local_position.x;
+                local[5 * stride] = transform->local_position.y;
+                local[6 * stride] = transform->local_position.z;
+                local[7 * stride] = transform->local_scale.x;
+                local[8 * stride] = transform->local_scale.y;
+                local[9 * stride] = transform->local_scale.z;
+                local_count += 1;
+            }
+        }
+
+        // Fill the matrices of all draws in one pass. When no draw has World_Transform,
+        // the batch conversion writes the matrices directly to the matrix buffer.
+        i64 const draw_count = draws.size();
+        u32 const draw_data_offset = reserve_matrices_and_materials(draw_count);
+        Matrix4* const matrices = matrix_buffer.buffer + draw_data_offset;
+        Material* const materials = material_buffer.buffer + draw_data_offset;
+        if (local_count == draw_count) {
+            math::transform::scale_rotate_translate(local_transforms, local_count, matrices);
+        } else {
+            local_matrices.resize(local_count);
+            math::transform::scale_rotate_translate(local_transforms, local_count, local_matrices.data());
+            for (i64 i = 0, local = 0; i < draw_count; ++i) {
+                if (draws[i].world_transform) {
+                    matrices[i] = draws[i].world_transform->matrix;
+                } else {
+                    matrices[i] = local_matrices[local];
+                    local += 1;
+                }
+            }
+        }
 
-        // snapshot.respect<Static_Mesh_Component, Transform>();
         bind_default_textures();
         bind_mesh_vao();
         bind_buffers();
         bind_transient_geometry_buffers();
-        auto objects = snapshot.view<Static_Mesh_Component, Transform>();
         Static_Mesh_Component last_mesh = {};
         Resource_Manager<Shader>& shader_manager = get_shader_manager();
         Resource_Manager<Material>& material_manager = get_material_manager();
@@ -597,8 +783,8 @@ namespace anton_engine::rendering {
         Draw_Elements_Command cmd = {};
         // TODO: wrap around, write_geometry functions, etc.
         // Fairly dumb rendering loop.
-        for (auto iter = objects.begin(), end = objects.end(); iter != end; ++iter) {
-            auto const [transform, static_mesh] = objects.get<Transform, Static_Mesh_Component>(*iter);
+        for (Draw_Instance const& draw: draws) {
+            Static_Mesh_Component const& static_mesh = draw.static_mesh;
             if (static_mesh.shader_handle != last_mesh.shader_handle || static_mesh.mesh_handle != last_mesh.mesh_handle ||
                 static_mesh.material_handle != last_mesh.material_handle) {
                 if (ANTON_LIKELY(current_draw != 0)) {
@@ -615,9 +801,12 @@ namespace anton_engine::rendering {
                 }
                 Shader& shader = shader_manager.get(static_mesh.shader_handle);
                 shader.use();
-                shader.set_vec3("camera.position", camera_transform.local_position);
-                shader.set_matrix4("projection", projection);
-                shader.set_matrix4("view", view);
+                static Name const camera_position_uniform = "camera.position"_name;
+                static Name const projection_uniform = "projection"_name;
+                static Name const view_uniform = "view"_name;
+                shader.set_vec3(camera_position_uniform, camera_transform.local_position);
+                shader.set_matrix4(projection_uniform, projection);
+                shader.set_matrix4(view_uniform, view);
             }
 
             if (static_mesh.mesh_handle != last_mesh.mesh_handle) {
@@ -633,12 +822,12 @@ namespace anton_engine::rendering {
                 //
                 // Skip first texture slot since it should always have the default textures bound
                 Material const mat = material_manager.get(static_mesh.material_handle);
-                Material materials[1] = {mat};
-                materials[0].diffuse_texture.index = find_slot_and_bind_texture(bound_textures, mat.diffuse_texture, current_draw);
-                materials[0].specular_texture.index = find_slot_and_bind_texture(bound_textures, mat.specular_texture, current_draw);
-                materials[0].normal_map.index = find_slot_and_bind_texture(bound_textures, mat.normal_map, current_draw);
-                Matrix4 const matrices[1] = {to_matrix(transform)};
-                [[maybe_unused]] u32 const base_instance = write_matrices_and_materials(matrices, materials);
+                Material& material = materials[current_draw];
+                material = mat;
+                material.diffuse_texture.index = find_slot_and_bind_texture(bound_textures, mat.diffuse_texture, current_draw);
+                material.specular_texture.index = find_slot_and_bind_texture(bound_textures, mat.specular_texture, current_draw);
+                material.normal_map.index = find_slot_and_bind_texture(bound_textures, mat.normal_map, current_draw);
+                u32 const base_instance = draw_data_offset + current_draw;
                 if (static_mesh.shader_handle != last_mesh.shader_handle || static_mesh.mesh_handle != last_mesh.mesh_handle ||
                     static_mesh.material_handle != last_mesh.material_handle) {
                     cmd.base_instance = base_instance;
@@ -706,7 +895,7 @@ namespace anton_engine::rendering {
         glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         ECS& ecs = get_ecs();
-        ECS snapshot = ecs.snapshot<Transform, Static_Mesh_Component>();
+        ECS snapshot = ecs.snapshot<Transform, Static_Mesh_Component>(Snapshot_Mode::shared);
         render_scene(snapshot, camera_transform, view_mat, projection_mat);
 
         // Postprocessing
@@ -719,10 +908,14 @@ namespace anton_engine::rendering {
 
         Shader& deferred_shading = get_builtin_shader(Builtin_Shader::deferred_shading);
         deferred_shading.use();
-        deferred_shading.set_vec3("camera.position", camera_transform.local_position);
-        deferred_shading.set_vec2("viewport_size", viewport_size);
-        deferred_shading.set_matrix4("inv_view_mat", to_matrix(camera_transform));
-        deferred_shading.set_matrix4("inv_proj_mat", math::inverse(projection_mat));
+        static Name const camera_position_uniform = "camera.position"_name;
+        static Name const viewport_size_uniform = "viewport_size"_name;
+        static Name const inv_view_mat_uniform = "inv_view_mat"_name;
+        static Name const inv_proj_mat_uniform = "inv_proj_mat"_name;
+        deferred_shading.set_vec3(camera_position_uniform, camera_transform.local_position);
+        deferred_shading.set_vec2(viewport_size_uniform, viewport_size);
+        deferred_shading.set_matrix4(inv_view_mat_uniform, to_matrix(camera_transform));
+        deferred_shading.set_matrix4(inv_proj_mat_uniform, math::inverse(projection_mat));
         render_texture_quad();
         glEnable(GL_DEPTH_TEST);
         swap_postprocess_buffers();
@@ -35,19 +35,22 @@ namespace anton_engine {
     }
 
     void Debug_Hotkeys::update(Debug_Hotkeys& debug_hotkeys) {
-        auto reload = input::get_action("reload_shaders");
+        static Name const reload_shaders_action = "reload_shaders"_name;
+        static Name const swap_fxaa_shaders_action = "swap_fxaa_shaders"_name;
+        auto reload = input::get_action(reload_shaders_action);
         if (reload.released) {
             // TODO reloading shaders
             //Engine::get_shader_manager().reload_shaders();
         }
 
-        auto swap_fxaa = input::get_action("swap_fxaa_shaders");
+        auto swap_fxaa = input::get_action(swap_fxaa_shaders_action);
         if (swap_fxaa.released) {
             swap_fxaa_shader();
         }
 
 #if !ANTON_WITH_EDITOR
-        auto capture_mouse = input::get_action("capture_mouse");
+        static Name const capture_mouse_action = "capture_mouse"_name;
+        auto capture_mouse = input::get_action(capture_mouse_action);
         if (capture_mouse.released) {
             // if (debug_hotkeys.cursor_captured) {
             //     debug_hotkeys.cursor_captured = false;
@@ -41,7 +41,7 @@ namespace anton_engine {
         glAttachShader(program, shader.shader);
     }
 
-    static void build_shader_uniform_cache(u32 program, atl::Flat_Hash_Map<u64, i32>& uniform_cache) {
+    static void build_shader_uniform_cache(u32 program, atl::Flat_Hash_Map<Name, i32>& uniform_cache) {
         i32 active_uniforms;
         glGetProgramInterfaceiv(program, GL_UNIFORM, GL_ACTIVE_RESOURCES, &active_uniforms);
         // glGetProgramInterfaceiv outputs the max name length including null-terminator.
@@ -54,7 +54,7 @@ namespace anton_engine {
             glGetActiveUniformName(program, static_cast<u32>(uniform_index), uniform_max_name_length, &name_length, &name[0]);
             i32 const location = glGetUniformLocation(program, &name[0]);
             atl::String_View const name_str = atl::String_View(&name[0], name_length);
-            uniform_cache.emplace(atl::hash(name_str), location);
+            uniform_cache.emplace(Name(name_str), location);
         }
     }
 
@@ -81,65 +81,57 @@ namespace anton_engine {
         glDetachShader(program, shader.shader);
     }
 
-    void Shader::set_int(atl::String_View const name, i32 const a) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_int(Name const name, i32 const a) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform1i(iter->value, a);
         }
     }
 
-    void Shader::set_uint(atl::String_View const name, u32 const a) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_uint(Name const name, u32 const a) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform1ui(iter->value, a);
         }
     }
 
-    void Shader::set_float(atl::String_View const name, float const a) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_float(Name const name, float const a) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform1f(iter->value, a);
         }
     }
 
-    void Shader::set_vec2(atl::String_View const name, Vector2 const vec) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_vec2(Name const name, Vector2 const vec) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform2fv(iter->value, 1, &vec.x);
         }
     }
 
-    void Shader::set_vec3(atl::String_View const name, Vector3 const vec) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_vec3(Name const name, Vector3 const vec) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform3fv(iter->value, 1, &vec.x);
         }
     }
 
-    void Shader::set_vec3(atl::String_View const name, Color const c) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_vec3(Name const name, Color const c) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform3fv(iter->value, 1, &c.r);
         }
     }
 
-    void Shader::set_vec4(atl::String_View const name, Color const c) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_vec4(Name const name, Color const c) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniform4fv(iter->value, 1, &c.r);
         }
     }
 
-    void Shader::set_matrix4(atl::String_View const name, Matrix4 const& mat) {
-        u64 const h = atl::hash(name);
-        auto iter = uniform_cache.find(h);
+    void Shader::set_matrix4(Name const name, Matrix4 const& mat) {
+        auto iter = uniform_cache.find(name);
         if (iter != uniform_cache.end()) {
             glUniformMatrix4fv(iter->value, 1, GL_FALSE, mat.get_raw());
         }
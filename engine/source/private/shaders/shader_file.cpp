@@ -17,7 +17,9 @@ namespace anton_engine {
             log.append(u8"Shader compilation failed (");
             log.append(name);
             log.append(")\n");
+            // glGetShaderInfoLog outputs the number of characters written not including null-terminator.
             glGetShaderInfoLog(shader, log_length, &log_length, log.data() + log.size_bytes());
+            log.force_size(log.size_bytes() + log_length);
             throw Shader_Compilation_Failed(log);
         }
     }
@@ -47,6 +47,33 @@
 #    define GE_BUILD_SHIPPING GE_BUILD_SHIPPING_DEBUG || GE_BUILD_SHIPPING_RELEASE
 #endif
 
+// Entity component system
+
+// Store components in archetype chunks instead of per-component sparse sets (see Storage_Mode).
+#ifndef ANTON_ECS_ARCHETYPE_STORAGE
+#    define ANTON_ECS_ARCHETYPE_STORAGE 0
+#endif
+
+// Verify that no components are added or removed while parallel_each iterates them.
+#ifndef ANTON_ECS_ITERATION_DEBUG
+#    define ANTON_ECS_ITERATION_DEBUG ANTON_DEBUG
+#endif
+
+// Verify that systems which declare their component access (see System) access only the declared components
+// and modify only those declared with writes.
+#ifndef ANTON_ECS_ACCESS_DEBUG
+#    define ANTON_ECS_ACCESS_DEBUG ANTON_DEBUG
+#endif
+
+// Math library
+
+// Implement the Matrix4, Vector4 * Matrix4 and Quaternion products and Matrix4 inverse with SSE.
+// Ignored on targets without SSE2. The batched math::transform::scale_rotate_translate uses SSE
+// on every target with SSE2 regardless of this flag. See core/math/simd.hpp for the tolerances.
+#ifndef ANTON_MATH_SIMD
+#    define ANTON_MATH_SIMD 0
+#endif
+
 // atl library
 
 #ifndef ANTON_STRING_VIEW_VERIFY_ENCODING
@@ -65,6 +92,11 @@
 #    define ANTON_BOUNDS_CHECKING 0
 #endif
 
+// Fill the memory released by Frame_Allocator with 0xCD.
+#ifndef ANTON_FRAME_ALLOCATOR_POISON
+#    define ANTON_FRAME_ALLOCATOR_POISON ANTON_DEBUG
+#endif
+
 // Unicode library
 
 #ifndef ANTON_UNICODE_VALIDATE_ENCODING
@@ -24,11 +24,12 @@ extern "C" {
     ANTON_CRT_IMPORT float tanf(float);
 
     // string.h
-    // memset, memmove, memcpy, strlen don't use dllimport on win.
+    // memset, memmove, memcpy, memcmp, strlen don't use dllimport on win.
     
     void* memset(void* dest, int value, unsigned long long count);
     void* memcpy(void* dest, void const* src, unsigned long long count);
     void* memmove(void* dest, void const* src, unsigned long long count);
+    int memcmp(void const* lhs, void const* rhs, unsigned long long count);
 
     unsigned long long strlen(char const* string);
 
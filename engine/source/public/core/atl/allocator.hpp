@@ -3,6 +3,7 @@
 
 #include <core/types.hpp>
 #include <core/atl/aligned_buffer.hpp>
+#include <core/atl/type_traits.hpp>
 #include <core/diagnostic_macros.hpp>
 
 namespace anton_engine::atl {
@@ -55,6 +56,121 @@ namespace anton_engine::atl {
         return false; // All Allocators are stateless and may always be considered equal.
     }
 
+    // Frame_Allocator
+    // Linear allocator for temporaries that do not outlive the current frame.
+    // Every thread bumps a pointer through blocks of its own, therefore allocating does not require
+    // any synchronization except for the first allocation of a thread, which registers the thread.
+    // When a block is exhausted, allocation continues in the next block, which is obtained from
+    // the default allocator if the thread has no spare block. Allocations larger than block_size get a block of their own.
+    // deallocate reclaims the memory only if it is the most recent allocation of the calling thread.
+    // reset releases the memory of all threads at once and keeps the blocks for reuse. It must not be called
+    // while any thread uses the memory.
+    // With ANTON_FRAME_ALLOCATOR_POISON the released memory is filled with 0xCD to expose dangling pointers.
+    //
+    class Frame_Allocator: public Memory_Allocator {
+    public:
+        explicit Frame_Allocator(isize block_size = 1048576);
+        Frame_Allocator(Frame_Allocator const&) = delete;
+        Frame_Allocator& operator=(Frame_Allocator const&) = delete;
+        ~Frame_Allocator() override;
+
+        [[nodiscard]] ANTON_DECLSPEC_ALLOCATOR void* allocate(isize size, isize alignment) override;
+        void deallocate(void*, isize size, isize alignment) override;
+        [[nodiscard]] bool is_equal(Memory_Allocator const& other) const override;
+
+        void reset();
+
+    private:
+        struct Block;
+        struct Thread_Arena;
+        struct Arenas;
+
+        Arenas* arenas;
+        isize block_size;
+        // Identifies the allocator in the per-thread cache of arenas. Unlike the address it is never reused.
+        u64 id;
+
+        [[nodiscard]] Thread_Arena& get_thread_arena();
+    };
+
+    // get_frame_allocator
+    // Returns: Frame_Allocator that is reset at the end of every frame.
+    //
+    [[nodiscard]] Frame_Allocator& get_frame_allocator();
+
+    // Pool_Allocator
+    // Allocates blocks of a single size from chunks of blocks_per_chunk blocks in constant time.
+    // The free blocks form an intrusive list, hence block_size is rounded up to at least the size of a pointer.
+    // Chunks are obtained from the default allocator when the pool runs out of free blocks and are
+    // released only when the pool is destroyed.
+    // Requests larger than block_size or with stricter alignment than block_alignment are invalid.
+    // Not thread-safe.
+    //
+    class Pool_Allocator: public Memory_Allocator {
+    public:
+        Pool_Allocator(isize block_size, isize block_alignment, isize blocks_per_chunk = 64);
+        Pool_Allocator(Pool_Allocator const&) = delete;
+        Pool_Allocator& operator=(Pool_Allocator const&) = delete;
+        ~Pool_Allocator() override;
+
+        [[nodiscard]] ANTON_DECLSPEC_ALLOCATOR void* allocate(isize size, isize alignment) override;
+        void deallocate(void*, isize size, isize alignment) override;
+        [[nodiscard]] bool is_equal(Memory_Allocator const& other) const override;
+
+    private:
+        struct Free_Block;
+
+        Free_Block* free_blocks = nullptr;
+        // Chunks are linked through their first pointer-sized bytes.
+        void* chunks = nullptr;
+        isize block_size;
+        isize block_alignment;
+        isize blocks_per_chunk;
+        // Offset of the first block within a chunk.
+        isize chunk_header_size;
+    };
+
+    // TLSF_Allocator
+    // Two-Level Segregated Fit allocator, a general purpose allocator with constant time allocate and deallocate.
+    // The free blocks are segregated into lists by power of two size classes (first level), each of which is
+    // split into tlsf_second_level_count linear subclasses (second level). Bitmaps of the non-empty lists let
+    // allocate find a fitting block with two bit scans instead of a search. Adjacent free blocks are
+    // coalesced on deallocate.
+    // The whole range of capacity bytes is obtained from the default allocator up front and never grows.
+    // Running out of memory is fatal.
+    // Not thread-safe.
+    //
+    class TLSF_Allocator: public Memory_Allocator {
+    public:
+        static constexpr i64 tlsf_second_level_count_log2 = 4;
+        static constexpr i64 tlsf_second_level_count = 1 << tlsf_second_level_count_log2;
+        static constexpr i64 tlsf_first_level_count = 32;
+
+        explicit TLSF_Allocator(isize capacity);
+        TLSF_Allocator(TLSF_Allocator const&) = delete;
+        TLSF_Allocator& operator=(TLSF_Allocator const&) = delete;
+        ~TLSF_Allocator() override;
+
+        [[nodiscard]] ANTON_DECLSPEC_ALLOCATOR void* allocate(isize size, isize alignment) override;
+        void deallocate(void*, isize size, isize alignment) override;
+        [[nodiscard]] bool is_equal(Memory_Allocator const& other) const override;
+
+    private:
+        struct Block;
+
+        char* memory;
+        isize capacity;
+        u32 first_level_bitmap = 0;
+        u32 second_level_bitmaps[tlsf_first_level_count] = {};
+        Block* free_lists[tlsf_first_level_count][tlsf_second_level_count] = {};
+
+        void insert_free_block(Block* block);
+        void remove_free_block(Block* block);
+        [[nodiscard]] Block* find_free_block(isize size);
+        // Splits the tail off block if it is large enough to form a block and returns it to the free lists.
+        void trim_free_tail(Block* block, isize size);
+    };
+
     // // Buffer_Allocator
     // class Buffer_Allocator: public Memory_Allocator {
     // private:
@@ -142,6 +258,12 @@ namespace anton_engine::atl {
 
     [[nodiscard]] bool operator==(Polymorphic_Allocator const&, Polymorphic_Allocator const&);
     [[nodiscard]] bool operator!=(Polymorphic_Allocator const&, Polymorphic_Allocator const&);
+
+    template <>
+    struct Is_Trivially_Relocatable<Allocator>: True_Type {};
+
+    template <>
+    struct Is_Trivially_Relocatable<Polymorphic_Allocator>: True_Type {};
 } // namespace anton_engine::atl
 
 #endif // !CORE_ATL_ALLOCATOR_HPP_INCLUDE
@@ -3,7 +3,7 @@
 
 #include <core/types.hpp>
 #include <core/atl/type_traits.hpp>
-#include <core/hashing/murmurhash2.hpp>
+#include <core/hashing/wyhash.hpp>
 
 namespace anton_engine::atl {
     namespace detail {
@@ -22,17 +22,20 @@ namespace anton_engine::atl {
     }
 
     // Default_Hash
+    // Mixes the bits of the value, so hash tables may use any subset of the bits of the hash.
     // TODO: long double, nullptr, separate enum, int128 specializations
     //
     template<typename T>
     struct Default_Hash: detail::Conditionally_Enabled_Hash<!is_const<T> && (is_enum<T> || is_integral<T> || is_floating_point<T> || is_pointer<T>)> {
-        u64 operator()(T const& v) {
+        u64 operator()(T const& v) const {
+            // Types smaller than u64 do not overwrite all bytes of the union.
             union {
                 T _t;
                 u64 _v;
             } _u;
+            _u._v = 0;
             _u._t = v;
-            return _u._v;
+            return wyhash_u64(_u._v);
         }
     };
 
@@ -40,7 +43,7 @@ namespace anton_engine::atl {
     //
     template<typename T>
     struct Equal_Compare {
-        bool operator()(T const& lhs, T const& rhs) {
+        bool operator()(T const& lhs, T const& rhs) const {
             return lhs == rhs;
         }
     };
@@ -498,6 +498,16 @@ namespace anton_engine::atl {
     constexpr bool is_trivially_destructible = Is_Trivially_Destructible<T>::value;
 #endif // ANTON_COMPILER_CLANG || ANTON_COMPILER_MSVC
 
+    // Is_Trivially_Relocatable
+    // Whether moving an object to another address and destroying the original may be replaced with memcpy.
+    // Types that do not store pointers to themselves may specialize it to opt in.
+    //
+    template <typename T>
+    struct Is_Trivially_Relocatable: Bool_Constant<Is_Trivially_Move_Constructible<T>::value && Is_Trivially_Destructible<T>::value> {};
+
+    template <typename T>
+    constexpr bool is_trivially_relocatable = Is_Trivially_Relocatable<T>::value;
+
     namespace detail {
         template <typename T>
         struct Is_Integral: False_Type {};
@@ -2,37 +2,148 @@
 #define CORE_ATL_FLAT_HASH_MAP_HPP_INCLUDE
 
 #include <core/types.hpp>
+#include <core/anton_crt.hpp>
 #include <core/atl/memory.hpp>
 #include <core/atl/allocator.hpp>
 #include <core/atl/detail/functors.hpp>
 #include <core/atl/tags.hpp>
+#include <core/atl/type_traits.hpp>
+#include <core/atl/utility.hpp>
 #include <core/assert.hpp>
+#include <core/math/math.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define ANTON_FLAT_HASH_MAP_SSE2 1
+#    include <emmintrin.h>
+#else
+#    define ANTON_FLAT_HASH_MAP_SSE2 0
+#endif
 
 namespace anton_engine::atl {
-    // Stores both keys and values in the main array, which minimizes memory indirections.
+    namespace detail {
+        // Every slot of Flat_Hash_Map has a control byte. The control bytes of the full slots
+        // store the low 7 bits of the hash of the key. The special values have the sign bit set.
+        constexpr i8 control_empty = -128;
+        constexpr i8 control_deleted = -2;
+        constexpr i8 control_sentinel = -1;
+        // Number of the control bytes that are matched at once.
+        constexpr i64 group_width = 16;
+
+        [[nodiscard]] inline i64 group_trailing_zeros(u32 const v) {
+#if defined(__clang__) || defined(__GNUC__)
+            return __builtin_ctz(v);
+#else
+            return static_cast<i64>(math::popcount((v & (~v + 1)) - 1));
+#endif
+        }
+
+        // Counts the leading zeros of the 16 bit mask.
+        [[nodiscard]] inline i64 group_leading_zeros(u32 const v) {
+#if defined(__clang__) || defined(__GNUC__)
+            return __builtin_clz(v) - 16;
+#else
+            return static_cast<i64>(math::clz(v)) - 16;
+#endif
+        }
+
+        // Flat_Hash_Map_Group
+        // Matches group_width consecutive control bytes at once.
+        // The results are masks with bit i set when the i-th control byte matches.
+        //
+        class Flat_Hash_Map_Group {
+        public:
+#if ANTON_FLAT_HASH_MAP_SSE2
+            explicit Flat_Hash_Map_Group(i8 const* const control): _control(_mm_loadu_si128(reinterpret_cast<__m128i const*>(control))) {}
+
+            [[nodiscard]] u32 match(i8 const h2) const {
+                return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), _control)));
+            }
+
+            [[nodiscard]] u32 match_empty() const {
+                return static_cast<u32>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(control_empty), _control)));
+            }
+
+            [[nodiscard]] u32 match_empty_or_deleted() const {
+                // empty and deleted are the only values less than sentinel.
+                return static_cast<u32>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(control_sentinel), _control)));
+            }
+#else
+            explicit Flat_Hash_Map_Group(i8 const* const control) {
+                memcpy(_control, control, group_width);
+            }
+
+            [[nodiscard]] u32 match(i8 const h2) const {
+                u32 mask = 0;
+                for (i64 i = 0; i < group_width; ++i) {
+                    mask |= static_cast<u32>(_control[i] == h2) << i;
+                }
+                return mask;
+            }
+
+            [[nodiscard]] u32 match_empty() const {
+                return match(control_empty);
+            }
+
+            [[nodiscard]] u32 match_empty_or_deleted() const {
+                u32 mask = 0;
+                for (i64 i = 0; i < group_width; ++i) {
+                    mask |= static_cast<u32>(_control[i] < control_sentinel) << i;
+                }
+                return mask;
+            }
+#endif
+
+            // Returns: The number of consecutive empty or deleted control bytes at the beginning of the group.
+            [[nodiscard]] i64 count_leading_empty_or_deleted() const {
+                return group_trailing_zeros(match_empty_or_deleted() + 1);
+            }
+
+        private:
+#if ANTON_FLAT_HASH_MAP_SSE2
+            __m128i _control;
+#else
+            i8 _control[group_width];
+#endif
+        };
+
+        template<typename T, typename = void>
+        struct Is_Transparent: False_Type {};
+
+        template<typename T>
+        struct Is_Transparent<T, void_trait<typename T::is_transparent>>: True_Type {};
+    } // namespace detail
+
+    // Open addressing hash map that stores both keys and values in the main array, which minimizes memory indirections.
+    // Every slot has a control byte holding 7 bits of the hash of the key, which are compared 16 at a time
+    // so that the keys are compared only on probable matches (Swiss table).
     // It doesn't provide pointer stability and moves data on rehashing.
-    // TODO: Implement state sentinel for iterators.
+    // Hash must spread the entropy of the keys over all bits of the hash, since both the low and the high bits are used.
+    //
+    // If both Hash and Key_Equal define is_transparent, find accepts any type they accept,
+    // e.g. String_View for a map with String keys.
+    //
     // TODO: Add launder.
     //
     template<typename Key, typename Value, typename Hash = Default_Hash<Key>, typename Key_Equal = Equal_Compare<Key>>
     class Flat_Hash_Map {
     private:
-        enum class State: u8;
         class Slot;
 
+        template<typename K>
+        using enable_if_transparent = enable_if<detail::Is_Transparent<Hash>::value && detail::Is_Transparent<Key_Equal>::value, K>;
+
     public:
         class Entry {
         public:
             Key const key;
             Value value;
         };
-        
+
         using value_type = Entry;
         using allocator_type = Polymorphic_Allocator;
         using hasher = Hash;
         using key_equal = Key_Equal;
 
-
         class iterator {
         public:
             using value_type = Entry;
@@ -47,12 +158,9 @@ namespace anton_engine::atl {
             iterator& operator=(iterator&&) = default;
 
             iterator& operator++() {
+                _control += 1;
                 _slots += 1;
-                _states += 1;
-                while(*_states == State::empty || *_states == State::deleted) {
-                    _slots += 1;
-                    _states += 1;
-                }
+                skip_empty_or_deleted();
                 return *this;
             }
 
@@ -63,12 +171,11 @@ namespace anton_engine::atl {
             }
 
             iterator& operator--() {
-                _slots -= 1;
-                _states -= 1;
-                while(*_states == State::empty || *_states == State::deleted) {
+                // The control byte before the first slot is a sentinel.
+                do {
+                    _control -= 1;
                     _slots -= 1;
-                    _states -= 1;
-                }
+                } while(*_control < detail::control_sentinel);
                 return *this;
             }
 
@@ -80,33 +187,42 @@ namespace anton_engine::atl {
 
             [[nodiscard]] value_type* operator->() const {
                 if constexpr(ANTON_ITERATOR_DEBUG) {
-                    ANTON_FAIL(*_states == State::active, "Dereferencing invalid Flat_Hash_Map pointer.");
+                    ANTON_FAIL(*_control >= 0, "Dereferencing invalid Flat_Hash_Map iterator.");
                 }
                 return reinterpret_cast<value_type*>(_slots);
             }
 
             [[nodiscard]] value_type& operator*() const {
                 if constexpr(ANTON_ITERATOR_DEBUG) {
-                    ANTON_FAIL(*_states == State::active, "Dereferencing invalid Flat_Hash_Map pointer.");
+                    ANTON_FAIL(*_control >= 0, "Dereferencing invalid Flat_Hash_Map iterator.");
                 }
                 return *reinterpret_cast<value_type*>(_slots);
             }
 
             [[nodiscard]] bool operator==(iterator const& b) const {
-                return _slots == b._slots;
+                return _control == b._control;
             }
 
             [[nodiscard]] bool operator!=(iterator const& b) const {
-                return _slots != b._slots;
+                return _control != b._control;
             }
 
         private:
             friend Flat_Hash_Map;
 
+            i8 const* _control;
             Slot* _slots;
-            State* _states;
 
-            iterator(Slot* slots, State* states): _slots(slots), _states(states) {}
+            iterator(i8 const* control, Slot* slots): _control(control), _slots(slots) {}
+
+            // Advances to the next full slot or the sentinel after the last slot.
+            void skip_empty_or_deleted() {
+                while(*_control < detail::control_sentinel) {
+                    i64 const shift = detail::Flat_Hash_Map_Group(_control).count_leading_empty_or_deleted();
+                    _control += shift;
+                    _slots += shift;
+                }
+            }
         };
 
         class const_iterator {
@@ -118,65 +234,75 @@ namespace anton_engine::atl {
             const_iterator() = delete;
             const_iterator(const_iterator const&) = default;
             const_iterator(const_iterator&&) = default;
+            const_iterator(iterator const& iter): _control(iter._control), _slots(iter._slots) {}
             ~const_iterator() = default;
             const_iterator& operator=(const_iterator const&) = default;
             const_iterator& operator=(const_iterator&&) = default;
 
-            iterator& operator++() {
+            const_iterator& operator++() {
+                _control += 1;
                 _slots += 1;
-                _states += 1;
-                while(*_states == State::empty || *_states == State::deleted) {
-                    _slots += 1;
-                    _states += 1;
-                }
+                skip_empty_or_deleted();
                 return *this;
             }
 
-            iterator operator++(int) {
-                iterator iter = *this;
+            const_iterator operator++(int) {
+                const_iterator iter = *this;
                 ++(*this);
                 return iter;
             }
 
-            iterator& operator--() {
-                _slots -= 1;
-                _states -= 1;
-                while(*_states == State::empty || *_states == State::deleted) {
+            const_iterator& operator--() {
+                do {
+                    _control -= 1;
                     _slots -= 1;
-                    _states -= 1;
-                }
+                } while(*_control < detail::control_sentinel);
                 return *this;
             }
 
-            iterator operator--(int) {
-                iterator iter = *this;
+            const_iterator operator--(int) {
+                const_iterator iter = *this;
                 --(*this);
                 return iter;
             }
 
             [[nodiscard]] value_type* operator->() const {
+                if constexpr(ANTON_ITERATOR_DEBUG) {
+                    ANTON_FAIL(*_control >= 0, "Dereferencing invalid Flat_Hash_Map iterator.");
+                }
                 return reinterpret_cast<value_type*>(_slots);
             }
 
             [[nodiscard]] value_type& operator*() const {
+                if constexpr(ANTON_ITERATOR_DEBUG) {
+                    ANTON_FAIL(*_control >= 0, "Dereferencing invalid Flat_Hash_Map iterator.");
+                }
                 return *reinterpret_cast<value_type*>(_slots);
             }
 
-            [[nodiscard]] bool operator==(iterator const& b) const {
-                return _slots == b._slots;
+            [[nodiscard]] bool operator==(const_iterator const& b) const {
+                return _control == b._control;
             }
 
-            [[nodiscard]] bool operator!=(iterator const& b) const {
-                return _slots != b._slots;
+            [[nodiscard]] bool operator!=(const_iterator const& b) const {
+                return _control != b._control;
             }
 
         private:
             friend Flat_Hash_Map;
 
+            i8 const* _control;
             Slot const* _slots;
-            State const* _states;
 
-            const_iterator(Slot const* slots, State const* states): _slots(slots), _states(states) {}
+            const_iterator(i8 const* control, Slot const* slots): _control(control), _slots(slots) {}
+
+            void skip_empty_or_deleted() {
+                while(*_control < detail::control_sentinel) {
+                    i64 const shift = detail::Flat_Hash_Map_Group(_control).count_leading_empty_or_deleted();
+                    _control += shift;
+                    _slots += shift;
+                }
+            }
         };
 
         Flat_Hash_Map(allocator_type const& = allocator_type(), hasher const& = hasher(), key_equal const& = key_equal());
@@ -197,6 +323,12 @@ namespace anton_engine::atl {
 
         iterator find(Key const&);
         const_iterator find(Key const&) const;
+        // Heterogeneous lookup. Finds the entry without constructing a Key.
+        template<typename K, typename = enable_if_transparent<K>>
+        iterator find(K const&);
+        template<typename K, typename = enable_if_transparent<K>>
+        const_iterator find(K const&) const;
+
         // Finds the entry with given key or default constructs one if it doesn't exist
         iterator find_or_emplace(Key const&);
 
@@ -206,6 +338,14 @@ namespace anton_engine::atl {
         template<typename... Args>
         iterator emplace(Key&&, Args&&...);
 
+        // Invalidates only the iterators to the erased entry.
+        void erase(const_iterator position);
+        // Returns: true if an entry with the key existed and has been erased.
+        bool erase(Key const&);
+        // Erases all entries, but does not release the memory.
+        void clear();
+
+        // Allocates enough slots to hold c entries without rehashing.
         void ensure_capacity(i64 c);
 
         [[nodiscard]] i64 capacity() const;
@@ -217,18 +357,11 @@ namespace anton_engine::atl {
         [[nodiscard]] f32 max_load_factor() const;
 
     private:
-        enum class State: u8 {
-            empty = 0,
-            active,
-            deleted,
-            sentinel,
-        };
-
         class Slot {
         public:
             Key key;
             Value value;
-            
+
             template<typename K, typename... Args>
             Slot(K&& k, Args&&... args): key(atl::forward<K>(k)), value(atl::forward<Args>(args)...) {}
             Slot(Slot&& slot): key(atl::move(slot.key)), value(atl::move(slot.value)) {}
@@ -242,245 +375,269 @@ namespace anton_engine::atl {
         allocator_type _allocator;
         hasher _hasher;
         key_equal _key_equal;
-        State* _states = nullptr;
+        // The control bytes and the slots share a single allocation. _control[-1] and _control[_capacity]
+        // are sentinels, which stop the iterators, and are followed by the clones of the first
+        // group_width - 1 control bytes so that the groups at the end of the table wrap around.
+        i8* _control;
         Slot* _slots = nullptr;
+        // 0 or a power of 2 minus 1, which is also the mask of the slot indices.
         i64 _capacity = 0;
         i64 _size = 0;
-
-        static State* empty_initial_states();
-        i64 find_non_active(u64 hash, i64 capacity, State* states);
+        // Number of the empty slots that may be filled before the map has to rehash.
+        i64 _growth_left = 0;
+
+        static i8* empty_control();
+        static i64 max_growth(i64 capacity);
+        static i64 allocation_size(i64 capacity);
+        static i64 slots_offset(i64 capacity);
+        static i64 allocation_alignment();
+
+        template<typename K>
+        u64 hash_key(K const& key) const;
+        template<typename K>
+        i64 find_index(K const& key) const;
+        i64 find_insert_index(u64 h) const;
+        i64 prepare_insert(u64 h);
+        void finish_insert(i64 index, u64 h);
+        void set_control(i64 index, i8 value);
+        void resize(i64 new_capacity);
+        void destroy_slots();
+        void deallocate();
     };
 } // namespace anton_engine::atl
 
 namespace anton_engine::atl {
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     Flat_Hash_Map<Key, Value, Hash, Key_Compare>::Flat_Hash_Map(allocator_type const& alloc, hasher const& h, key_equal const& eq)
-        : _allocator(alloc), _hasher(h), _key_equal(eq), _states(empty_initial_states()) {}
+        : _allocator(alloc), _hasher(h), _key_equal(eq), _control(empty_control()) {}
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     Flat_Hash_Map<Key, Value, Hash, Key_Compare>::Flat_Hash_Map(Reserve_Tag, i64 size, allocator_type const& alloc, hasher const& h, key_equal const& eq)
-        : _allocator(alloc), _hasher(h), _key_equal(eq) {
+        : _allocator(alloc), _hasher(h), _key_equal(eq), _control(empty_control()) {
         ensure_capacity(size);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     Flat_Hash_Map<Key, Value, Hash, Key_Compare>::Flat_Hash_Map(Flat_Hash_Map const& other, allocator_type const& alloc)
-        : _allocator(alloc), _hasher(other._hasher), _key_equal(other._key_equal), _capacity(other._capacity), _size(other._size) {
-        if(_capacity) {
-            _states = (State*)_allocator.allocate((_capacity + 16 + 1) * sizeof(State), 16);
-            memcpy(_states, other._states - 16, (_capacity + 16 + 1) * sizeof(State));
-            _states += 16;
-            _slots = (Slot*)_allocator.allocate(_capacity * sizeof(Slot), alignof(Slot));
-            for(i64 i = 0; i < _capacity; ++i) {
-                if(_states[i] == State::active) {
-                    new (_slots + i) Slot(other._slots[i].key, other._slots[i].value);
-                }
-            }
-        } else {
-            _states = empty_initial_states();
-        }
+        : _allocator(alloc), _hasher(other._hasher), _key_equal(other._key_equal), _control(empty_control()) {
+        *this = other;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     Flat_Hash_Map<Key, Value, Hash, Key_Compare>::Flat_Hash_Map(Flat_Hash_Map&& other) noexcept
         : _allocator(atl::move(other._allocator)), _hasher(atl::move(other._hasher)), _key_equal(atl::move(other._key_equal)),
-          _states(other._states), _slots(other._slots), _capacity(other._capacity), _size(other._size) {
+          _control(other._control), _slots(other._slots), _capacity(other._capacity), _size(other._size), _growth_left(other._growth_left) {
+        other._control = empty_control();
         other._slots = nullptr;
-        other._states = nullptr;
         other._capacity = 0;
         other._size = 0;
+        other._growth_left = 0;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::operator=(Flat_Hash_Map const& other) -> Flat_Hash_Map& {
         // TODO: Should it copy the allocator, hasher or key_equal?
         // TODO: Assumes no exceptions.
-        // TODO: Turn off the fucking exceptions.
-        if(_capacity) {
-            _allocator.deallocate(_states - 16, (_capacity + 16 + 1) * sizeof(State), 16);
-            _allocator.deallocate(_slots, _capacity * sizeof(Slot), alignof(Slot));
+        if(this == &other) {
+            return *this;
         }
 
+        destroy_slots();
+        deallocate();
         if(other._capacity) {
-            _states = (State*)_allocator.allocate((_capacity + 16 + 1) * sizeof(State), 16);
-            memcpy(_states, other._states - 16, (_capacity + 16 + 1) * sizeof(State));
-            _slots = (Slot*)_allocator.allocate(_capacity * sizeof(Slot), alignof(Slot));
+            // The layout of the control bytes does not depend on the allocation, hence we copy them verbatim
+            // and construct the entries in the same slots.
+            _capacity = other._capacity;
+            void* const memory = _allocator.allocate(allocation_size(_capacity), allocation_alignment());
+            _control = static_cast<i8*>(memory) + 1;
+            _slots = reinterpret_cast<Slot*>(static_cast<char8*>(memory) + slots_offset(_capacity));
+            memcpy(_control - 1, other._control - 1, _capacity + detail::group_width + 1);
             for(i64 i = 0; i < _capacity; ++i) {
-                if(_states[i] == State::active) {
+                if(_control[i] >= 0) {
                     new (_slots + i) Slot(other._slots[i].key, other._slots[i].value);
                 }
             }
-        } else {
-            _states = empty_initial_states();
+            _size = other._size;
+            _growth_left = other._growth_left;
         }
         return *this;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::operator=(Flat_Hash_Map&& other) noexcept -> Flat_Hash_Map& {
+        atl::swap(_control, other._control);
         atl::swap(_slots, other._slots);
-        atl::swap(_states, other._states);
         atl::swap(_capacity, other._capacity);
         atl::swap(_size, other._size);
+        atl::swap(_growth_left, other._growth_left);
         atl::swap(_hasher, other._hasher);
         atl::swap(_allocator, other._allocator);
         atl::swap(_key_equal, other._key_equal);
-        return other;
+        return *this;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     Flat_Hash_Map<Key, Value, Hash, Key_Compare>::~Flat_Hash_Map() {
-        for(i64 i = 0; i < _capacity; ++i) {
-            if(_states[i] == State::active) {
-                _slots[i].~Slot();
-            }
-        }
-
-        if(_capacity) {
-            _allocator.deallocate(_states - 16, (_capacity + 16 + 1) * sizeof(State), 16);
-            _allocator.deallocate(_slots, _capacity * sizeof(Slot), alignof(Slot));
-        }
+        destroy_slots();
+        deallocate();
     }
 
-    template<typename Key, typename Value, typename Hash, typename Key_Compare>    
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::begin() -> iterator {
-        i64 offset = 0;
-        while(_states[offset] == State::empty || _states[offset] == State::deleted) {
-            offset += 1;
-        }
-        return iterator(_slots + offset, _states + offset);
+        iterator iter(_control, _slots);
+        iter.skip_empty_or_deleted();
+        return iter;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::begin() const -> const_iterator {
-        i64 offset = 0;
-        while(_states[offset] == State::empty || _states[offset] == State::deleted) {
-            offset += 1;
-        }
-        return const_iterator(_slots + offset, _states + offset);        
+        const_iterator iter(_control, _slots);
+        iter.skip_empty_or_deleted();
+        return iter;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::cbegin() -> const_iterator {
-        i64 offset = 0;
-        while(_states[offset] == State::empty || _states[offset] == State::deleted) {
-            offset += 1;
-        }
-        return const_iterator(_slots + offset, _states + offset);        
+        const_iterator iter(_control, _slots);
+        iter.skip_empty_or_deleted();
+        return iter;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::end() -> iterator {
-        return iterator(_slots + _capacity, _states + _capacity);        
+        return iterator(_control + _capacity, _slots + _capacity);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::end() const -> const_iterator {
-        return const_iterator(_slots + _capacity, _states + _capacity);        
+        return const_iterator(_control + _capacity, _slots + _capacity);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::cend() -> const_iterator {
-        return const_iterator(_slots + _capacity, _states + _capacity);        
+        return const_iterator(_control + _capacity, _slots + _capacity);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find(Key const& key) -> iterator {
-        if(_capacity) {
-            u64 const h = _hasher(key);
-            i64 index = h % _capacity;
-            while(true) {
-                State const state = _states[index];
-                if(state == State::active && _key_equal(key, _slots[index].key)) {
-                    return iterator(_slots + index, _states + index);
-                } else if(state != State::active) {
-                    return end();
-                }
-                index = (index + 1) % _capacity;
-            }
-        }
-        return end();
+        i64 const index = find_index(key);
+        return index != -1 ? iterator(_control + index, _slots + index) : end();
     }
-    
+
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find(Key const& key) const -> const_iterator {
-        if(_capacity) {
-            u64 const h = _hasher(key);
-            i64 index = h % _capacity;
-            while(true) {
-                State const state = _states[index];
-                if(state == State::active && _key_equal(key, _slots[index].key)) {
-                    return iterator(_slots + index, _states + index);
-                } else if(state != State::active) {
-                    return end();
-                }
-                index = (index + 1) % _capacity;
-            }
-        }
-        return end();
+        i64 const index = find_index(key);
+        return index != -1 ? const_iterator(_control + index, _slots + index) : end();
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    template<typename K, typename>
+    auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find(K const& key) -> iterator {
+        i64 const index = find_index(key);
+        return index != -1 ? iterator(_control + index, _slots + index) : end();
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    template<typename K, typename>
+    auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find(K const& key) const -> const_iterator {
+        i64 const index = find_index(key);
+        return index != -1 ? const_iterator(_control + index, _slots + index) : end();
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find_or_emplace(Key const& key) -> iterator {
-        ensure_capacity(_size + 1);
-        u64 const h = _hasher(key);
-        i64 index = h % _capacity;
-        while(true) {
-            State const state = _states[index];
-            if(state == State::active && _key_equal(key, _slots[index].key)) {
-                return iterator(_slots + index, _states + index);
-            } else if(state == State::empty) {
-                _states[index] = State::active;
-                new (_slots + index) Slot(key);
-                _size += 1;
-                return iterator(_slots + index, _states + index);
-            }
-            index = (index + 1) % _capacity;
+        i64 index = find_index(key);
+        if(index == -1) {
+            u64 const h = hash_key(key);
+            index = prepare_insert(h);
+            new (_slots + index) Slot(key);
+            finish_insert(index, h);
         }
+        return iterator(_control + index, _slots + index);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     template<typename... Args>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::emplace(Key const& key, Args&&... args) -> iterator {
-        ensure_capacity(_size + 1);
-        u64 const h = _hasher(key);
-        i64 index = h % _capacity;
-        while(true) {
-            State const state = _states[index];
-            if(state != State::active) {
-                _states[index] = State::active;
-                new (_slots + index) Slot(key, atl::forward<Args>(args)...);
-                _size += 1;
-                return iterator(_slots + index, _states + index);
-            } else {
-                if(_key_equal(key, _slots[index].key)) {
-                    return iterator(_slots + index, _states + index);
-                }
-                index = (index + 1) % _capacity;
-            }
+        i64 index = find_index(key);
+        if(index == -1) {
+            u64 const h = hash_key(key);
+            index = prepare_insert(h);
+            new (_slots + index) Slot(key, atl::forward<Args>(args)...);
+            finish_insert(index, h);
         }
+        return iterator(_control + index, _slots + index);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
     template<typename... Args>
     auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::emplace(Key&& key, Args&&... args) -> iterator {
-        ensure_capacity(_size + 1);
-        u64 const h = _hasher(key);
-        i64 index = h % _capacity;
-        while(true) {
-            State const state = _states[index];
-            if(state != State::active) {
-                _states[index] = State::active;
-                new (_slots + index) Slot(key, atl::forward<Args>(args)...);
-                _size += 1;
-                return iterator(_slots + index, _states + index);
-            } else {
-                if(_key_equal(key, _slots[index].key)) {
-                    return iterator(_slots + index, _states + index);
-                }
-                index = (index + 1) % _capacity;
-            }
+        i64 index = find_index(key);
+        if(index == -1) {
+            u64 const h = hash_key(key);
+            index = prepare_insert(h);
+            new (_slots + index) Slot(atl::move(key), atl::forward<Args>(args)...);
+            finish_insert(index, h);
+        }
+        return iterator(_control + index, _slots + index);
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::erase(const_iterator const position) {
+        i64 const index = position._control - _control;
+        if constexpr(ANTON_ITERATOR_DEBUG) {
+            ANTON_FAIL(index >= 0 && index < _capacity && _control[index] >= 0, "Erasing invalid Flat_Hash_Map iterator.");
+        }
+
+        _slots[index].~Slot();
+        _size -= 1;
+        // Lookups stop at the first group that has an empty slot. If the slot has never been a part of a full window
+        // of group_width consecutive slots, no probe sequence has gone past it and we may mark it empty.
+        // Otherwise it must become a tombstone.
+        i64 const index_before = (index - detail::group_width) & _capacity;
+        u32 const empty_after = detail::Flat_Hash_Map_Group(_control + index).match_empty();
+        u32 const empty_before = detail::Flat_Hash_Map_Group(_control + index_before).match_empty();
+        bool const was_never_full = empty_before && empty_after &&
+                                    detail::group_trailing_zeros(empty_after) + detail::group_leading_zeros(empty_before) < detail::group_width;
+        set_control(index, was_never_full ? detail::control_empty : detail::control_deleted);
+        _growth_left += was_never_full;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    bool Flat_Hash_Map<Key, Value, Hash, Key_Compare>::erase(Key const& key) {
+        i64 const index = find_index(key);
+        if(index == -1) {
+            return false;
+        }
+
+        erase(const_iterator(_control + index, _slots + index));
+        return true;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::clear() {
+        if(_capacity == 0) {
+            return;
+        }
+
+        destroy_slots();
+        memset(_control, detail::control_empty, _capacity + detail::group_width);
+        _control[_capacity] = detail::control_sentinel;
+        _size = 0;
+        _growth_left = max_growth(_capacity);
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::ensure_capacity(i64 const c) {
+        if(c <= _size + _growth_left) {
+            return;
         }
+
+        i64 new_capacity = detail::group_width - 1;
+        while(max_growth(new_capacity) < c) {
+            new_capacity = new_capacity * 2 + 1;
+        }
+        resize(new_capacity);
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
@@ -504,77 +661,180 @@ namespace anton_engine::atl {
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
-    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::ensure_capacity(i64 const c) {
-        i64 new_capacity = _capacity != 0 ? _capacity : 64;
+    f32 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::load_factor() const {
+        return _capacity != 0 ? static_cast<f32>(_size) / static_cast<f32>(_capacity) : 0.0f;
+    }
 
-        // TODO: load_factor
-        while(new_capacity < c) {
-            new_capacity *= 2;
-        }
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    f32 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::max_load_factor() const {
+        return 7.0f / 8.0f;
+    }
 
-        if (new_capacity == _capacity) {
-            return;
-        }
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::empty_control() -> i8* {
+        // The control bytes of the maps without slots. Lookups and insertions check the capacity before they probe,
+        // hence only the iterators read these.
+        alignas(16) static constexpr i8 control[detail::group_width + 1] = {
+            detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel,
+            detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel,
+            detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel, detail::control_sentinel,
+            detail::control_sentinel, detail::control_sentinel,
+        };
+        return const_cast<i8*>(control + 1);
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::max_growth(i64 const capacity) {
+        // Keeps the load factor at or below 7/8. At least one slot is always empty so that every lookup terminates.
+        return capacity - capacity / 8;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::slots_offset(i64 const capacity) {
+        // The sentinel before the control bytes, the control bytes, the sentinel after them and the clones.
+        i64 const control_size = capacity + detail::group_width + 1;
+        return (control_size + alignof(Slot) - 1) / alignof(Slot) * alignof(Slot);
+    }
 
-        State* new_states = nullptr;
-        Slot* new_slots = nullptr;
-        try {
-            new_states = (State*)_allocator.allocate((new_capacity + 16 + 1) * sizeof(State), 16);
-            new_states += 16;
-            new_states[-1] = State::sentinel;
-            memset(new_states, (u8)State::empty, new_capacity);
-            new_states[new_capacity] = State::sentinel;
-            new_slots = (Slot*)_allocator.allocate(new_capacity * sizeof(Slot), alignof(Slot));
-        } catch(...) {
-            // TODO: Cleanup or whatever.
-            throw;
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::allocation_size(i64 const capacity) {
+        return slots_offset(capacity) + capacity * static_cast<i64>(sizeof(Slot));
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::allocation_alignment() {
+        return alignof(Slot) > 16 ? alignof(Slot) : 16;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    template<typename K>
+    u64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::hash_key(K const& key) const {
+        // The low 7 bits of the hash are stored in the control bytes and the rest selects the group,
+        // hence Hash must mix all bits of the key, which Default_Hash does.
+        return _hasher(key);
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    template<typename K>
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find_index(K const& key) const {
+        if(_capacity == 0) {
+            return -1;
         }
 
+        u64 const h = hash_key(key);
+        i8 const h2 = static_cast<i8>(h & 0x7F);
+        // Triangular probing over the groups visits every group when the number of slots is a power of 2.
+        i64 offset = static_cast<i64>(h >> 7) & _capacity;
+        for(i64 step = detail::group_width;; step += detail::group_width) {
+            detail::Flat_Hash_Map_Group const group(_control + offset);
+            for(u32 match = group.match(h2); match != 0; match &= match - 1) {
+                i64 const index = (offset + detail::group_trailing_zeros(match)) & _capacity;
+                if(_key_equal(key, _slots[index].key)) {
+                    return index;
+                }
+            }
 
-        for(i64 i = 0; i < _capacity; ++i) {
-            if(_states[i] == State::active) {
-                u64 const h = _hasher(_slots[i].key);
-                i64 const index = find_non_active(h, new_capacity, new_states);
-                new (new_slots + index) Slot{atl::move(_slots[i])};
-                _slots[i].~Slot();
-                new_states[index] = State::active;
+            if(group.match_empty()) {
+                return -1;
             }
-        }
 
-        if(_capacity) {
-            _allocator.deallocate(_states - 16, (_capacity + 16 + 1) * sizeof(State), 16);
-            _allocator.deallocate(_slots, _capacity * sizeof(Slot), alignof(Slot));
+            offset = (offset + step) & _capacity;
         }
-        _states = new_states;
-        _slots = new_slots;
-        _capacity = new_capacity;
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
-    auto Flat_Hash_Map<Key, Value, Hash, Key_Compare>::empty_initial_states() -> State* {
-        // constexpr to force the values to be allocated at runtime.
-        // TODO: I have no idea what I'm doing.
-        // TODO: Remind myself at one point why I'm aligning stuff.
-        alignas(16) static constexpr State empty_state[] = {
-            State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel,
-            State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel, State::sentinel,
-        };
-        return const_cast<State*>(empty_state);
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find_insert_index(u64 const h) const {
+        i64 offset = static_cast<i64>(h >> 7) & _capacity;
+        for(i64 step = detail::group_width;; step += detail::group_width) {
+            u32 const match = detail::Flat_Hash_Map_Group(_control + offset).match_empty_or_deleted();
+            if(match != 0) {
+                return (offset + detail::group_trailing_zeros(match)) & _capacity;
+            }
+
+            offset = (offset + step) & _capacity;
+        }
     }
 
     template<typename Key, typename Value, typename Hash, typename Key_Compare>
-    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::find_non_active(u64 h, i64 cap, State* states) {
-        i64 index = h % cap;
-        while(true) {
-            State const state = states[index];
-            if(state != State::active) {
-                break;
+    i64 Flat_Hash_Map<Key, Value, Hash, Key_Compare>::prepare_insert(u64 const h) {
+        i64 index = _capacity != 0 ? find_insert_index(h) : -1;
+        // Reusing a tombstone does not consume the growth.
+        if(index == -1 || (_growth_left == 0 && _control[index] != detail::control_deleted)) {
+            // When the tombstones take up most of the growth, rehashing in place is enough to reclaim them.
+            if(_capacity != 0 && _size * 2 <= max_growth(_capacity)) {
+                resize(_capacity);
             } else {
-                index = (index + 1) % cap;
+                resize(_capacity != 0 ? _capacity * 2 + 1 : detail::group_width - 1);
             }
+            index = find_insert_index(h);
         }
         return index;
     }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::finish_insert(i64 const index, u64 const h) {
+        _growth_left -= _control[index] == detail::control_empty;
+        set_control(index, static_cast<i8>(h & 0x7F));
+        _size += 1;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::set_control(i64 const index, i8 const value) {
+        _control[index] = value;
+        // Writes the clone of the first group_width - 1 control bytes. For the other indices it writes the same byte again.
+        _control[((index - (detail::group_width - 1)) & _capacity) + (detail::group_width - 1)] = value;
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::resize(i64 const new_capacity) {
+        i8* const old_control = _control;
+        Slot* const old_slots = _slots;
+        i64 const old_capacity = _capacity;
+
+        void* const memory = _allocator.allocate(allocation_size(new_capacity), allocation_alignment());
+        _control = static_cast<i8*>(memory) + 1;
+        _slots = reinterpret_cast<Slot*>(static_cast<char8*>(memory) + slots_offset(new_capacity));
+        _capacity = new_capacity;
+        _control[-1] = detail::control_sentinel;
+        memset(_control, detail::control_empty, new_capacity + detail::group_width);
+        _control[new_capacity] = detail::control_sentinel;
+
+        for(i64 i = 0; i < old_capacity; ++i) {
+            if(old_control[i] >= 0) {
+                u64 const h = hash_key(old_slots[i].key);
+                i64 const index = find_insert_index(h);
+                new (_slots + index) Slot(atl::move(old_slots[i]));
+                old_slots[i].~Slot();
+                set_control(index, static_cast<i8>(h & 0x7F));
+            }
+        }
+        _growth_left = max_growth(new_capacity) - _size;
+
+        if(old_capacity) {
+            _allocator.deallocate(old_control - 1, allocation_size(old_capacity), allocation_alignment());
+        }
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::destroy_slots() {
+        for(i64 i = 0; i < _capacity; ++i) {
+            if(_control[i] >= 0) {
+                _slots[i].~Slot();
+            }
+        }
+    }
+
+    template<typename Key, typename Value, typename Hash, typename Key_Compare>
+    void Flat_Hash_Map<Key, Value, Hash, Key_Compare>::deallocate() {
+        if(_capacity) {
+            _allocator.deallocate(_control - 1, allocation_size(_capacity), allocation_alignment());
+        }
+        _control = empty_control();
+        _slots = nullptr;
+        _capacity = 0;
+        _size = 0;
+        _growth_left = 0;
+    }
 }
 
 #endif // !CORE_ATL_FLAT_HASH_MAP_HPP_INCLUDE
@@ -0,0 +1,438 @@
+#ifndef CORE_ATL_SMALL_VECTOR_HPP_INCLUDE
+#define CORE_ATL_SMALL_VECTOR_HPP_INCLUDE
+
+#include <core/anton_crt.hpp>
+#include <core/assert.hpp>
+#include <core/atl/aligned_buffer.hpp>
+#include <core/atl/allocator.hpp>
+#include <core/atl/memory.hpp>
+#include <core/atl/tags.hpp>
+#include <core/atl/type_traits.hpp>
+#include <core/atl/utility.hpp>
+#include <core/math/math.hpp>
+
+namespace anton_engine::atl {
+    // Small_Vector
+    // Vector that stores up to N elements inline and allocates only when it grows beyond them.
+    // Moving a Small_Vector whose elements are stored inline moves the elements one by one.
+    // Move constructor of T must not throw any exceptions.
+    //
+    template <typename T, i64 N, typename Allocator = atl::Allocator>
+    class Small_Vector {
+        static_assert(N > 0, "Small_Vector requires inline capacity of at least 1 element.");
+        static_assert(atl::is_move_constructible<T> || atl::is_copy_constructible<T>, "Type is neither move constructible nor copy constructible");
+
+    public:
+        using value_type = T;
+        using allocator_type = Allocator;
+        using size_type = i64;
+        using difference_type = isize;
+        using pointer = T*;
+        using const_pointer = T const*;
+        using reference = T&;
+        using const_reference = T const&;
+        using iterator = T*;
+        using const_iterator = T const*;
+
+        Small_Vector();
+        explicit Small_Vector(allocator_type const& allocator);
+        explicit Small_Vector(size_type size);
+        Small_Vector(Reserve_Tag, size_type size);
+        Small_Vector(size_type, value_type const&);
+        Small_Vector(Small_Vector const& original);
+        Small_Vector(Small_Vector&& from) noexcept;
+        template <typename Input_Iterator>
+        Small_Vector(Range_Construct_Tag, Input_Iterator first, Input_Iterator last);
+        ~Small_Vector();
+        Small_Vector& operator=(Small_Vector const& original);
+        Small_Vector& operator=(Small_Vector&& from) noexcept;
+
+        [[nodiscard]] reference operator[](size_type);
+        [[nodiscard]] const_reference operator[](size_type) const;
+        [[nodiscard]] pointer data();
+        [[nodiscard]] const_pointer data() const;
+
+        [[nodiscard]] iterator begin();
+        [[nodiscard]] iterator end();
+        [[nodiscard]] const_iterator begin() const;
+        [[nodiscard]] const_iterator end() const;
+        [[nodiscard]] const_iterator cbegin() const;
+        [[nodiscard]] const_iterator cend() const;
+
+        [[nodiscard]] size_type size() const;
+        [[nodiscard]] size_type capacity() const;
+        // Whether the elements are stored inline.
+        [[nodiscard]] bool is_inline() const;
+
+        void resize(size_type n);
+        void resize(size_type n, value_type const&);
+        // Does nothing if n is less than capacity().
+        void reserve(size_type n);
+
+        void insert(size_type position, value_type const&);
+        void push_back(value_type const&);
+        void push_back(value_type&&);
+        template <typename... Ctor_Args>
+        reference emplace_back(Ctor_Args&&... args);
+        iterator erase_unsorted(const_iterator position);
+        iterator erase(const_iterator first, const_iterator last);
+        void pop_back();
+        void clear();
+
+    private:
+        Allocator _allocator;
+        size_type _capacity = N;
+        size_type _size = 0;
+        T* _data;
+        Aligned_Buffer<sizeof(T) * N, alignof(T)> _inline_storage;
+
+        [[nodiscard]] T* get_inline_storage();
+        template <typename... Ctor_Args>
+        void attempt_construct(T* in, Ctor_Args&&... args);
+        void ensure_capacity(size_type requested_capacity);
+        // Moves the elements to uninitialized memory at destination and destroys the originals.
+        void relocate_to(T* destination);
+        void release_storage();
+    };
+
+    template <typename T, i64 N, typename Allocator>
+    struct Is_Trivially_Relocatable<Small_Vector<T, N, Allocator>>: False_Type {};
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(): _data(get_inline_storage()) {}
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(allocator_type const& allocator): _allocator(allocator), _data(get_inline_storage()) {}
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(size_type const n): _data(get_inline_storage()) {
+        resize(n);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(Reserve_Tag, size_type const n): _data(get_inline_storage()) {
+        ensure_capacity(n);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(size_type const n, value_type const& value): _data(get_inline_storage()) {
+        resize(n, value);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(Small_Vector const& v): _allocator(v._allocator), _data(get_inline_storage()) {
+        ensure_capacity(v._size);
+        atl::uninitialized_copy_n(v._data, v._size, _data);
+        _size = v._size;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::Small_Vector(Small_Vector&& v) noexcept: _allocator(v._allocator), _data(get_inline_storage()) {
+        if (v.is_inline()) {
+            v.relocate_to(_data);
+        } else {
+            _data = v._data;
+            _capacity = v._capacity;
+            v._data = v.get_inline_storage();
+            v._capacity = N;
+        }
+        _size = v._size;
+        v._size = 0;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    template <typename Input_Iterator>
+    Small_Vector<T, N, Allocator>::Small_Vector(Range_Construct_Tag, Input_Iterator first, Input_Iterator last): _data(get_inline_storage()) {
+        size_type const count = last - first;
+        ensure_capacity(count);
+        atl::uninitialized_copy(first, last, _data);
+        _size = count;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    Small_Vector<T, N, Allocator>::~Small_Vector() {
+        atl::destruct_n(_data, _size);
+        release_storage();
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::operator=(Small_Vector const& v) -> Small_Vector& {
+        if (this != &v) {
+            clear();
+            ensure_capacity(v._size);
+            atl::uninitialized_copy_n(v._data, v._size, _data);
+            _size = v._size;
+        }
+        return *this;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::operator=(Small_Vector&& v) noexcept -> Small_Vector& {
+        if (this != &v) {
+            clear();
+            if (v.is_inline()) {
+                // The storage of this, whether inline or not, fits at least N elements.
+                v.relocate_to(_data);
+            } else {
+                release_storage();
+                _data = v._data;
+                _capacity = v._capacity;
+                v._data = v.get_inline_storage();
+                v._capacity = N;
+            }
+            _size = v._size;
+            v._size = 0;
+        }
+        return *this;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::operator[](size_type const index) -> reference {
+        if constexpr (ANTON_ITERATOR_DEBUG) {
+            ANTON_FAIL(index < _size && index >= 0, "Index out of bounds.");
+        }
+
+        return _data[index];
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::operator[](size_type const index) const -> const_reference {
+        if constexpr (ANTON_ITERATOR_DEBUG) {
+            ANTON_FAIL(index < _size && index >= 0, "Index out of bounds.");
+        }
+
+        return _data[index];
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::data() -> pointer {
+        return _data;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::data() const -> const_pointer {
+        return _data;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::begin() -> iterator {
+        return _data;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::end() -> iterator {
+        return _data + _size;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::begin() const -> const_iterator {
+        return _data;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::end() const -> const_iterator {
+        return _data + _size;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::cbegin() const -> const_iterator {
+        return _data;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::cend() const -> const_iterator {
+        return _data + _size;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::size() const -> size_type {
+        return _size;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::capacity() const -> size_type {
+        return _capacity;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    bool Small_Vector<T, N, Allocator>::is_inline() const {
+        return _data == reinterpret_cast<T const*>(_inline_storage.buffer);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::resize(size_type const n) {
+        ensure_capacity(n);
+        if (n > _size) {
+            atl::uninitialized_default_construct(_data + _size, _data + n);
+        } else {
+            atl::destruct(_data + n, _data + _size);
+        }
+        _size = n;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::resize(size_type const n, value_type const& value) {
+        ensure_capacity(n);
+        if (n > _size) {
+            atl::uninitialized_fill(_data + _size, _data + n, value);
+        } else {
+            atl::destruct(_data + n, _data + _size);
+        }
+        _size = n;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::reserve(size_type const n) {
+        ensure_capacity(n);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::insert(size_type const position, value_type const& value) {
+        if constexpr (ANTON_ITERATOR_DEBUG) {
+            ANTON_FAIL(position <= _size && position >= 0, "Index out of bounds.");
+        }
+
+        // Copy the value first since it may refer to an element of this vector.
+        T copy(value);
+        ensure_capacity(_size + 1);
+        if (position == _size) {
+            attempt_construct(_data + _size, atl::move(copy));
+        } else {
+            attempt_construct(_data + _size, atl::move(_data[_size - 1]));
+            atl::move_backward(_data + position, _data + _size - 1, _data + _size);
+            _data[position] = atl::move(copy);
+        }
+        _size += 1;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::push_back(value_type const& value) {
+        if (_size == _capacity) {
+            // value may refer to an element of this vector.
+            T copy(value);
+            ensure_capacity(_size + 1);
+            attempt_construct(_data + _size, atl::move(copy));
+        } else {
+            attempt_construct(_data + _size, value);
+        }
+        _size += 1;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::push_back(value_type&& value) {
+        if (_size == _capacity) {
+            T moved(atl::move(value));
+            ensure_capacity(_size + 1);
+            attempt_construct(_data + _size, atl::move(moved));
+        } else {
+            attempt_construct(_data + _size, atl::move(value));
+        }
+        _size += 1;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    template <typename... Ctor_Args>
+    auto Small_Vector<T, N, Allocator>::emplace_back(Ctor_Args&&... args) -> reference {
+        ensure_capacity(_size + 1);
+        T* const element = _data + _size;
+        attempt_construct(element, atl::forward<Ctor_Args>(args)...);
+        _size += 1;
+        return *element;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::erase_unsorted(const_iterator const position) -> iterator {
+        T* const element = const_cast<T*>(position);
+        T* const last_element = _data + _size - 1;
+        if (element != last_element) {
+            *element = atl::move(*last_element);
+        }
+        atl::destruct(last_element);
+        _size -= 1;
+        return element;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    auto Small_Vector<T, N, Allocator>::erase(const_iterator const first, const_iterator const last) -> iterator {
+        if (first != last) {
+            iterator const position = atl::move(const_cast<T*>(last), end(), const_cast<T*>(first));
+            atl::destruct(position, end());
+            _size -= last - first;
+        }
+
+        return const_cast<T*>(first);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::pop_back() {
+        ANTON_VERIFY(_size > 0, "Trying to pop an element from an empty Small_Vector.");
+        atl::destruct(_data + _size - 1);
+        _size -= 1;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::clear() {
+        atl::destruct_n(_data, _size);
+        _size = 0;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    T* Small_Vector<T, N, Allocator>::get_inline_storage() {
+        return reinterpret_cast<T*>(_inline_storage.buffer);
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    template <typename... Ctor_Args>
+    void Small_Vector<T, N, Allocator>::attempt_construct(T* const in, Ctor_Args&&... args) {
+        if constexpr (atl::is_constructible<T, Ctor_Args&&...>) {
+            ::new (in) T(atl::forward<Ctor_Args>(args)...);
+        } else {
+            ::new (in) T{atl::forward<Ctor_Args>(args)...};
+        }
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::ensure_capacity(size_type const requested_capacity) {
+        if (requested_capacity <= _capacity) {
+            return;
+        }
+
+        size_type new_capacity = _capacity * 2;
+        while (new_capacity < requested_capacity) {
+            new_capacity *= 2;
+        }
+
+        T* const new_data = static_cast<T*>(_allocator.allocate(new_capacity * static_cast<isize>(sizeof(T)), static_cast<isize>(alignof(T))));
+        relocate_to(new_data);
+        release_storage();
+        _data = new_data;
+        _capacity = new_capacity;
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::relocate_to(T* const destination) {
+        if constexpr (atl::is_trivially_relocatable<T>) {
+            if (_size > 0) {
+                memcpy(destination, _data, static_cast<usize>(_size) * sizeof(T));
+            }
+        } else {
+            if constexpr (atl::is_move_constructible<T>) {
+                atl::uninitialized_move_n(_data, _size, destination);
+            } else {
+                atl::uninitialized_copy_n(_data, _size, destination);
+            }
+            atl::destruct_n(_data, _size);
+        }
+    }
+
+    template <typename T, i64 N, typename Allocator>
+    void Small_Vector<T, N, Allocator>::release_storage() {
+        if (!is_inline()) {
+            _allocator.deallocate(_data, _capacity * static_cast<isize>(sizeof(T)), static_cast<isize>(alignof(T)));
+            _data = get_inline_storage();
+            _capacity = N;
+        }
+    }
+} // namespace anton_engine::atl
+
+#endif // !CORE_ATL_SMALL_VECTOR_HPP_INCLUDE
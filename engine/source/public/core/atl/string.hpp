@@ -15,10 +15,12 @@ namespace anton_engine::atl {
     // Both return proxy classes which have begin/end functions that return iterators over
     // bytes and code points respectively.
     //
+    // Strings of up to inline_capacity bytes are stored within the object itself and do not allocate.
+    // The contents are always followed by a null-terminator which is not included in the size or the capacity.
+    //
     // Notes:
     // operator[] is not implemented because UTF-8 doesn't allow us to index in constant-time.
     //
-    // TODO: SSO
     // TODO: Grapheme Clusters
     //
     class String {
@@ -31,6 +33,9 @@ namespace anton_engine::atl {
         using byte_const_iterator = char8*;
         using char_iterator = UTF8_Char_Iterator;
 
+        // Number of bytes, not including the null-terminator, that fit in the object without allocating.
+        static constexpr size_type inline_capacity = 23;
+
     public:
         [[nodiscard]] static String from_utf16(char16 const*);
 
@@ -85,7 +90,7 @@ namespace anton_engine::atl {
         // Always const
         [[nodiscard]] char_iterator chars_end() const;
 
-        // Capacity of the string in bytes.
+        // Capacity of the string in bytes not including the null-terminator.
         [[nodiscard]] size_type capacity() const;
         // Size of the string in bytes.
         [[nodiscard]] size_type size_bytes() const;
@@ -99,8 +104,9 @@ namespace anton_engine::atl {
         // Allocates exactly n bytes of storage.
         // Does nothing if requested_capacity is less than capacity().
         void reserve_exact(size_type requested_capacity);
-        // Changes the size of the string to n. Useful in situations when the user
+        // Changes the size of the string to n and null-terminates it. Useful in situations when the user
         // writes to the string via external means.
+        // n must not be greater than capacity().
         void force_size(size_type n);
 
         void clear();
@@ -119,10 +125,20 @@ namespace anton_engine::atl {
 
     private:
         allocator_type _allocator;
-        value_type* _data = nullptr;
-        size_type _capacity = 64;
+        // The string is stored inline if and only if _capacity is inline_capacity.
+        // Heap allocations are always larger.
+        size_type _capacity = inline_capacity;
         size_type _size = 0;
-
+        union {
+            value_type* _heap_data;
+            value_type _inline_data[inline_capacity + 1];
+        };
+
+        [[nodiscard]] bool is_inline() const;
+        void initialize(value_type const* first, size_type n);
+        void assign(value_type const* first, size_type n);
+        void release();
+        void reallocate(size_type new_capacity);
         void ensure_capacity(size_type requested_capacity);
         void ensure_capacity_exact(size_type requested_capacity);
     };
@@ -132,13 +148,25 @@ namespace anton_engine::atl {
     String& operator+=(String&, String_View);
 
     // Compares bytes
+    // Comparisons with String_View go through the conversion to String_View.
+    // Comparisons with null-terminated strings do not construct temporary Strings.
     [[nodiscard]] bool operator==(String const&, String const&);
+    [[nodiscard]] bool operator==(String const&, char8 const*);
+    [[nodiscard]] bool operator==(char8 const*, String const&);
 
     // Compares bytes
     [[nodiscard]] inline bool operator!=(String const& lhs, String const& rhs) {
         return !(lhs == rhs);
     }
 
+    [[nodiscard]] inline bool operator!=(String const& lhs, char8 const* const rhs) {
+        return !(lhs == rhs);
+    }
+
+    [[nodiscard]] inline bool operator!=(char8 const* const lhs, String const& rhs) {
+        return !(lhs == rhs);
+    }
+
     [[nodiscard]] atl::String operator+(atl::String const& lhs, atl::String const& rhs);
     [[nodiscard]] atl::String operator+(atl::String_View, atl::String const&);
     [[nodiscard]] atl::String operator+(atl::String const&, atl::String_View);
@@ -167,6 +195,13 @@ namespace anton_engine::atl {
 
     // TODO: Organize better.
     f32 str_to_f32(atl::String const&);
+
+    // Hash and compare Strings as String_Views, which lets maps with String keys be searched with views.
+    template<>
+    struct Default_Hash<String>: Default_Hash<String_View> {};
+
+    template<>
+    struct Equal_Compare<String>: Equal_Compare<String_View> {};
 } // namespace anton_engine::atl
 
 namespace anton_engine {
@@ -2,7 +2,9 @@
 #define CORE_ATL_STRING_VIEW_HPP_INCLUDE
 
 #include <build_config.hpp>
-#include <core/hashing/murmurhash2.hpp>
+#include <core/anton_crt.hpp>
+#include <core/hashing/wyhash.hpp>
+#include <core/atl/detail/functors.hpp>
 #include <core/atl/detail/string_iterators.hpp>
 #include <core/atl/iterators.hpp>
 #include <core/atl/string_utils.hpp>
@@ -59,7 +61,8 @@ namespace anton_engine::atl {
             return false;
         }
 
-        return compare_equal(lhs.data(), rhs.data());
+        // Views are not null-terminated, hence we compare exactly size_bytes bytes.
+        return lhs.size_bytes() == 0 || memcmp(lhs.data(), rhs.data(), lhs.size_bytes()) == 0;
     }
 
     // Compares bytes
@@ -68,10 +71,29 @@ namespace anton_engine::atl {
     }
 
     constexpr u64 hash(String_View const view) {
-        // Seeded with a randomly picked prime number. No idea how that affects the performance or collision frequency.
-        // TODO: Do my research on seeding the hash function.
-        return anton_engine::murmurhash2_64(view.bytes_begin(), view.size_bytes(), 547391837);
+        // Seeded with a randomly picked prime number. wyhash mixes the seed with its secret,
+        // so any value works equally well.
+        return anton_engine::wyhash(view.bytes_begin(), view.size_bytes(), 547391837);
     }
+
+    // Transparent, so that hash maps keyed by strings can be searched with views.
+    template<>
+    struct Default_Hash<String_View> {
+        using is_transparent = void;
+
+        u64 operator()(String_View const view) const {
+            return hash(view);
+        }
+    };
+
+    template<>
+    struct Equal_Compare<String_View> {
+        using is_transparent = void;
+
+        bool operator()(String_View const lhs, String_View const rhs) const {
+            return lhs == rhs;
+        }
+    };
 } // namespace anton_engine::atl
 
 namespace std {
@@ -1,6 +1,7 @@
 #ifndef CORE_ATL_VECTOR_HPP_INCLUDE
 #define CORE_ATL_VECTOR_HPP_INCLUDE
 
+#include <core/anton_crt.hpp>
 #include <core/assert.hpp>
 #include <core/atl/allocator.hpp>
 #include <core/atl/iterators.hpp>
@@ -16,6 +17,8 @@
 
 namespace anton_engine::atl {
     // Move constructor of T must not throw any exceptions.
+    // Default-constructed vectors do not allocate until an element is added or memory is reserved.
+    // Trivially relocatable elements are moved with memcpy when the storage grows.
     //
     template <typename T, typename Allocator = atl::Allocator>
     class Vector {
@@ -35,8 +38,10 @@ namespace anton_engine::atl {
         using const_iterator = T const*;
 
         Vector();
+        explicit Vector(allocator_type const& allocator);
         explicit Vector(size_type size);
         Vector(Reserve_Tag, size_type size);
+        Vector(Reserve_Tag, size_type size, allocator_type const& allocator);
         Vector(size_type, value_type const&);
         Vector(Vector const& original);
         Vector(Vector&& from) noexcept;
@@ -94,7 +99,7 @@ namespace anton_engine::atl {
 
     private:
         Allocator _allocator;
-        size_type _capacity = 64;
+        size_type _capacity = 0;
         size_type _size = 0;
         T* _data = nullptr;
 
@@ -109,9 +114,16 @@ namespace anton_engine::atl {
 
         T* allocate(size_type);
         void deallocate(void*, size_type);
+        [[nodiscard]] size_type compute_grown_capacity(size_type requested_capacity) const;
         void ensure_capacity(size_type requested_capacity);
+        // Moves n elements from the beginning of the storage to uninitialized memory at destination
+        // and destroys the originals.
+        void relocate_to(T* destination, size_type n);
     };
 
+    // Vector does not hold pointers to itself and may be relocated with memcpy.
+    template <typename T, typename Allocator>
+    struct Is_Trivially_Relocatable<Vector<T, Allocator>>: Bool_Constant<is_trivially_relocatable<Allocator>> {};
 } // namespace anton_engine::atl
 
 namespace anton_engine {
@@ -123,9 +135,10 @@ namespace anton_engine {
 
 namespace anton_engine::atl {
     template <typename T, typename Allocator>
-    Vector<T, Allocator>::Vector() {
-        _data = allocate(_capacity);
-    }
+    Vector<T, Allocator>::Vector() {}
+
+    template <typename T, typename Allocator>
+    Vector<T, Allocator>::Vector(allocator_type const& allocator): _allocator(allocator) {}
 
     template <typename T, typename Allocator>
     Vector<T, Allocator>::Vector(size_type const n) {
@@ -145,6 +158,11 @@ namespace anton_engine::atl {
         _data = allocate(_capacity);
     }
 
+    template <typename T, typename Allocator>
+    Vector<T, Allocator>::Vector(atl::Reserve_Tag, size_type const n, allocator_type const& allocator): _allocator(allocator), _capacity(n) {
+        _data = allocate(_capacity);
+    }
+
     template <typename T, typename Allocator>
     Vector<T, Allocator>::Vector(size_type n, value_type const& value) {
         _capacity = math::max(_capacity, n);
@@ -159,7 +177,7 @@ namespace anton_engine::atl {
     }
 
     template <typename T, typename Allocator>
-    Vector<T, Allocator>::Vector(Vector const& v): _allocator(v._allocator), _capacity(v._capacity) {
+    Vector<T, Allocator>::Vector(Vector const& v): _allocator(v._allocator), _capacity(v._size) {
         _data = allocate(_capacity);
         try {
             atl::uninitialized_copy_n(v._data, v._size, _data);
@@ -219,11 +237,11 @@ namespace anton_engine::atl {
         // TODO: Get rid of this and move to polymorphic
         // static_assert(std::allocator_traits<Allocator>::propagate_on_container_copy_assignment::value, "Allocator is not copy assignable");
         _allocator = v._allocator;
-        T* new_storage = allocate(v._capacity);
+        T* new_storage = allocate(v._size);
         try {
             atl::uninitialized_copy_n(v._data, v._size, new_storage);
         } catch (...) {
-            deallocate(new_storage, v._capacity);
+            deallocate(new_storage, v._size);
             throw;
         }
         atl::destruct_n(_data, _size);
@@ -231,7 +249,7 @@ namespace anton_engine::atl {
         deallocate(_data, _capacity);
         _data = new_storage;
         _size = v._size;
-        _capacity = v._capacity;
+        _capacity = v._size;
         return *this;
     }
 
@@ -344,15 +362,14 @@ namespace anton_engine::atl {
     void Vector<T, Allocator>::set_capacity(size_type new_capacity) {
         if (new_capacity != _capacity) {
             T* new_data = allocate(new_capacity);
+            size_type const kept = math::min(new_capacity, _size);
             try {
-                // TODO: More reallocation options
-                if constexpr (atl::is_move_constructible<T>) {
-                    atl::uninitialized_move_n(_data, math::min(new_capacity, _size), new_data);
-                } else {
-                    atl::uninitialized_copy_n(_data, math::min(new_capacity, _size), new_data);
-                }
-            } catch (...) { deallocate(new_data, new_capacity); }
-            destruct_n(_data, _size);
+                relocate_to(new_data, kept);
+            } catch (...) {
+                deallocate(new_data, new_capacity);
+                throw;
+            }
+            destruct_n(get_ptr(kept), _size - kept);
             deallocate(_data, _capacity);
             _data = new_data;
             _capacity = new_capacity;
@@ -386,24 +403,39 @@ namespace anton_engine::atl {
             if (_size != _capacity) {
                 atl::uninitialized_move_n(get_ptr(_size - 1), 1, get_ptr(_size));
                 atl::move_backward(get_ptr(position), get_ptr(_size - 1), get_ptr(_size));
+                atl::destruct(get_ptr(position));
                 attempt_construct(get_ptr(position), value);
                 _size += 1;
             } else {
-                i64 const new_capacity = _capacity * 2;
+                i64 const new_capacity = compute_grown_capacity(_size + 1);
                 T* const new_data = allocate(new_capacity);
-                i64 moved = 0;
-                try {
-                    atl::uninitialized_move(get_ptr(0), get_ptr(position), new_data);
-                    moved = position;
-                    attempt_construct(new_data + position, value);
-                    moved += 1;
-                    atl::uninitialized_move(get_ptr(position), get_ptr(_size), new_data + moved);
-                } catch (...) {
-                    atl::destruct_n(new_data, moved);
-                    deallocate(new_data, new_capacity);
-                    throw;
+                if constexpr (atl::is_trivially_relocatable<T>) {
+                    // Construct the new element first so that nothing has to be undone if it throws.
+                    try {
+                        attempt_construct(new_data + position, value);
+                    } catch (...) {
+                        deallocate(new_data, new_capacity);
+                        throw;
+                    }
+                    relocate_to(new_data, position);
+                    if (position < _size) {
+                        memcpy(new_data + position + 1, get_ptr(position), static_cast<usize>(_size - position) * sizeof(T));
+                    }
+                } else {
+                    i64 moved = 0;
+                    try {
+                        atl::uninitialized_move(get_ptr(0), get_ptr(position), new_data);
+                        moved = position;
+                        attempt_construct(new_data + position, value);
+                        moved += 1;
+                        atl::uninitialized_move(get_ptr(position), get_ptr(_size), new_data + moved);
+                    } catch (...) {
+                        atl::destruct_n(new_data, moved);
+                        deallocate(new_data, new_capacity);
+                        throw;
+                    }
+                    atl::destruct_n(_data, _size);
                 }
-                atl::destruct_n(_data, _size);
                 deallocate(_data, _capacity);
                 _capacity = new_capacity;
                 _data = new_data;
@@ -433,29 +465,40 @@ namespace anton_engine::atl {
                 i64 const target_offset = math::max(position + dist, _size);
                 atl::uninitialized_move_n(get_ptr(position + elems_inside), elems_outside, get_ptr(target_offset));
                 atl::move_backward(get_ptr(position), get_ptr(position + elems_inside), get_ptr(position + dist + elems_inside));
-                atl::destruct_n(get_ptr(position), elems_inside);
+                // The moved-from elements that are going to be overwritten.
+                atl::destruct_n(get_ptr(position), elems_outside);
                 atl::uninitialized_copy(first, last, get_ptr(position));
                 _size += dist;
             } else {
-                i64 new_capacity = _capacity * 2;
-                while(new_capacity <= _size + dist) {
-                    new_capacity *= 2;
-                }
-
+                i64 const new_capacity = compute_grown_capacity(_size + dist);
                 T* const new_data = allocate(new_capacity);
-                i64 moved = 0;
-                try {
-                    atl::uninitialized_move(get_ptr(0), get_ptr(position), new_data);
-                    moved = position;
-                    atl::uninitialized_copy(first, last, new_data + moved);
-                    moved += dist;
-                    atl::uninitialized_move(get_ptr(position), get_ptr(_size), new_data + moved);
-                } catch (...) {
-                    atl::destruct_n(new_data, moved);
-                    deallocate(new_data, new_capacity);
-                    throw;
+                if constexpr (atl::is_trivially_relocatable<T>) {
+                    // Copy the new elements first so that nothing has to be undone if it throws.
+                    try {
+                        atl::uninitialized_copy(first, last, new_data + position);
+                    } catch (...) {
+                        deallocate(new_data, new_capacity);
+                        throw;
+                    }
+                    relocate_to(new_data, position);
+                    if (position < _size) {
+                        memcpy(new_data + position + dist, get_ptr(position), static_cast<usize>(_size - position) * sizeof(T));
+                    }
+                } else {
+                    i64 moved = 0;
+                    try {
+                        atl::uninitialized_move(get_ptr(0), get_ptr(position), new_data);
+                        moved = position;
+                        atl::uninitialized_copy(first, last, new_data + moved);
+                        moved += dist;
+                        atl::uninitialized_move(get_ptr(position), get_ptr(_size), new_data + moved);
+                    } catch (...) {
+                        atl::destruct_n(new_data, moved);
+                        deallocate(new_data, new_capacity);
+                        throw;
+                    }
+                    atl::destruct_n(_data, _size);
                 }
-                atl::destruct_n(_data, _size);
                 deallocate(_data, _capacity);
                 _capacity = new_capacity;
                 _data = new_data;
@@ -632,41 +675,65 @@ namespace anton_engine::atl {
 
     template <typename T, typename Allocator>
     T* Vector<T, Allocator>::allocate(size_type const size) {
+        if (size <= 0) {
+            return nullptr;
+        }
+
         void* mem = _allocator.allocate(size * static_cast<isize>(sizeof(T)), static_cast<isize>(alignof(T)));
         return static_cast<T*>(mem);
     }
 
     template <typename T, typename Allocator>
     void Vector<T, Allocator>::deallocate(void* mem, size_type const size) {
+        if (mem == nullptr) {
+            return;
+        }
+
         _allocator.deallocate(mem, size * static_cast<isize>(sizeof(T)), static_cast<isize>(alignof(T)));
     }
 
+    template <typename T, typename Allocator>
+    auto Vector<T, Allocator>::compute_grown_capacity(size_type const requested_capacity) const -> size_type {
+        // The first allocation fits at least a cache line worth of elements.
+        size_type new_capacity = _capacity > 0 ? _capacity : math::max(static_cast<size_type>(64 / sizeof(T)), size_type(4));
+        while (new_capacity < requested_capacity) {
+            new_capacity *= 2;
+        }
+        return new_capacity;
+    }
+
     template <typename T, typename Allocator>
     void Vector<T, Allocator>::ensure_capacity(size_type requested_capacity) {
         if (requested_capacity > _capacity) {
-            size_type new_capacity = _capacity;
-            while (new_capacity < requested_capacity) {
-                new_capacity *= 2;
-            }
-
+            size_type const new_capacity = compute_grown_capacity(requested_capacity);
             T* new_data = allocate(new_capacity);
             try {
-                // TODO: More reallocation options
-                if constexpr (atl::is_move_constructible<T>) {
-                    atl::uninitialized_move(_data, _data + _size, new_data);
-                } else {
-                    atl::uninitialized_copy(_data, _data + _size, new_data);
-                }
+                relocate_to(new_data, _size);
             } catch (...) {
                 deallocate(new_data, new_capacity);
                 throw;
             }
-            destruct_n(_data, _size);
             deallocate(_data, _capacity);
             _data = new_data;
             _capacity = new_capacity;
         }
     }
+
+    template <typename T, typename Allocator>
+    void Vector<T, Allocator>::relocate_to(T* const destination, size_type const n) {
+        if constexpr (atl::is_trivially_relocatable<T>) {
+            if (n > 0) {
+                memcpy(destination, _data, static_cast<usize>(n) * sizeof(T));
+            }
+        } else {
+            if constexpr (atl::is_move_constructible<T>) {
+                atl::uninitialized_move_n(_data, n, destination);
+            } else {
+                atl::uninitialized_copy_n(_data, n, destination);
+            }
+            atl::destruct_n(_data, n);
+        }
+    }
 } // namespace anton_engine::atl
 
 namespace anton_engine {
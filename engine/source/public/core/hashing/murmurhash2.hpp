@@ -8,83 +8,25 @@ namespace anton_engine {
     // MurmurHash2 was written by Austin Appleby, and is placed in the public
     // domain. The author hereby disclaims copyright to this source code.
     //
-    // Note - This code makes a few assumptions about how your machine behaves -
-    //
-    // 1. We can read a 4-byte value from any address without crashing
-    // 2. sizeof(int) == 4
-    //
-    // And it has a few limitations -
-    //
-    // 1. It will not work incrementally.
-    // 2. It will not produce the same results on little-endian and big-endian
-    //    machines.
-    constexpr u32 murmurhash2_32(const void* key, int len, u32 seed) {
-        // 'm' and 'r' are mixing constants generated offline.
-        // They're not really 'magic', they just happen to work well.
-
-        const u32 m = 0x5bd1e995;
-        const int r = 24;
-
-        // Initialize the hash to a 'random' value
-
-        u32 h = seed ^ len;
-
-        // Mix 4 bytes at a time into the hash
-
-        const unsigned char* data = (const unsigned char*)key;
-
-        while (len >= 4) {
-            u32 k = *(u32*)data;
-
-            k *= m;
-            k ^= k >> r;
-            k *= m;
-
-            h *= m;
-            h ^= k;
-
-            data += 4;
-            len -= 4;
-        }
-
-        // Handle the last few bytes of the input array
-
-        switch (len) {
-        case 3:
-            h ^= data[2] << 16;
-        case 2:
-            h ^= data[1] << 8;
-        case 1:
-            h ^= data[0];
-            h *= m;
-        };
-
-        // Do a few final mixes of the hash to ensure the last few
-        // bytes are well-incorporated.
-
-        h ^= h >> 13;
-        h *= m;
-        h ^= h >> 15;
-
-        return h;
-    }
+    // Only type_identifier uses it, because its values are persisted and must not change.
+    // The blocks are read byte by byte as little-endian, which produces the same hashes
+    // as the original on little-endian machines and lets the function run at compile time.
 
     // MurmurHash2, 64-bit hash, by Austin Appleby
     //
-    // The same caveats as 32-bit MurmurHash2 apply here - beware of alignment
-    // and endian-ness issues if used across multiple platforms.
-    //
-    constexpr u64 murmurhash2_64(const void* key, int len, unsigned int seed) {
-        const u64 m = 0xc6a4a7935bd1e995;
-        const int r = 47;
+    constexpr u64 murmurhash2_64(char8 const* const key, i64 const len, u32 const seed) {
+        u64 const m = 0xc6a4a7935bd1e995;
+        i32 const r = 47;
 
-        u64 h = seed ^ (len * m);
+        u64 h = seed ^ (static_cast<u64>(len) * m);
 
-        const u64* data = (const u64*)key;
-        const u64* end = data + (len / 8);
-
-        while (data != end) {
-            u64 k = *data++;
+        i64 const blocks = len / 8;
+        for (i64 i = 0; i < blocks; ++i) {
+            char8 const* const p = key + i * 8;
+            u64 k = 0;
+            for (i64 j = 7; j >= 0; --j) {
+                k = (k << 8) | static_cast<u8>(p[j]);
+            }
 
             k *= m;
             k ^= k >> r;
@@ -94,25 +36,14 @@ namespace anton_engine {
             h *= m;
         }
 
-        const unsigned char* data2 = (const unsigned char*)data;
-
-        switch (len & 7) {
-        case 7:
-            h ^= u64(data2[6]) << 48;
-        case 6:
-            h ^= u64(data2[5]) << 40;
-        case 5:
-            h ^= u64(data2[4]) << 32;
-        case 4:
-            h ^= u64(data2[3]) << 24;
-        case 3:
-            h ^= u64(data2[2]) << 16;
-        case 2:
-            h ^= u64(data2[1]) << 8;
-        case 1:
-            h ^= u64(data2[0]);
+        char8 const* const tail = key + blocks * 8;
+        i64 const tail_size = len & 7;
+        if (tail_size != 0) {
+            for (i64 j = tail_size - 1; j >= 0; --j) {
+                h ^= static_cast<u64>(static_cast<u8>(tail[j])) << (j * 8);
+            }
             h *= m;
-        };
+        }
 
         h ^= h >> r;
         h *= m;
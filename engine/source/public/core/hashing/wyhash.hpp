@@ -0,0 +1,258 @@
+#ifndef CORE_HASHING_WYHASH_HPP_INCLUDE
+#define CORE_HASHING_WYHASH_HPP_INCLUDE
+
+#include <core/types.hpp>
+
+#if defined(_MSC_VER) && defined(_M_X64) && !defined(__SIZEOF_INT128__)
+#include <intrin.h>
+#endif
+
+namespace anton_engine {
+    // wyhash final version 4 by Wang Yi, released into the public domain.
+    // 64 bit hash built on the 64x64->128 bit multiplication. wyhash(data, size, seed) produces the same
+    // values as the reference wyhash(key, len, seed, _wyp) with the default WYHASH_CONDOM of 1.
+    // The bytes are read as little-endian regardless of the platform, therefore the hashes are the same
+    // on all machines. All functions are constexpr so that literals may be hashed at compile time.
+
+    namespace detail {
+        constexpr u64 wyhash_secret[4] = {0xA0761D6478BD642FULL, 0xE7037ED1A0B428DBULL, 0x8EBC6AF09C88C6E3ULL, 0x589965CC75374CC3ULL};
+
+#if defined(__SIZEOF_INT128__)
+        // __extension__ silences -Wpedantic about the non-standard type.
+        __extension__ typedef unsigned __int128 wyhash_u128;
+#endif
+
+        // Replaces a and b with the low and the high 64 bits of their product.
+        constexpr void wyhash_multiply(u64& a, u64& b) {
+#if defined(__SIZEOF_INT128__)
+            wyhash_u128 const r = static_cast<wyhash_u128>(a) * b;
+            a = static_cast<u64>(r);
+            b = static_cast<u64>(r >> 64);
+#else
+#    if defined(_MSC_VER) && defined(_M_X64)
+            if (!__builtin_is_constant_evaluated()) {
+                a = _umul128(a, b, &b);
+                return;
+            }
+#    endif
+            // _umul128 is not constexpr, hence at compile time (and on other platforms) we multiply the 32 bit halves.
+            u64 const ha = a >> 32;
+            u64 const hb = b >> 32;
+            u64 const la = static_cast<u32>(a);
+            u64 const lb = static_cast<u32>(b);
+            u64 const rh = ha * hb;
+            u64 const rm0 = ha * lb;
+            u64 const rm1 = hb * la;
+            u64 const rl = la * lb;
+            u64 const t = rl + (rm0 << 32);
+            u64 carry = t < rl;
+            u64 const lo = t + (rm1 << 32);
+            carry += lo < t;
+            a = lo;
+            b = rh + (rm0 >> 32) + (rm1 >> 32) + carry;
+#endif
+        }
+
+        constexpr u64 wyhash_mix(u64 a, u64 b) {
+            wyhash_multiply(a, b);
+            return a ^ b;
+        }
+
+        // GCC and Clang combine the shifts into single loads on little-endian machines.
+        constexpr u64 wyhash_read8(char8 const* const p) {
+            return static_cast<u64>(static_cast<u8>(p[0])) | static_cast<u64>(static_cast<u8>(p[1])) << 8 |
+                   static_cast<u64>(static_cast<u8>(p[2])) << 16 | static_cast<u64>(static_cast<u8>(p[3])) << 24 |
+                   static_cast<u64>(static_cast<u8>(p[4])) << 32 | static_cast<u64>(static_cast<u8>(p[5])) << 40 |
+                   static_cast<u64>(static_cast<u8>(p[6])) << 48 | static_cast<u64>(static_cast<u8>(p[7])) << 56;
+        }
+
+        constexpr u64 wyhash_read4(char8 const* const p) {
+            return static_cast<u64>(static_cast<u8>(p[0])) | static_cast<u64>(static_cast<u8>(p[1])) << 8 |
+                   static_cast<u64>(static_cast<u8>(p[2])) << 16 | static_cast<u64>(static_cast<u8>(p[3])) << 24;
+        }
+
+        // Reads 1 to 3 bytes.
+        constexpr u64 wyhash_read3(char8 const* const p, i64 const size) {
+            return static_cast<u64>(static_cast<u8>(p[0])) << 16 | static_cast<u64>(static_cast<u8>(p[size >> 1])) << 8 |
+                   static_cast<u64>(static_cast<u8>(p[size - 1]));
+        }
+
+        constexpr u64 wyhash_seed(u64 const seed) {
+            return seed ^ wyhash_mix(seed ^ wyhash_secret[0], wyhash_secret[1]);
+        }
+
+        // Hashes at most 16 bytes.
+        constexpr void wyhash_read_short(char8 const* const p, i64 const size, u64& a, u64& b) {
+            if (size >= 4) {
+                i64 const offset = (size >> 3) << 2;
+                a = (wyhash_read4(p) << 32) | wyhash_read4(p + offset);
+                b = (wyhash_read4(p + size - 4) << 32) | wyhash_read4(p + size - 4 - offset);
+            } else if (size > 0) {
+                a = wyhash_read3(p, size);
+                b = 0;
+            } else {
+                a = 0;
+                b = 0;
+            }
+        }
+
+        constexpr u64 wyhash_finish(u64 a, u64 b, u64 const seed, i64 const size) {
+            a ^= wyhash_secret[1];
+            b ^= seed;
+            wyhash_multiply(a, b);
+            return wyhash_mix(a ^ wyhash_secret[0] ^ static_cast<u64>(size), b ^ wyhash_secret[1]);
+        }
+    } // namespace detail
+
+    namespace detail {
+        // Hashes more than 16 bytes. Kept out of wyhash so that the short keys are inlined.
+        constexpr u64 wyhash_long(char8 const* data, i64 const size, u64 seed) {
+            i64 remaining = size;
+            // Like the reference implementation, leaves the last block to the loop below even when it is complete.
+            if (remaining > 48) {
+                u64 see1 = seed;
+                u64 see2 = seed;
+                do {
+                    seed = wyhash_mix(wyhash_read8(data) ^ wyhash_secret[1], wyhash_read8(data + 8) ^ seed);
+                    see1 = wyhash_mix(wyhash_read8(data + 16) ^ wyhash_secret[2], wyhash_read8(data + 24) ^ see1);
+                    see2 = wyhash_mix(wyhash_read8(data + 32) ^ wyhash_secret[3], wyhash_read8(data + 40) ^ see2);
+                    data += 48;
+                    remaining -= 48;
+                } while (remaining > 48);
+                seed ^= see1 ^ see2;
+            }
+
+            while (remaining > 16) {
+                seed = wyhash_mix(wyhash_read8(data) ^ wyhash_secret[1], wyhash_read8(data + 8) ^ seed);
+                data += 16;
+                remaining -= 16;
+            }
+
+            // The last 16 bytes, which may overlap the bytes that have already been hashed.
+            u64 const a = wyhash_read8(data + remaining - 16);
+            u64 const b = wyhash_read8(data + remaining - 8);
+            return wyhash_finish(a, b, seed, size);
+        }
+    } // namespace detail
+
+    // wyhash
+    // Hashes size bytes of data.
+    //
+    constexpr u64 wyhash(char8 const* const data, i64 const size, u64 seed = 0) {
+        seed = detail::wyhash_seed(seed);
+        if (size <= 16) {
+            u64 a = 0;
+            u64 b = 0;
+            detail::wyhash_read_short(data, size, a, b);
+            return detail::wyhash_finish(a, b, seed, size);
+        } else {
+            return detail::wyhash_long(data, size, seed);
+        }
+    }
+
+    inline u64 wyhash(void const* const data, i64 const size, u64 const seed = 0) {
+        return wyhash(static_cast<char8 const*>(data), size, seed);
+    }
+
+    // wyhash_u64
+    // Mixes the bits of an integer with a single multiplication. Meant for hash tables keyed by
+    // integers, enums, handles or pointers whose bits are far from uniformly distributed.
+    //
+    constexpr u64 wyhash_u64(u64 const v) {
+        return detail::wyhash_mix(v ^ detail::wyhash_secret[0], detail::wyhash_secret[1]);
+    }
+
+    // Wyhash_Stream
+    // Hashes data that arrives in parts, e.g. files read in chunks.
+    // The result is the same as that of wyhash over the concatenated parts.
+    //
+    class Wyhash_Stream {
+    public:
+        constexpr explicit Wyhash_Stream(u64 const seed = 0): _seed(detail::wyhash_seed(seed)), _see1(_seed), _see2(_seed) {}
+
+        constexpr void update(char8 const* data, i64 size) {
+            _size += size;
+            while (size > 0) {
+                // wyhash consumes a block only when more bytes follow it, therefore
+                // a complete buffered block waits until we know it is not the last one.
+                if (_buffered == block_size) {
+                    consume(_buffer + tail_size);
+                    for (i64 i = 0; i < tail_size; ++i) {
+                        _buffer[i] = _buffer[block_size + i];
+                    }
+                    _buffered = 0;
+                }
+
+                if (_buffered == 0) {
+                    char8 const* last_block = nullptr;
+                    for (; size > block_size; data += block_size, size -= block_size) {
+                        consume(data);
+                        last_block = data;
+                    }
+
+                    if (last_block != nullptr) {
+                        for (i64 i = 0; i < tail_size; ++i) {
+                            _buffer[i] = last_block[block_size - tail_size + i];
+                        }
+                    }
+                }
+
+                for (; size > 0 && _buffered < block_size; ++data, --size) {
+                    _buffer[tail_size + _buffered] = *data;
+                    _buffered += 1;
+                }
+            }
+        }
+
+        void update(void const* const data, i64 const size) {
+            update(static_cast<char8 const*>(data), size);
+        }
+
+        // Returns: The hash of all bytes passed to update so far.
+        [[nodiscard]] constexpr u64 finish() const {
+            char8 const* data = _buffer + tail_size;
+            u64 a = 0;
+            u64 b = 0;
+            u64 seed = _seed;
+            if (_size <= 16) {
+                detail::wyhash_read_short(data, _size, a, b);
+            } else {
+                if (_size > block_size) {
+                    seed ^= _see1 ^ _see2;
+                }
+
+                i64 remaining = _buffered;
+                while (remaining > 16) {
+                    seed = detail::wyhash_mix(detail::wyhash_read8(data) ^ detail::wyhash_secret[1], detail::wyhash_read8(data + 8) ^ seed);
+                    data += 16;
+                    remaining -= 16;
+                }
+
+                // Reads into the tail of the last block when fewer than 16 bytes remain.
+                a = detail::wyhash_read8(data + remaining - 16);
+                b = detail::wyhash_read8(data + remaining - 8);
+            }
+            return detail::wyhash_finish(a, b, seed, _size);
+        }
+
+    private:
+        static constexpr i64 block_size = 48;
+        static constexpr i64 tail_size = 16;
+
+        u64 _seed;
+        u64 _see1;
+        u64 _see2;
+        i64 _size = 0;
+        i64 _buffered = 0;
+        // The last tail_size bytes of the last consumed block followed by the bytes that have not been consumed yet.
+        char8 _buffer[tail_size + block_size] = {};
+
+        constexpr void consume(char8 const* const p) {
+            _seed = detail::wyhash_mix(detail::wyhash_read8(p) ^ detail::wyhash_secret[1], detail::wyhash_read8(p + 8) ^ _seed);
+            _see1 = detail::wyhash_mix(detail::wyhash_read8(p + 16) ^ detail::wyhash_secret[2], detail::wyhash_read8(p + 24) ^ _see1);
+            _see2 = detail::wyhash_mix(detail::wyhash_read8(p + 32) ^ detail::wyhash_secret[3], detail::wyhash_read8(p + 40) ^ _see2);
+        }
+    };
+} // namespace anton_engine
+
+#endif // !CORE_HASHING_WYHASH_HPP_INCLUDE
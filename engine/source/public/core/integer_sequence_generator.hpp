@@ -12,6 +12,13 @@ namespace anton_engine {
             return _next++;
         }
 
+        // Returns: The first of count consecutive numbers.
+        u64 next(u64 const count) {
+            u64 const first = _next;
+            _next += count;
+            return first;
+        }
+
     private:
         u64 _next;
     };
@@ -17,4 +17,27 @@
 #    define ANTON_LIKELY(x) x
 #endif
 
+#include <core/types.hpp>
+
+namespace anton_engine {
+    // Relaxed atomic load and store of a naturally aligned u64 that is otherwise accessed as a plain integer.
+    // Only guarantee that concurrent accesses do not tear, they do not order any other memory accesses.
+    inline u64 atomic_load_relaxed(u64 const* const p) {
+#if defined(__clang__) || defined(__GNUC__)
+        return __atomic_load_n(p, __ATOMIC_RELAXED);
+#else
+        // Aligned 64 bit accesses are single-copy atomic on every target MSVC compiles for.
+        return *static_cast<u64 const volatile*>(p);
+#endif
+    }
+
+    inline void atomic_store_relaxed(u64* const p, u64 const value) {
+#if defined(__clang__) || defined(__GNUC__)
+        __atomic_store_n(p, value, __ATOMIC_RELAXED);
+#else
+        *static_cast<u64 volatile*>(p) = value;
+#endif
+    }
+} // namespace anton_engine
+
 #endif // !CORE_INTRINSICS_HPP_INCLUDE
@@ -3,6 +3,7 @@
 
 #include <core/atl/utility.hpp>
 #include <core/types.hpp>
+#include <core/math/simd.hpp>
 #include <core/math/vector4.hpp>
 
 namespace anton_engine {
@@ -152,21 +153,48 @@ namespace anton_engine {
 
     inline Matrix4 operator*(Matrix4 const lhs, Matrix4 const rhs) {
         Matrix4 r;
+#if ANTON_MATH_SSE
+        // Row i of the product is the sum of the rows of rhs scaled by the elements of row i of lhs.
+        float const* const a = lhs.get_raw();
+        float const* const b = rhs.get_raw();
+        __m128 const b0 = _mm_loadu_ps(b);
+        __m128 const b1 = _mm_loadu_ps(b + 4);
+        __m128 const b2 = _mm_loadu_ps(b + 8);
+        __m128 const b3 = _mm_loadu_ps(b + 12);
+        for (int i = 0; i < 4; ++i) {
+            __m128 row = _mm_mul_ps(_mm_set1_ps(a[4 * i]), b0);
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * i + 1]), b1));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * i + 2]), b2));
+            row = _mm_add_ps(row, _mm_mul_ps(_mm_set1_ps(a[4 * i + 3]), b3));
+            _mm_storeu_ps(&r(i, 0), row);
+        }
+#else
         for (int i = 0; i < 4; ++i) {
             r[i][0] = lhs[i][0] * rhs[0][0] + lhs[i][1] * rhs[1][0] + lhs[i][2] * rhs[2][0] + lhs[i][3] * rhs[3][0];
             r[i][1] = lhs[i][0] * rhs[0][1] + lhs[i][1] * rhs[1][1] + lhs[i][2] * rhs[2][1] + lhs[i][3] * rhs[3][1];
             r[i][2] = lhs[i][0] * rhs[0][2] + lhs[i][1] * rhs[1][2] + lhs[i][2] * rhs[2][2] + lhs[i][3] * rhs[3][2];
             r[i][3] = lhs[i][0] * rhs[0][3] + lhs[i][1] * rhs[1][3] + lhs[i][2] * rhs[2][3] + lhs[i][3] * rhs[3][3];
         }
+#endif
         return r;
     }
 
     inline Vector4 operator*(Vector4 const lhs, Matrix4 const rhs) {
         Vector4 r;
+#if ANTON_MATH_SSE
+        float const* const b = rhs.get_raw();
+        __m128 const v = _mm_loadu_ps(&lhs.x);
+        __m128 row = _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)), _mm_loadu_ps(b));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)), _mm_loadu_ps(b + 4)));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)), _mm_loadu_ps(b + 8)));
+        row = _mm_add_ps(row, _mm_mul_ps(_mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)), _mm_loadu_ps(b + 12)));
+        _mm_storeu_ps(&r.x, row);
+#else
         r[0] = lhs[0] * rhs[0][0] + lhs[1] * rhs[1][0] + lhs[2] * rhs[2][0] + lhs[3] * rhs[3][0];
         r[1] = lhs[0] * rhs[0][1] + lhs[1] * rhs[1][1] + lhs[2] * rhs[2][1] + lhs[3] * rhs[3][1];
         r[2] = lhs[0] * rhs[0][2] + lhs[1] * rhs[1][2] + lhs[2] * rhs[2][2] + lhs[3] * rhs[3][2];
         r[3] = lhs[0] * rhs[0][3] + lhs[1] * rhs[1][3] + lhs[2] * rhs[2][3] + lhs[3] * rhs[3][3];
+#endif
         return r;
     }
 } // namespace anton_engine
@@ -218,8 +246,84 @@ namespace anton_engine::math {
         // clang-format on
     }
 
+#if ANTON_MATH_SSE
+    namespace detail {
+        // 2x2 matrices are stored row major in a single register.
+
+        // Returns: lhs * rhs
+        inline __m128 mat2_mul(__m128 const lhs, __m128 const rhs) {
+            return _mm_add_ps(_mm_mul_ps(lhs, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(3, 0, 3, 0))),
+                              _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        // Returns: adjugate(lhs) * rhs
+        inline __m128 mat2_adj_mul(__m128 const lhs, __m128 const rhs) {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(0, 0, 3, 3)), rhs),
+                              _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        // Returns: lhs * adjugate(rhs)
+        inline __m128 mat2_mul_adj(__m128 const lhs, __m128 const rhs) {
+            return _mm_sub_ps(_mm_mul_ps(lhs, _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(0, 3, 0, 3))),
+                              _mm_mul_ps(_mm_shuffle_ps(lhs, lhs, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(rhs, rhs, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+    } // namespace detail
+#endif
+
     inline Matrix4 inverse(Matrix4 const m) {
+#if ANTON_MATH_SSE
+        // Blockwise inversion of the matrix split into 2x2 blocks
+        //     | A B |
+        //     | C D |
+        float const* const raw = m.get_raw();
+        __m128 const row0 = _mm_loadu_ps(raw);
+        __m128 const row1 = _mm_loadu_ps(raw + 4);
+        __m128 const row2 = _mm_loadu_ps(raw + 8);
+        __m128 const row3 = _mm_loadu_ps(raw + 12);
+        __m128 const a = _mm_movelh_ps(row0, row1);
+        __m128 const b = _mm_movehl_ps(row1, row0);
+        __m128 const c = _mm_movelh_ps(row2, row3);
+        __m128 const d = _mm_movehl_ps(row3, row2);
+
+        // Determinants of the blocks (|A|, |B|, |C|, |D|).
+        __m128 const block_determinants =
+            _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(3, 1, 3, 1))),
+                       _mm_mul_ps(_mm_shuffle_ps(row0, row2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(row1, row3, _MM_SHUFFLE(2, 0, 2, 0))));
+        __m128 const det_a = _mm_shuffle_ps(block_determinants, block_determinants, _MM_SHUFFLE(0, 0, 0, 0));
+        __m128 const det_b = _mm_shuffle_ps(block_determinants, block_determinants, _MM_SHUFFLE(1, 1, 1, 1));
+        __m128 const det_c = _mm_shuffle_ps(block_determinants, block_determinants, _MM_SHUFFLE(2, 2, 2, 2));
+        __m128 const det_d = _mm_shuffle_ps(block_determinants, block_determinants, _MM_SHUFFLE(3, 3, 3, 3));
+
+        __m128 const d_c = detail::mat2_adj_mul(d, c);
+        __m128 const a_b = detail::mat2_adj_mul(a, b);
+        // Adjugates of the blocks of the inverse scaled by the determinant of m.
+        __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), detail::mat2_mul(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), detail::mat2_mul(c, a_b));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), detail::mat2_mul_adj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), detail::mat2_mul_adj(a, d_c));
+
+        // |M| = |A||D| + |B||C| - tr(adjugate(A) * B * adjugate(D) * C)
+        __m128 trace = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+        trace = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+        __m128 const det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), trace);
+
+        // Negate the off-diagonal elements of the blocks to turn the adjugates back into the blocks.
+        __m128 const det_signed = _mm_mul_ps(det, _mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f));
+        x = _mm_div_ps(x, det_signed);
+        y = _mm_div_ps(y, det_signed);
+        z = _mm_div_ps(z, det_signed);
+        w = _mm_div_ps(w, det_signed);
+
+        Matrix4 r;
+        _mm_storeu_ps(&r(0, 0), _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(&r(1, 0), _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_storeu_ps(&r(2, 0), _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(&r(3, 0), _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+        return r;
+#else
         return adjugate(m) / determinant(m);
+#endif
     }
 } // namespace anton_engine::math
 
@@ -2,6 +2,7 @@
 #define CORE_MATH_QUATERNION_HPP_INCLUDE
 
 #include <core/math/math.hpp>
+#include <core/math/simd.hpp>
 
 namespace anton_engine {
     class Quaternion {
@@ -94,12 +95,27 @@ namespace anton_engine {
     }
 
     inline Quaternion operator*(Quaternion p, Quaternion q) {
+#if ANTON_MATH_SSE
+        // Evaluates the same terms in the same order as the scalar code. The w lane negates
+        // the products instead of subtracting them, which yields identical results.
+        __m128 const pv = _mm_setr_ps(p.x, p.y, p.z, p.w);
+        __m128 const qv = _mm_setr_ps(q.x, q.y, q.z, q.w);
+        __m128 const negate_w = _mm_setr_ps(0.0f, 0.0f, 0.0f, -0.0f);
+        __m128 const t0 = _mm_mul_ps(_mm_set1_ps(p.w), qv);
+        __m128 const t1 = _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(qv, qv, _MM_SHUFFLE(0, 3, 3, 3)), _mm_shuffle_ps(pv, pv, _MM_SHUFFLE(0, 2, 1, 0))), negate_w);
+        __m128 const t2 = _mm_xor_ps(_mm_mul_ps(_mm_shuffle_ps(pv, pv, _MM_SHUFFLE(1, 0, 2, 1)), _mm_shuffle_ps(qv, qv, _MM_SHUFFLE(1, 1, 0, 2))), negate_w);
+        __m128 const t3 = _mm_mul_ps(_mm_shuffle_ps(pv, pv, _MM_SHUFFLE(2, 1, 0, 2)), _mm_shuffle_ps(qv, qv, _MM_SHUFFLE(2, 0, 2, 1)));
+        alignas(16) float r[4];
+        _mm_store_ps(r, _mm_sub_ps(_mm_add_ps(_mm_add_ps(t0, t1), t2), t3));
+        return {r[0], r[1], r[2], r[3]};
+#else
         // clang-format off
         return {p.w * q.x + q.w * p.x + p.y * q.z - p.z * q.y,
                 p.w * q.y + q.w * p.y + p.z * q.x - p.x * q.z,
                 p.w * q.z + q.w * p.z + p.x * q.y - p.y * q.x,
                 p.w * q.w - p.x * q.x - p.y * q.y - p.z * q.z};
         // clang-format on
+#endif
     }
 
     inline Quaternion operator*(Quaternion const& q, float a) {
@@ -0,0 +1,33 @@
+#ifndef CORE_MATH_SIMD_HPP_INCLUDE
+#define CORE_MATH_SIMD_HPP_INCLUDE
+
+#include <build_config.hpp>
+
+// ANTON_HAS_SSE2 is 1 when the target supports SSE2.
+// ANTON_MATH_SSE is 1 when ANTON_MATH_SIMD is enabled and the target supports SSE2.
+//
+// Code whose SSE implementation is bit-identical to the scalar one (the batched
+// math::transform::scale_rotate_translate) is keyed on ANTON_HAS_SSE2 and does not depend on ANTON_MATH_SIMD.
+//
+// Tolerances of the SSE implementations relative to the scalar ones:
+//   operator*(Matrix4, Matrix4), operator*(Vector4, Matrix4), operator*(Quaternion, Quaternion),
+//   math::transform::scale_rotate_translate(Transform_Arrays const&, i64, Matrix4*)
+//     - bit-identical. The products and sums are evaluated in the same order.
+//   math::inverse(Matrix4)
+//     - computed with 2x2 block cofactors instead of 3x3 minors. For transforms built from
+//       scale, rotation and translation the elements differ from the scalar result by at most 64 ULP
+//       or 1e-5 absolute, whichever is larger. Ill-conditioned matrices may differ by more.
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define ANTON_HAS_SSE2 1
+#    include <xmmintrin.h>
+#else
+#    define ANTON_HAS_SSE2 0
+#endif
+
+#if ANTON_MATH_SIMD && ANTON_HAS_SSE2
+#    define ANTON_MATH_SSE 1
+#else
+#    define ANTON_MATH_SSE 0
+#endif
+
+#endif // !CORE_MATH_SIMD_HPP_INCLUDE
@@ -20,6 +20,23 @@ namespace anton_engine::math::transform {
     Matrix4 perspective(float fov, float aspect_ratio, float near, float far);
 
     Vector3 get_translation(Matrix4);
+
+    // Equivalent to scale(scale) * rotate(rotation) * translate(translation),
+    // but computed directly from the closed-form expression without multiplying the matrices.
+    Matrix4 scale_rotate_translate(Vector3 scale, Quaternion rotation, Vector3 translation);
+
+    // Transform_Arrays
+    // Components of transforms stored in separate arrays, e.g. rotation[0] points to the x components of all rotations.
+    //
+    struct Transform_Arrays {
+        float const* rotation[4];
+        float const* translation[3];
+        float const* scale[3];
+    };
+
+    // Computes scale_rotate_translate of count transforms and writes the matrices to out.
+    // Processes 4 transforms at a time with SSE when it is available.
+    void scale_rotate_translate(Transform_Arrays const& transforms, i64 count, Matrix4* out);
 } // namespace anton_engine::math::transform
 
 namespace anton_engine::math::transform {
@@ -84,6 +101,13 @@ namespace anton_engine::math::transform {
     inline Vector3 get_translation(Matrix4 mat) {
         return {mat[3][0], mat[3][1], mat[3][2]};
     }
+
+    inline Matrix4 scale_rotate_translate(Vector3 const scale, Quaternion const q, Vector3 const translation) {
+        return {{scale.x * (1 - 2 * q.y * q.y - 2 * q.z * q.z), scale.x * (2 * q.x * q.y + 2 * q.z * q.w), scale.x * (2 * q.x * q.z - 2 * q.y * q.w), 0},
+                {scale.y * (2 * q.x * q.y - 2 * q.z * q.w), scale.y * (1 - 2 * q.x * q.x - 2 * q.z * q.z), scale.y * (2 * q.y * q.z + 2 * q.x * q.w), 0},
+                {scale.z * (2 * q.x * q.z + 2 * q.y * q.w), scale.z * (2 * q.y * q.z - 2 * q.x * q.w), scale.z * (1 - 2 * q.x * q.x - 2 * q.y * q.y), 0},
+                {translation.x, translation.y, translation.z, 1}};
+    }
 } // namespace anton_engine::math::transform
 
 #endif // !CORE_MATH_TRANSFORM_HPP_INCLUDE
@@ -0,0 +1,75 @@
+#ifndef CORE_NAME_HPP_INCLUDE
+#define CORE_NAME_HPP_INCLUDE
+
+#include <core/atl/detail/functors.hpp>
+#include <core/atl/string_view.hpp>
+#include <core/hashing/wyhash.hpp>
+#include <core/types.hpp>
+
+namespace anton_engine {
+    // Name_Literal
+    // String literal along with its hash, which is computed at compile time when created with the _name literal.
+    // Converting to Name does not hash the characters again, but it still probes the table and compares
+    // the characters, therefore code that runs every frame should convert once into a function-local static Name.
+    //
+    struct Name_Literal {
+        atl::String_View string;
+        u64 hash;
+    };
+
+    // The size parameter of literal operators must be size_t.
+    constexpr Name_Literal operator""_name(char8 const* const string, decltype(sizeof(0)) const size) {
+        atl::String_View const view(string, static_cast<i64>(size));
+        return {view, atl::hash(view)};
+    }
+
+    // Name
+    // Identifier interned in a global table. Comparing and hashing Names compares and hashes
+    // their 32 bit indices instead of the strings.
+    // The table is thread-safe. Looking up the names that are already interned does not lock.
+    // The table and the storage for the characters have a fixed capacity and the names are never removed,
+    // therefore Name is meant for identifiers (e.g. names of actions or uniforms) and not arbitrary text.
+    //
+    class Name {
+    public:
+        // Constructs the empty name.
+        constexpr Name() = default;
+        // Interns string.
+        explicit Name(atl::String_View string);
+        // Interns literal using its precomputed hash.
+        Name(Name_Literal literal);
+
+        // Returns: The interned null-terminated string.
+        [[nodiscard]] atl::String_View get_string() const;
+        // Returns: The index of the name in the table. The empty name has index 0.
+        [[nodiscard]] constexpr u32 get_id() const {
+            return _id;
+        }
+
+    private:
+        u32 _id = 0;
+    };
+
+    [[nodiscard]] constexpr bool operator==(Name const lhs, Name const rhs) {
+        return lhs.get_id() == rhs.get_id();
+    }
+
+    [[nodiscard]] constexpr bool operator!=(Name const lhs, Name const rhs) {
+        return lhs.get_id() != rhs.get_id();
+    }
+
+    [[nodiscard]] constexpr u64 hash(Name const name) {
+        return wyhash_u64(name.get_id());
+    }
+} // namespace anton_engine
+
+namespace anton_engine::atl {
+    template<>
+    struct Default_Hash<Name> {
+        u64 operator()(Name const name) const {
+            return hash(name);
+        }
+    };
+} // namespace anton_engine::atl
+
+#endif // !CORE_NAME_HPP_INCLUDE
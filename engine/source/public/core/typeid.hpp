@@ -3,21 +3,29 @@
 
 #include <core/types.hpp>
 #include <core/atl/string_view.hpp>
+#include <core/hashing/murmurhash2.hpp>
 
 namespace anton_engine {
+    // type_identifier
+    // Stable identifier of the types Ts... that is safe to persist.
+    // The identifier is computed at compile time.
+    // Scene archives store the identifiers, which hash the signature of this function, therefore
+    // neither the declaration (constexpr would appear in __PRETTY_FUNCTION__) nor the hash and its seed may change.
+    //
     template <typename... Ts>
     u64 type_identifier() {
         // TODO use only types instead of the entire signature
 #if defined(__clang__) || defined(__GNUC__)
-        atl::String_View const signature = __PRETTY_FUNCTION__;
+        constexpr atl::String_View signature = __PRETTY_FUNCTION__;
 #elif defined(_MSC_VER)
         // return_type calling_convention func_name<template_parameters>(arguments)
-        atl::String_View const signature = __FUNCSIG__;
+        constexpr atl::String_View signature = __FUNCSIG__;
 #else
         static_assert(false, "Compiling with unknown compiler. Cannot stringify template arguments");
 #endif
 
-        return atl::hash(signature);
+        constexpr u64 identifier = murmurhash2_64(signature.bytes_begin(), signature.size_bytes(), 547391837);
+        return identifier;
     }
 } // namespace anton_engine
 
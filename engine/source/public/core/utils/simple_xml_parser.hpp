@@ -1,3 +1,4 @@
+#include <core/atl/small_vector.hpp>
 #include <core/atl/vector.hpp>
 #include <core/atl/string.hpp>
 #include <core/atl/string_view.hpp>
@@ -13,7 +14,7 @@ namespace anton_engine::utils {
 
         struct Tag {
             atl::String name;
-            atl::Vector<Tag_Property> properties;
+            atl::Small_Vector<Tag_Property, 4> properties;
             Tag_Type type;
         };
 
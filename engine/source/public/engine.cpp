@@ -1,8 +1,10 @@
 #include <engine.hpp>
 
 #include <core/types.hpp>
+#include <core/atl/allocator.hpp>
 #include <core/atl/utility.hpp>
 #include <engine/assets.hpp>
+#include <engine/ecs/command_buffer.hpp>
 #include <engine/ecs/ecs.hpp>
 #include <engine/ecs/entity.hpp>
 #include <engine/input.hpp>
@@ -12,6 +14,7 @@
 #include <core/paths_internal.hpp>
 #include <engine/resource_manager.hpp>
 #include <engine/time_internal.hpp>
+#include <engine/transform_hierarchy.hpp>
 #include <core/filesystem.hpp>
 #include <windowing/window.hpp>
 
@@ -30,6 +33,7 @@
 #include <engine/components/point_light_component.hpp>
 #include <engine/components/static_mesh_component.hpp>
 #include <engine/components/transform.hpp>
+#include <engine/components/world_transform.hpp>
 #include <scripts/debug_hotkeys.hpp>
 #include <core/math/math.hpp>
 #include <core/math/noise.hpp>
@@ -45,6 +49,7 @@
 namespace anton_engine {
     static rendering::Renderer* renderer = nullptr;
     static ECS* ecs = nullptr;
+    static Transform_Hierarchy* transform_hierarchy = nullptr;
     static windowing::Window* main_window = nullptr;
     static windowing::OpenGL_Context* gl_context = nullptr;
     static Resource_Manager<Mesh>* mesh_manager = nullptr;
@@ -61,7 +66,7 @@ namespace anton_engine {
         atl::String const bindings_file_path = fs::concat_paths(paths::executable_directory(), u8"input_bindings.config");
         atl::String const config_file = assets::read_file_raw_string(bindings_file_path);
         {
-            auto find_property = [](auto& properties, auto predicate) -> atl::Vector<utils::xml::Tag_Property>::iterator {
+            auto find_property = [](auto& properties, auto predicate) -> utils::xml::Tag_Property* {
                 auto end = properties.end();
                 for (auto iter = properties.begin(); iter != end; ++iter) {
                     if (predicate(*iter)) {
@@ -102,10 +107,10 @@ namespace anton_engine {
                         ANTON_LOG_INFO("Missing scale property, skipping...");
                         continue;
                     }
-                    input::add_axis(axis_prop->value.data(), key_from_string(key_prop->value), atl::str_to_f32(sensitivity_prop->value),
+                    input::add_axis(Name(axis_prop->value), key_from_string(key_prop->value), atl::str_to_f32(sensitivity_prop->value),
                                     atl::str_to_f32(accumulation_speed_prop->value), false);
                 } else {
-                    input::add_action(action_prop->value.data(), key_from_string(key_prop->value));
+                    input::add_action(Name(action_prop->value), key_from_string(key_prop->value));
                 }
             }
         }
@@ -203,7 +208,12 @@ namespace anton_engine {
         shader_manager = new Resource_Manager<Shader>();
         material_manager = new Resource_Manager<Material>();
         load_input_bindings();
-        ecs = new ECS();
+        ecs = new ECS(ANTON_ECS_ARCHETYPE_STORAGE ? Storage_Mode::archetype : Storage_Mode::sparse_set);
+        if (ecs->get_storage_mode() == Storage_Mode::sparse_set) {
+            // Keeps the transforms of static meshes at the same indices as the meshes, which lets the renderer skip the lookups.
+            ecs->group<Static_Mesh_Component, Transform>();
+            transform_hierarchy = new Transform_Hierarchy(*ecs);
+        }
 
         Vector2 const window_dims = windowing::get_window_size(main_window);
         renderer = new rendering::Renderer(window_dims.x, window_dims.y);
@@ -228,6 +238,7 @@ namespace anton_engine {
         postprocess_back = new Framebuffer(postprocess_info);
         postprocess_front = new Framebuffer(postprocess_info);
 
+        init_jobs();
         init_systems();
 
         load_world();
@@ -390,9 +401,12 @@ namespace anton_engine {
     }
 
     static void terminate() {
+        terminate_jobs();
         delete renderer;
         renderer = nullptr;
         unload_builtin_shaders();
+        delete transform_hierarchy;
+        transform_hierarchy = nullptr;
         delete ecs;
         ecs = nullptr;
         delete material_manager;
@@ -415,7 +429,7 @@ namespace anton_engine {
         glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
         rendering::bind_mesh_vao();
         ECS& ecs = Engine::get_ecs();
-        ECS snapshot = ecs.snapshot<Transform, Static_Mesh_Component>();
+        ECS snapshot = ecs.snapshot<Transform, World_Transform, Static_Mesh_Component>(Snapshot_Mode::shared);
         rendering::render_scene(snapshot, camera_transform, view_mat, projection_mat);
 
         // Postprocessing
@@ -428,10 +442,14 @@ namespace anton_engine {
 
         Shader& deferred_shading = get_builtin_shader(Builtin_Shader::deferred_shading);
         deferred_shading.use();
-        deferred_shading.set_vec3("camera.position", camera_transform.local_position);
-        deferred_shading.set_vec2("viewport_size", viewport_size);
-        deferred_shading.set_matrix4("inv_view_mat", inv_view_mat);
-        deferred_shading.set_matrix4("inv_proj_mat", inv_proj_mat);
+        static Name const camera_position_uniform = "camera.position"_name;
+        static Name const viewport_size_uniform = "viewport_size"_name;
+        static Name const inv_view_mat_uniform = "inv_view_mat"_name;
+        static Name const inv_proj_mat_uniform = "inv_proj_mat"_name;
+        deferred_shading.set_vec3(camera_position_uniform, camera_transform.local_position);
+        deferred_shading.set_vec2(viewport_size_uniform, viewport_size);
+        deferred_shading.set_matrix4(inv_view_mat_uniform, inv_view_mat);
+        deferred_shading.set_matrix4(inv_proj_mat_uniform, inv_proj_mat);
         rendering::render_texture_quad();
     }
 
@@ -444,6 +462,7 @@ namespace anton_engine {
         for (Entity const entity: camera_mov_view) {
             auto [camera_mov, camera, transform] = camera_mov_view.get<Camera_Movement, Camera, Transform>(entity);
             Camera_Movement::update(camera_mov, camera, transform);
+            ecs->mark_dirty<Transform>(entity);
         }
 
         auto dbg_hotkeys = ecs->view<Debug_Hotkeys>();
@@ -453,6 +472,10 @@ namespace anton_engine {
 
         update_systems();
         execute_jobs();
+        playback_thread_command_buffers(*ecs);
+        if (transform_hierarchy) {
+            transform_hierarchy->update();
+        }
 
         // TODO make this rendering code great again (not that it ever was great, but still)
         rendering::update_dynamic_lights();
@@ -473,13 +496,16 @@ namespace anton_engine {
                 glBindTextureUnit(0, postprocess_front->get_color_texture(0));
                 Shader& gamma_correction_shader = get_builtin_shader(Builtin_Shader::gamma_correction);
                 gamma_correction_shader.use();
-                gamma_correction_shader.set_float("gamma", 1 / 2.2f);
+                static Name const gamma_uniform = "gamma"_name;
+                gamma_correction_shader.set_float(gamma_uniform, 1 / 2.2f);
                 rendering::render_texture_quad();
                 break;
             }
         }
 
         windowing::swap_buffers(main_window);
+        // Nothing allocated from the frame allocator outlives the frame.
+        atl::get_frame_allocator().reset();
     }
 
     int engine_main(int argc, char** argv) {
@@ -1,17 +1,20 @@
 #ifndef ENGINE_COMPONENTS_HIERARCHY_HPP_INCLUDE
 #define ENGINE_COMPONENTS_HIERARCHY_HPP_INCLUDE
 
-#include <core/atl/fixed_array.hpp>
 #include <core/class_macros.hpp>
 #include <engine/ecs/entity.hpp>
 #include <core/serialization/serialization.hpp>
 
 namespace anton_engine {
+    // The children of an entity form a doubly linked list threaded through their Hierarchy components,
+    // therefore the number of children is not limited.
+    // Use Transform_Hierarchy::set_parent to modify the hierarchy.
     class COMPONENT Hierarchy {
     public:
-        Entity parent;
-        // TODO: Right now supports only 16 children.
-        atl::Fixed_Array<Entity, 16> children;
+        Entity parent = null_entity;
+        Entity first_child = null_entity;
+        Entity next_sibling = null_entity;
+        Entity previous_sibling = null_entity;
     };
 } // namespace anton_engine
 
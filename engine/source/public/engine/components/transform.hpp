@@ -32,14 +32,12 @@ namespace anton_engine {
         }
 
         Matrix4 to_matrix() const {
-            Matrix4 mat = math::transform::scale(local_scale) * math::transform::rotate(local_rotation) * math::transform::translate(local_position);
-            return mat;
+            return math::transform::scale_rotate_translate(local_scale, local_rotation, local_position);
         }
     };
 
     inline Matrix4 to_matrix(Transform const t) {
-        Matrix4 mat = math::transform::scale(t.local_scale) * math::transform::rotate(t.local_rotation) * math::transform::translate(t.local_position);
-        return mat;
+        return math::transform::scale_rotate_translate(t.local_scale, t.local_rotation, t.local_position);
     }
 } // namespace anton_engine
 
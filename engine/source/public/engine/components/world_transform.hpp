@@ -0,0 +1,19 @@
+#ifndef ENGINE_COMPONENTS_WORLD_TRANSFORM_HPP_INCLUDE
+#define ENGINE_COMPONENTS_WORLD_TRANSFORM_HPP_INCLUDE
+
+#include <core/class_macros.hpp>
+#include <core/math/matrix4.hpp>
+#include <core/serialization/serialization.hpp>
+
+namespace anton_engine {
+    // World space matrix of the Transform of an entity, which accounts for the transforms of its ancestors.
+    // Written by Transform_Hierarchy::update and should not be modified otherwise.
+    class COMPONENT World_Transform {
+    public:
+        Matrix4 matrix = Matrix4::identity;
+    };
+} // namespace anton_engine
+
+ANTON_DEFAULT_SERIALIZABLE(anton_engine::World_Transform)
+
+#endif // !ENGINE_COMPONENTS_WORLD_TRANSFORM_HPP_INCLUDE
@@ -0,0 +1,462 @@
+#ifndef ENGINE_ECS_ARCHETYPE_STORAGE_HPP_INCLUDE
+#define ENGINE_ECS_ARCHETYPE_STORAGE_HPP_INCLUDE
+
+#include <core/assert.hpp>
+#include <core/atl/type_traits.hpp>
+#include <core/atl/utility.hpp>
+#include <core/atl/vector.hpp>
+#include <core/math/math.hpp>
+#include <core/types.hpp>
+#include <core/typeid.hpp>
+#include <engine/ecs/component_container.hpp>
+#include <engine/ecs/component_type.hpp>
+#include <engine/ecs/entity.hpp>
+
+namespace anton_engine {
+    // Type-erased operations on a component type stored in an Archetype_Storage.
+    struct Component_Type_Info {
+        u64 family;
+        i64 type_index;
+        // Size of the component in bytes. 0 for empty components, which do not occupy any storage.
+        i64 size;
+        i64 alignment;
+        // Move constructs the component at dst from the component at src and destroys the latter.
+        void (*relocate)(void* dst, void* src);
+        void (*copy)(void* dst, void const* src);
+        // Constructs count components at dst as copies of prototype or value-initialized if prototype is nullptr.
+        void (*construct_n)(void* dst, i64 count, void const* prototype);
+        void (*destruct)(void*);
+        // Used to convert the components to sparse set storage (serialization).
+        Component_Container_Base* (*make_container)();
+        void (*add_to_container)(Component_Container_Base&, Entity, void const*);
+    };
+
+    template <typename T>
+    [[nodiscard]] Component_Type_Info const* component_type_info();
+
+    // Archetype_Storage
+    // Groups entities by the set of components attached to them (archetype).
+    // Entities of an archetype are packed into chunks of chunk_size bytes. A chunk stores an array of entities
+    // followed by one array per component type (structure of arrays), therefore iterating the components
+    // of an archetype streams linearly through memory without any per-entity lookups.
+    // Adding or removing a component moves the entity along with its components to another archetype,
+    // which invalidates references to components and iterators of the storage.
+    //
+    class Archetype_Storage {
+    public:
+        // Size of a single chunk in bytes.
+        // Archetypes whose single row does not fit in chunk_size use larger chunks holding a single row.
+        constexpr static i64 chunk_size = 16384;
+
+        struct Archetype_Edge {
+            i64 type_index;
+            // Index of the archetype with the component added or removed. -1 if not resolved yet.
+            i64 add;
+            i64 remove;
+        };
+
+        struct Archetype {
+            // Type indices of the components sorted in ascending order.
+            atl::Vector<i64> types;
+            atl::Vector<Component_Type_Info const*> infos;
+            // Offset of the array of each component from the beginning of a chunk.
+            atl::Vector<i64> offsets;
+            // All chunks except for the last one are full.
+            atl::Vector<u8*> chunks;
+            atl::Vector<Archetype_Edge> edges;
+            // Number of rows in a single chunk.
+            i64 capacity;
+            i64 chunk_bytes;
+            i64 chunk_alignment;
+            // Number of entities in the archetype.
+            i64 size = 0;
+        };
+
+        Archetype_Storage();
+        Archetype_Storage(Archetype_Storage const&);
+        Archetype_Storage& operator=(Archetype_Storage const&) = delete;
+        ~Archetype_Storage();
+
+        // Places entity in the archetype without any components.
+        void create(Entity);
+        struct Row_Range {
+            i64 archetype;
+            i64 first_row;
+        };
+
+        // Places count entities that are not in the storage yet in the archetype with the components described
+        // by infos. The component of type infos[i] is constructed as a copy of prototypes[i] for every entity
+        // or value-initialized if prototypes[i] is nullptr. infos must not contain duplicates.
+        // Returns: The archetype and the first of the consecutive rows the entities have been placed in.
+        Row_Range create_many(Entity const* entities, i64 count, Component_Type_Info const* const* infos, void const* const* prototypes, i64 type_count);
+        // Destroys the components of entity and removes it from the storage.
+        // Does nothing if entity is not in the storage.
+        void destroy(Entity);
+        [[nodiscard]] bool contains(Entity) const;
+        [[nodiscard]] bool has(Entity, i64 type_index) const;
+
+        template <typename T, typename... Args>
+        T& add(Entity, Args&&...);
+        template <typename T>
+        void remove(Entity);
+        template <typename T>
+        [[nodiscard]] T* try_get(Entity);
+        template <typename T>
+        [[nodiscard]] T const* try_get(Entity) const;
+
+        // Returns: Number of entities that have component T.
+        template <typename T>
+        [[nodiscard]] i64 count() const;
+
+        // Calls callable(Entity, T const&) for every entity that has component T.
+        template <typename T, typename Callable>
+        void for_each(Callable&& callable) const;
+
+        [[nodiscard]] i64 archetype_count() const;
+        [[nodiscard]] Archetype const& get_archetype(i64 index) const;
+        // Type info of every component type that has been added to the storage.
+        [[nodiscard]] atl::Vector<Component_Type_Info const*> const& get_component_types() const;
+        // Returns: Newly allocated container holding copies of all components of the type described by info.
+        [[nodiscard]] Component_Container_Base* make_container(Component_Type_Info const* info) const;
+#if ANTON_ECS_ITERATION_DEBUG
+        // Returns: Counter advanced every time a row is added to or removed from any archetype.
+        [[nodiscard]] u64 get_structure_version() const;
+#endif
+
+        // Returns: true if archetype contains all components with the given type indices.
+        [[nodiscard]] static bool matches(Archetype const&, i64 const* types, i64 count);
+        // Returns: Index of the component array in archetype or -1 if archetype does not contain the component.
+        [[nodiscard]] static i64 find_column(Archetype const&, i64 type_index);
+        // Returns: Number of rows in chunk.
+        [[nodiscard]] static i64 chunk_rows(Archetype const&, i64 chunk);
+        [[nodiscard]] static Entity* chunk_entities(Archetype const&, i64 chunk);
+        template <typename T>
+        [[nodiscard]] static T* chunk_components(Archetype const&, i64 chunk, i64 column);
+
+    private:
+        struct Entity_Location {
+            // -1 if the entity is not in the storage.
+            i64 archetype;
+            i64 row;
+        };
+
+        atl::Vector<Archetype> archetypes;
+        // Indexed by entity index.
+        atl::Vector<Entity_Location> locations;
+        atl::Vector<Component_Type_Info const*> component_types;
+#if ANTON_ECS_ITERATION_DEBUG
+        u64 structure_version = 0;
+#endif
+
+        [[nodiscard]] Entity_Location const* find_location(Entity) const;
+        [[nodiscard]] static void* component_address(Archetype const&, i64 column, i64 row);
+        i64 find_or_create_archetype(atl::Vector<i64> const& types, atl::Vector<Component_Type_Info const*> const& infos);
+        // Returns: Index of the archetype with the component described by info added to archetype.
+        i64 add_transition(i64 archetype, Component_Type_Info const* info);
+        // Returns: Index of the archetype with the component with type_index removed from archetype.
+        i64 remove_transition(i64 archetype, i64 type_index);
+        // Appends an uninitialized row for entity to archetype.
+        // Returns: Index of the row.
+        i64 push_row(i64 archetype, Entity);
+        // Appends count uninitialized rows for entities to archetype.
+        // Returns: Index of the first row.
+        i64 push_rows(i64 archetype, Entity const* entities, i64 count);
+        // Removes the last row of archetype whose components have not been constructed.
+        void pop_row(i64 archetype);
+        // Fills the hole at row, whose components have already been destroyed or moved from, with the last row of archetype.
+        void erase_row(i64 archetype, i64 row);
+        // Moves the components of entity that exist in target_archetype to target_row and removes the entity from its current archetype.
+        // Components that do not exist in target_archetype are destroyed.
+        void move_entity(Entity, i64 target_archetype, i64 target_row);
+    };
+
+    // Archetype_Iterator
+    // Iterates the entities of all archetypes that contain the components with the given type indices.
+    //
+    template <i64 N>
+    class Archetype_Iterator {
+    public:
+        using value_type = Entity;
+        using reference = Entity&;
+        using pointer = Entity*;
+        using difference_type = isize;
+        using iterator_category = atl::Forward_Iterator_Tag;
+
+        Archetype_Iterator() = default;
+
+        Archetype_Iterator(Archetype_Storage const* s, i64 const (&t)[N], bool const end): storage(s) {
+            for (i64 i = 0; i < N; ++i) {
+                types[i] = t[i];
+            }
+
+            if (end) {
+                archetype = storage->archetype_count();
+            } else {
+                archetype = 0;
+                chunk = -1;
+                next_chunk();
+            }
+        }
+
+        Archetype_Iterator& operator++() {
+            ++row;
+            if (row == rows) {
+                next_chunk();
+            }
+            return *this;
+        }
+
+        pointer operator->() const {
+            return entities + row;
+        }
+
+        reference operator*() const {
+            return entities[row];
+        }
+
+        [[nodiscard]] friend bool operator==(Archetype_Iterator const& a, Archetype_Iterator const& b) {
+            return a.archetype == b.archetype && a.chunk == b.chunk && a.row == b.row;
+        }
+
+        [[nodiscard]] friend bool operator!=(Archetype_Iterator const& a, Archetype_Iterator const& b) {
+            return !(a == b);
+        }
+
+    private:
+        Archetype_Storage const* storage = nullptr;
+        i64 types[N] = {};
+        i64 archetype = 0;
+        i64 chunk = 0;
+        i64 row = 0;
+        i64 rows = 0;
+        Entity* entities = nullptr;
+
+        // Moves to the first row of the next non-empty chunk of a matching archetype or to the end.
+        void next_chunk() {
+            row = 0;
+            ++chunk;
+            for (i64 const count = storage->archetype_count(); archetype < count; ++archetype, chunk = 0) {
+                Archetype_Storage::Archetype const& a = storage->get_archetype(archetype);
+                if (chunk < a.chunks.size() && Archetype_Storage::matches(a, types, N)) {
+                    rows = Archetype_Storage::chunk_rows(a, chunk);
+                    entities = Archetype_Storage::chunk_entities(a, chunk);
+                    return;
+                }
+            }
+
+            chunk = 0;
+            rows = 0;
+            entities = nullptr;
+        }
+    };
+} // namespace anton_engine
+
+namespace anton_engine {
+    template <typename T>
+    inline Component_Type_Info const* component_type_info() {
+        static Component_Type_Info const info = {
+            type_identifier<T>(),
+            component_type_index<T>(),
+            atl::is_empty<T> ? 0 : static_cast<i64>(sizeof(T)),
+            static_cast<i64>(alignof(T)),
+            [](void* const dst, void* const src) {
+                if constexpr (!atl::is_empty<T>) {
+                    ::new (dst) T(atl::move(*static_cast<T*>(src)));
+                    static_cast<T*>(src)->~T();
+                }
+            },
+            [](void* const dst, void const* const src) {
+                if constexpr (!atl::is_empty<T>) {
+                    ::new (dst) T(*static_cast<T const*>(src));
+                }
+            },
+            [](void* const dst, i64 const count, void const* const prototype) {
+                construct_components(static_cast<T*>(dst), count, static_cast<T const*>(prototype));
+            },
+            [](void* const ptr) {
+                if constexpr (!atl::is_empty<T>) {
+                    static_cast<T*>(ptr)->~T();
+                }
+            },
+            []() -> Component_Container_Base* { return new Component_Container<T>(); },
+            [](Component_Container_Base& container, Entity const entity, void const* const component) {
+                if constexpr (atl::is_empty<T>) {
+                    static_cast<Component_Container<T>&>(container).add(entity);
+                } else {
+                    static_cast<Component_Container<T>&>(container).add(entity, *static_cast<T const*>(component));
+                }
+            },
+        };
+        return &info;
+    }
+
+    inline i64 Archetype_Storage::archetype_count() const {
+        return archetypes.size();
+    }
+
+    inline Archetype_Storage::Archetype const& Archetype_Storage::get_archetype(i64 const index) const {
+        return archetypes[index];
+    }
+
+    inline atl::Vector<Component_Type_Info const*> const& Archetype_Storage::get_component_types() const {
+        return component_types;
+    }
+
+#if ANTON_ECS_ITERATION_DEBUG
+    inline u64 Archetype_Storage::get_structure_version() const {
+        return structure_version;
+    }
+#endif
+
+    inline bool Archetype_Storage::matches(Archetype const& archetype, i64 const* const types, i64 const count) {
+        for (i64 i = 0; i < count; ++i) {
+            if (find_column(archetype, types[i]) == -1) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    inline i64 Archetype_Storage::find_column(Archetype const& archetype, i64 const type_index) {
+        // Archetypes rarely have more than a handful of components. Linear search over the sorted types.
+        for (i64 i = 0; i < archetype.types.size(); ++i) {
+            if (archetype.types[i] >= type_index) {
+                return archetype.types[i] == type_index ? i : -1;
+            }
+        }
+        return -1;
+    }
+
+    inline i64 Archetype_Storage::chunk_rows(Archetype const& archetype, i64 const chunk) {
+        return math::min(archetype.capacity, archetype.size - chunk * archetype.capacity);
+    }
+
+    inline Entity* Archetype_Storage::chunk_entities(Archetype const& archetype, i64 const chunk) {
+        return reinterpret_cast<Entity*>(archetype.chunks[chunk]);
+    }
+
+    template <typename T>
+    inline T* Archetype_Storage::chunk_components(Archetype const& archetype, i64 const chunk, i64 const column) {
+        return reinterpret_cast<T*>(archetype.chunks[chunk] + archetype.offsets[column]);
+    }
+
+    inline void* Archetype_Storage::component_address(Archetype const& archetype, i64 const column, i64 const row) {
+        u8* const chunk = archetype.chunks[row / archetype.capacity];
+        return chunk + archetype.offsets[column] + (row % archetype.capacity) * archetype.infos[column]->size;
+    }
+
+    inline Archetype_Storage::Entity_Location const* Archetype_Storage::find_location(Entity const entity) const {
+        u64 const index = entity_index(entity);
+        if (index >= static_cast<u64>(locations.size())) {
+            return nullptr;
+        }
+
+        Entity_Location const& location = locations[index];
+        if (location.archetype == -1) {
+            return nullptr;
+        }
+
+        Archetype const& archetype = archetypes[location.archetype];
+        Entity const* const entities = chunk_entities(archetype, location.row / archetype.capacity);
+        return entities[location.row % archetype.capacity] == entity ? &location : nullptr;
+    }
+
+    inline bool Archetype_Storage::contains(Entity const entity) const {
+        return find_location(entity) != nullptr;
+    }
+
+    inline bool Archetype_Storage::has(Entity const entity, i64 const type_index) const {
+        Entity_Location const* const location = find_location(entity);
+        return location && find_column(archetypes[location->archetype], type_index) != -1;
+    }
+
+    template <typename T, typename... Args>
+    T& Archetype_Storage::add(Entity const entity, Args&&... args) {
+        ANTON_ASSERT(contains(entity), "Attempting to add component to an entity that is not in the storage");
+        ANTON_ASSERT(!has(entity, component_type_index<T>()), "Attempting to add duplicate component");
+        Entity_Location const location = locations[entity_index(entity)];
+        i64 const target = add_transition(location.archetype, component_type_info<T>());
+        i64 const row = push_row(target, entity);
+        Archetype const& archetype = archetypes[target];
+        T* const component = static_cast<T*>(component_address(archetype, find_column(archetype, component_type_index<T>()), row));
+        if constexpr (!atl::is_empty<T>) {
+            try {
+                if constexpr (atl::is_constructible<T, Args&&...>) {
+                    ::new (component) T(atl::forward<Args>(args)...);
+                } else {
+                    ::new (component) T{atl::forward<Args>(args)...};
+                }
+            } catch (...) {
+                pop_row(target);
+                throw;
+            }
+        }
+
+        move_entity(entity, target, row);
+        return *component;
+    }
+
+    template <typename T>
+    void Archetype_Storage::remove(Entity const entity) {
+        ANTON_ASSERT(has(entity, component_type_index<T>()), "Attempting to remove component that has not been added");
+        Entity_Location const location = locations[entity_index(entity)];
+        i64 const target = remove_transition(location.archetype, component_type_index<T>());
+        i64 const row = push_row(target, entity);
+        move_entity(entity, target, row);
+    }
+
+    template <typename T>
+    inline T* Archetype_Storage::try_get(Entity const entity) {
+        return const_cast<T*>(atl::as_const(*this).try_get<T>(entity));
+    }
+
+    template <typename T>
+    inline T const* Archetype_Storage::try_get(Entity const entity) const {
+        Entity_Location const* const location = find_location(entity);
+        if (!location) {
+            return nullptr;
+        }
+
+        Archetype const& archetype = archetypes[location->archetype];
+        i64 const column = find_column(archetype, component_type_index<T>());
+        return column != -1 ? static_cast<T const*>(component_address(archetype, column, location->row)) : nullptr;
+    }
+
+    template <typename T>
+    i64 Archetype_Storage::count() const {
+        i64 const type_index = component_type_index<T>();
+        i64 count = 0;
+        for (Archetype const& archetype: archetypes) {
+            if (find_column(archetype, type_index) != -1) {
+                count += archetype.size;
+            }
+        }
+        return count;
+    }
+
+    template <typename T, typename Callable>
+    void Archetype_Storage::for_each(Callable&& callable) const {
+        i64 const type_index = component_type_index<T>();
+        for (Archetype const& archetype: archetypes) {
+            i64 const column = find_column(archetype, type_index);
+            if (column == -1) {
+                continue;
+            }
+
+            for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                Entity const* const entities = chunk_entities(archetype, chunk);
+                T const* const components = chunk_components<T>(archetype, chunk, column);
+                i64 const rows = chunk_rows(archetype, chunk);
+                for (i64 i = 0; i < rows; ++i) {
+                    if constexpr (atl::is_empty<T>) {
+                        callable(entities[i], *components);
+                    } else {
+                        callable(entities[i], components[i]);
+                    }
+                }
+            }
+        }
+    }
+} // namespace anton_engine
+
+#endif // !ENGINE_ECS_ARCHETYPE_STORAGE_HPP_INCLUDE
@@ -0,0 +1,147 @@
+#ifndef ENGINE_ECS_COMMAND_BUFFER_HPP_INCLUDE
+#define ENGINE_ECS_COMMAND_BUFFER_HPP_INCLUDE
+
+#include <core/atl/type_traits.hpp>
+#include <core/atl/utility.hpp>
+#include <core/atl/vector.hpp>
+#include <core/types.hpp>
+#include <engine/ecs/component_type.hpp>
+#include <engine/ecs/ecs.hpp>
+#include <engine/ecs/entity.hpp>
+
+namespace anton_engine {
+    // Command_Buffer
+    // Records structural changes (creating and destroying entities, adding and removing components)
+    // that are applied to an ECS later by playback_command_buffers. Component payloads are constructed
+    // in a linear arena owned by the buffer and moved into the ECS during playback.
+    // A buffer must not be used by more than one thread at a time. Jobs should record their changes
+    // in the buffer returned by get_thread_command_buffer.
+    //
+    class Command_Buffer {
+    public:
+        Command_Buffer() = default;
+        Command_Buffer(Command_Buffer const&) = delete;
+        Command_Buffer& operator=(Command_Buffer const&) = delete;
+        ~Command_Buffer();
+
+        // Returns: Placeholder entity that may be passed to the commands of this buffer.
+        //          The entity is created and the placeholder replaced with it during playback.
+        [[nodiscard]] Entity create();
+        void destroy(Entity);
+
+        template <typename T, typename... Ctor_Args>
+        void add_component(Entity, Ctor_Args&&... args);
+        template <typename T>
+        void remove_component(Entity);
+
+        [[nodiscard]] bool empty() const;
+        // Discards all commands and destroys their payloads. Keeps the memory of the arena.
+        void clear();
+
+        friend void playback_command_buffers(ECS&, Command_Buffer* const*, i64);
+
+    private:
+        enum class Command_Type : u8 {
+            add,
+            remove,
+            destroy,
+        };
+
+        struct Command {
+            Command_Type type;
+            Entity entity;
+            // -1 for destroy.
+            i64 type_index;
+            // Component constructed in the arena for add commands of non-empty components. nullptr once moved from.
+            void* payload;
+            // Applies a sequence of add and remove commands of a single component type.
+            void (*apply)(ECS&, Command* const* first, Command* const* last);
+            // Destroys the payload. nullptr for commands without payload.
+            void (*destruct)(void*);
+        };
+
+        struct Arena_Block {
+            u8* memory;
+            i64 size;
+        };
+
+        // Size of a regular arena block. Payloads that do not fit get a block of their own.
+        constexpr static i64 arena_block_size = 65536;
+
+        atl::Vector<Command> commands;
+        atl::Vector<Arena_Block> blocks;
+        i64 current_block = 0;
+        i64 block_offset = 0;
+        // Number of placeholder entities returned by create.
+        i64 created_count = 0;
+
+        [[nodiscard]] void* allocate(i64 size, i64 alignment);
+        template <typename T, typename... Ctor_Args>
+        static void attempt_construct(T* in, Ctor_Args&&... args);
+        template <typename T>
+        static void apply_commands(ECS&, Command* const* first, Command* const* last);
+    };
+
+    // Returns: Buffer private to the calling thread. Played back by playback_thread_command_buffers.
+    [[nodiscard]] Command_Buffer& get_thread_command_buffer();
+
+    // playback_command_buffers
+    // Applies the commands of buffers to ecs as a single batch and clears the buffers.
+    // Entities are created first, then the add and remove commands are applied grouped by component type
+    // so that every container is visited once. Within a component type the commands keep the order
+    // in which they have been recorded. Entities are destroyed last.
+    // Must not be called while the buffers are being recorded into.
+    //
+    void playback_command_buffers(ECS& ecs, Command_Buffer* const* buffers, i64 count);
+
+    // Plays back the buffers returned by get_thread_command_buffer in a single batch.
+    // Must be called from a sync point when no jobs are running.
+    void playback_thread_command_buffers(ECS& ecs);
+} // namespace anton_engine
+
+namespace anton_engine {
+    template <typename T, typename... Ctor_Args>
+    inline void Command_Buffer::add_component(Entity const entity, Ctor_Args&&... args) {
+        void* payload = nullptr;
+        if constexpr (!atl::is_empty<T>) {
+            payload = allocate(sizeof(T), alignof(T));
+            attempt_construct(static_cast<T*>(payload), atl::forward<Ctor_Args>(args)...);
+        }
+
+        auto const destruct = [](void* const p) { static_cast<T*>(p)->~T(); };
+        commands.push_back(Command{Command_Type::add, entity, component_type_index<T>(), payload, apply_commands<T>, destruct});
+    }
+
+    template <typename T, typename... Ctor_Args>
+    inline void Command_Buffer::attempt_construct(T* const in, Ctor_Args&&... args) {
+        if constexpr (atl::is_constructible<T, Ctor_Args&&...>) {
+            ::new (in) T(atl::forward<Ctor_Args>(args)...);
+        } else {
+            ::new (in) T{atl::forward<Ctor_Args>(args)...};
+        }
+    }
+
+    template <typename T>
+    inline void Command_Buffer::remove_component(Entity const entity) {
+        commands.push_back(Command{Command_Type::remove, entity, component_type_index<T>(), nullptr, apply_commands<T>, nullptr});
+    }
+
+    template <typename T>
+    inline void Command_Buffer::apply_commands(ECS& ecs, Command* const* first, Command* const* const last) {
+        for (; first != last; ++first) {
+            Command& command = **first;
+            if (command.type == Command_Type::remove) {
+                ecs.remove_component<T>(command.entity);
+            } else if constexpr (atl::is_empty<T>) {
+                ecs.add_component<T>(command.entity);
+            } else {
+                T* const payload = static_cast<T*>(command.payload);
+                ecs.add_component<T>(command.entity, atl::move(*payload));
+                payload->~T();
+                command.payload = nullptr;
+            }
+        }
+    }
+} // namespace anton_engine
+
+#endif // !ENGINE_ECS_COMMAND_BUFFER_HPP_INCLUDE
@@ -1,7 +1,11 @@
 #ifndef ENGINE_ECS_COMPONENT_CONTAINER_HPP_INCLUDE
 #define ENGINE_ECS_COMPONENT_CONTAINER_HPP_INCLUDE
 
+#include <core/anton_crt.hpp>
 #include <core/assert.hpp>
+#include <core/intrinsics.hpp>
+#include <core/atl/allocator.hpp>
+#include <core/atl/memory.hpp>
 #include <core/atl/type_traits.hpp>
 #include <core/atl/vector.hpp>
 #include <engine/ecs/component_container_iterator.hpp>
@@ -10,13 +14,20 @@
 #include <core/atl/algorithm.hpp>
 
 namespace anton_engine {
+    // Constructs count components at dst as copies of prototype or value-initialized if prototype is nullptr.
+    template <typename T>
+    void construct_components(T* dst, i64 count, T const* prototype);
+
     class Component_Container_Base {
     public:
         using size_type = atl::Vector<Entity>::size_type;
         using iterator = atl::Vector<Entity>::iterator;
         using const_iterator = atl::Vector<Entity>::const_iterator;
 
-        virtual ~Component_Container_Base() = default;
+        Component_Container_Base() = default;
+        Component_Container_Base(Component_Container_Base const&);
+        Component_Container_Base& operator=(Component_Container_Base const&) = delete;
+        virtual ~Component_Container_Base();
 
         [[nodiscard]] Entity* entities();
         [[nodiscard]] Entity const* entities() const;
@@ -24,16 +35,57 @@ namespace anton_engine {
         [[nodiscard]] iterator end();
         [[nodiscard]] size_type size() const;
         [[nodiscard]] bool has(Entity) const;
+        [[nodiscard]] size_type get_component_index(Entity entity) const;
+
+        // Change tracking
+        // A container that tracks changes records for every slot the tick at which the component has been added
+        // and the tick at which it has last been marked as changed. Adding a component counts as a change.
+        // Components that are already in the container when tracking is enabled are stamped with tick.
+        void enable_change_tracking(u64 tick);
+        [[nodiscard]] bool tracks_changes() const;
+        // Sets the tick that added and changed components are stamped with.
+        void set_change_tick(u64 tick);
+        // Stamps the component of entity as changed. Does nothing if the container does not track changes.
+        void mark_changed(Entity entity);
+        // Returns: Array of ticks indexed by slot or nullptr if the container does not track changes.
+        [[nodiscard]] u64 const* added_ticks() const;
+        [[nodiscard]] u64 const* changed_ticks() const;
+#if ANTON_ECS_ITERATION_DEBUG
+        // Returns: Counter advanced every time an entity is added, removed or moved within the container.
+        [[nodiscard]] u64 get_structure_version() const;
+#endif
 
         friend void serialize(serialization::Binary_Output_Archive&, Component_Container_Base const&);
         friend void deserialize(serialization::Binary_Input_Archive&, Component_Container_Base&);
 
     protected:
         constexpr static size_type npos = static_cast<size_type>(-1);
+        // Number of consecutive slots that share a single snapshot epoch.
+        constexpr static size_type snapshot_page_size = 256;
+        // Number of entries in a single page of the sparse index.
+        constexpr static size_type indirect_page_size = 1024;
 
         void add_entity(Entity entity);
-        [[nodiscard]] size_type get_component_index(Entity entity);
+        // Appends count entities none of which may be registered in the container.
+        void add_entities(Entity const* entities, size_type count);
         void remove_entity(Entity entity);
+        // Swaps the entities in slots a and b.
+        void swap_entities(size_type a, size_type b);
+
+        // Marks the page containing slot as modified since the last snapshot update.
+        // May be called concurrently for existing slots, e.g. by non-const lookups from parallel systems,
+        // because the page epochs are only resized by structural changes and stamped atomically.
+        void touch(size_type slot);
+        // Marks the pages containing slots [first, last[ as modified since the last snapshot update.
+        void touch_range(size_type first, size_type last);
+        void touch_all();
+
+        // Copies entities and components from the pages of source that have been modified
+        // since the last call into this container, keeping the slots of both containers in sync.
+        // Pages of this container that have been modified since the last call are copied as well.
+        template <typename Component>
+        void update_snapshot_pages(Component_Container_Base const& source, atl::Vector<Component>* components,
+                                   atl::Vector<Component> const* source_components);
 
         // Sort entities and the provided component vector.
         template <typename Component, typename Sort, typename Predicate>
@@ -42,13 +94,49 @@ namespace anton_engine {
         // Sort only entities.
         void sort_entities();
 
+        // Removes the entities whose indices are set in the bitset marked and the corresponding components
+        // in a single pass, keeping the order of the remaining entities. components is nullptr for empty components.
+        // Bits past marked_count are treated as unset.
+        template <typename Component>
+        void remove_marked_entities(atl::Vector<Component>* components, u64 const* marked, size_type marked_count);
+
     private:
-        // Indices into entities vector
-        atl::Vector<size_type> _indirect;
+        // Indices into entities vector split into pages of indirect_page_size entries.
+        // Pages are allocated on demand and freed once they no longer reference any entity,
+        // so that the memory used scales with the number of entities in this container
+        // rather than with the largest entity index.
+        atl::Vector<size_type*> _indirect;
+        // Number of entities referenced by each page of _indirect.
+        atl::Vector<i32> _indirect_page_counts;
         atl::Vector<Entity> _entities;
-
+        // Epoch of the last modification of each page of slots.
+        atl::Vector<u64> _page_epochs;
+        // Current epoch. Advanced every time a snapshot is updated from this container.
+        mutable u64 _epoch = 1;
+        // Epoch in which touch_all has last stamped every page. Repeated calls in the same epoch return immediately.
+        u64 _all_touched_epoch = 0;
+        // Epoch of the source container at the time of the last snapshot update.
+        // 0 if this container has never been updated from a source.
+        u64 _synced_epoch = 0;
+        // Ticks of the slots. Empty unless _tracks_changes is true.
+        atl::Vector<u64> _added_ticks;
+        atl::Vector<u64> _changed_ticks;
+        u64 _change_tick = 0;
+        bool _tracks_changes = false;
+#if ANTON_ECS_ITERATION_DEBUG
+        u64 _structure_version = 0;
+#endif
+
+        // Extends _page_epochs to cover slot_count slots. Called only by structural changes
+        // so that touch never reallocates the array.
+        void cover_page_epochs(size_type slot_count);
         [[nodiscard]] size_type indirect_index(Entity entity) const;
-        void ensure(size_type index);
+        // Returns: Slot of the entity with index or npos if there is none.
+        [[nodiscard]] size_type find_slot(size_type index) const;
+        // Reference to the entry of a page that must have been allocated.
+        [[nodiscard]] size_type& slot_ref(size_type index);
+        void set_slot(size_type index, size_type slot);
+        void clear_slot(size_type index);
     };
 
     template <typename Component>
@@ -58,13 +146,19 @@ namespace anton_engine {
 
         static void serialize(serialization::Binary_Output_Archive& archive, Component_Container_Base const*);
         static void deserialize(serialization::Binary_Input_Archive& archive, Component_Container_Base*&);
+        // Brings snapshot up to date with source copying only the pages that have changed.
+        // Allocates snapshot if it is nullptr.
+        static void update_snapshot(Component_Container_Base const& source, Component_Container_Base*& snapshot);
 
         virtual ~Component_Container() = default;
 
         [[nodiscard]] Component* components();
         [[nodiscard]] Component const* components() const;
+        // Returns: Pointer to the components array. Only slots [first, last[ may be modified through it.
+        [[nodiscard]] Component* components(size_type first, size_type last);
 
         [[nodiscard]] iterator begin() {
+            touch_all();
             return {components(), 0};
         }
 
@@ -85,6 +179,20 @@ namespace anton_engine {
             }
         }
 
+        // Adds count entities with copies of prototype or value-initialized components if prototype is nullptr.
+        // The components are placed in consecutive slots starting at the returned one.
+        size_type add_many(Entity const* const entities, size_type const count, Component const* const prototype) {
+            size_type const first = size();
+            if constexpr (!atl::is_empty<Component>) {
+                _components.reserve(first + count);
+                construct_components(_components.data() + first, count, prototype);
+                _components.force_size(first + count);
+            }
+
+            add_entities(entities, count);
+            return first;
+        }
+
         void remove(Entity const entity) {
             if constexpr (!atl::is_empty<Component>) {
                 _components.erase_unsorted(get_component_index(entity));
@@ -93,7 +201,28 @@ namespace anton_engine {
             remove_entity(entity);
         }
 
+        // Removes all entities whose indices are set in the bitset marked of marked_count bits.
+        // Faster than calling remove for every entity when many entities are removed at once.
+        void remove_marked(u64 const* const marked, size_type const marked_count) {
+            if constexpr (atl::is_empty<Component>) {
+                remove_marked_entities(static_cast<atl::Vector<Component>*>(nullptr), marked, marked_count);
+            } else {
+                remove_marked_entities(&_components, marked, marked_count);
+            }
+        }
+
         [[nodiscard]] Component& get(Entity const entity) {
+            ANTON_ASSERT(has(entity), "Attempting to get component of an entity that has not been registered");
+            if constexpr (atl::is_empty<Component>) {
+                return _components;
+            } else {
+                size_type const index = get_component_index(entity);
+                touch(index);
+                return _components[index];
+            }
+        }
+
+        [[nodiscard]] Component const& get(Entity const entity) const {
             ANTON_ASSERT(has(entity), "Attempting to get component of an entity that has not been registered");
             if constexpr (atl::is_empty<Component>) {
                 return _components;
@@ -103,6 +232,20 @@ namespace anton_engine {
         }
 
         [[nodiscard]] Component* try_get(Entity const entity) {
+            if constexpr (atl::is_empty<Component>) {
+                return has(entity) ? &_components : nullptr;
+            } else {
+                if (!has(entity)) {
+                    return nullptr;
+                }
+
+                size_type const index = get_component_index(entity);
+                touch(index);
+                return _components.data() + index;
+            }
+        }
+
+        [[nodiscard]] Component const* try_get(Entity const entity) const {
             if constexpr (atl::is_empty<Component>) {
                 return has(entity) ? &_components : nullptr;
             } else {
@@ -110,6 +253,16 @@ namespace anton_engine {
             }
         }
 
+        // Swaps the entities and components in slots a and b.
+        void swap_slots(size_type const a, size_type const b) {
+            if constexpr (!atl::is_empty<Component>) {
+                using atl::swap;
+                swap(_components[a], _components[b]);
+            }
+
+            swap_entities(a, b);
+        }
+
         template <typename Sort, typename Predicate>
         void sort(Sort sort, Predicate predicate);
 
@@ -134,6 +287,7 @@ namespace anton_engine {
         if constexpr (atl::is_empty<Component>) {
             return &_components;
         } else {
+            touch_all();
             return _components.data();
         }
     }
@@ -147,6 +301,26 @@ namespace anton_engine {
         }
     }
 
+    template <typename Component>
+    inline Component* Component_Container<Component>::components(size_type const first, size_type const last) {
+        if constexpr (atl::is_empty<Component>) {
+            return &_components;
+        } else {
+            touch_range(first, last);
+            return _components.data();
+        }
+    }
+
+    // Empty components are not stored per entity and all entities share a single object.
+    template <typename T>
+    [[nodiscard]] inline T& component_at(T* const components, i64 const index) {
+        if constexpr (atl::is_empty<T>) {
+            return *components;
+        } else {
+            return components[index];
+        }
+    }
+
     inline Component_Container_Base::iterator Component_Container_Base::begin() {
         return _entities.begin();
     }
@@ -155,9 +329,30 @@ namespace anton_engine {
         return _entities.end();
     }
 
+    inline Component_Container_Base::Component_Container_Base(Component_Container_Base const& other)
+        : _indirect(other._indirect.size(), nullptr), _indirect_page_counts(other._indirect_page_counts), _entities(other._entities),
+          _page_epochs(other._page_epochs), _epoch(other._epoch), _all_touched_epoch(other._all_touched_epoch), _synced_epoch(other._synced_epoch),
+          _added_ticks(other._added_ticks),
+          _changed_ticks(other._changed_ticks), _change_tick(other._change_tick), _tracks_changes(other._tracks_changes) {
+        for (size_type page = 0; page < _indirect.size(); ++page) {
+            if (size_type const* const other_page = other._indirect[page]) {
+                _indirect[page] = new size_type[indirect_page_size];
+                atl::copy(other_page, other_page + indirect_page_size, _indirect[page]);
+            }
+        }
+    }
+
+    inline Component_Container_Base::~Component_Container_Base() {
+        for (size_type* const page: _indirect) {
+            delete[] page;
+        }
+    }
+
     inline bool Component_Container_Base::has(Entity const entity) const {
         auto index = indirect_index(entity);
-        return index < _indirect.size() && _indirect[index] != npos;
+        // Compare the whole entity to reject stale handles whose index has been recycled.
+        size_type const slot = find_slot(index);
+        return slot != npos && _entities[slot] == entity;
     }
 
     inline Component_Container_Base::size_type Component_Container_Base::size() const {
@@ -166,33 +361,245 @@ namespace anton_engine {
 
     inline void Component_Container_Base::add_entity(Entity const entity) {
         ANTON_ASSERT(!has(entity), "Entity has already been registered");
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
         _entities.emplace_back(entity);
-        auto index = indirect_index(entity);
-        ensure(index);
-        _indirect[index] = _entities.size() - 1;
+        set_slot(indirect_index(entity), _entities.size() - 1);
+        cover_page_epochs(_entities.size());
+        touch(_entities.size() - 1);
+        if (_tracks_changes) {
+            _added_ticks.push_back(_change_tick);
+            _changed_ticks.push_back(_change_tick);
+        }
     }
 
-    inline Component_Container_Base::size_type Component_Container_Base::get_component_index(Entity const entity) {
+    inline void Component_Container_Base::add_entities(Entity const* const entities, size_type const count) {
+        if (count == 0) {
+            return;
+        }
+
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
+        size_type const first = _entities.size();
+        _entities.reserve(first + count);
+        for (size_type i = 0; i < count; ++i) {
+            ANTON_ASSERT(!has(entities[i]), "Entity has already been registered");
+            _entities.push_back(entities[i]);
+            set_slot(indirect_index(entities[i]), first + i);
+        }
+        cover_page_epochs(first + count);
+        touch_range(first, first + count);
+        if (_tracks_changes) {
+            _added_ticks.resize(first + count, _change_tick);
+            _changed_ticks.resize(first + count, _change_tick);
+        }
+    }
+
+#if ANTON_ECS_ITERATION_DEBUG
+    inline u64 Component_Container_Base::get_structure_version() const {
+        return _structure_version;
+    }
+#endif
+
+    inline Component_Container_Base::size_type Component_Container_Base::get_component_index(Entity const entity) const {
         ANTON_ASSERT(has(entity), "Attempting to get index of an entity that has not been registered");
-        return _indirect[indirect_index(entity)];
+        size_type const index = indirect_index(entity);
+        return _indirect[index / indirect_page_size][index % indirect_page_size];
     }
 
     inline void Component_Container_Base::remove_entity(Entity const entity) {
         ANTON_ASSERT(has(entity), "Attempting to remove entity that has not been registered");
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
         auto index = indirect_index(entity);
         auto back_index = indirect_index(_entities[_entities.size() - 1]);
-        _entities.erase_unsorted(index);
-        _indirect[back_index] = _indirect[index];
-        _indirect[index] = npos;
+        size_type const slot = find_slot(index);
+        touch(slot);
+        touch(_entities.size() - 1);
+        _entities.erase_unsorted(slot);
+        if (_tracks_changes) {
+            _added_ticks.erase_unsorted(slot);
+            _changed_ticks.erase_unsorted(slot);
+        }
+        slot_ref(back_index) = slot;
+        clear_slot(index);
+    }
+
+    inline void Component_Container_Base::enable_change_tracking(u64 const tick) {
+        _change_tick = tick;
+        if (!_tracks_changes) {
+            _tracks_changes = true;
+            _added_ticks.resize(_entities.size(), tick);
+            _changed_ticks.resize(_entities.size(), tick);
+        }
+    }
+
+    inline bool Component_Container_Base::tracks_changes() const {
+        return _tracks_changes;
+    }
+
+    inline void Component_Container_Base::set_change_tick(u64 const tick) {
+        _change_tick = tick;
+    }
+
+    inline void Component_Container_Base::mark_changed(Entity const entity) {
+        if (_tracks_changes) {
+            _changed_ticks[get_component_index(entity)] = _change_tick;
+        }
+    }
+
+    inline u64 const* Component_Container_Base::added_ticks() const {
+        return _tracks_changes ? _added_ticks.data() : nullptr;
+    }
+
+    inline u64 const* Component_Container_Base::changed_ticks() const {
+        return _tracks_changes ? _changed_ticks.data() : nullptr;
+    }
+
+    inline void Component_Container_Base::touch(size_type const slot) {
+        size_type const page = slot / snapshot_page_size;
+        ANTON_ASSERT(page < _page_epochs.size(), "Slot is not covered by the page epochs");
+        u64* const epoch = _page_epochs.data() + page;
+        // Stamp only once per epoch so that repeated lookups do not write to the shared cache line.
+        if (atomic_load_relaxed(epoch) != _epoch) {
+            atomic_store_relaxed(epoch, _epoch);
+        }
+    }
+
+    inline void Component_Container_Base::cover_page_epochs(size_type const slot_count) {
+        size_type const page_count = (slot_count + snapshot_page_size - 1) / snapshot_page_size;
+        if (page_count > _page_epochs.size()) {
+            _page_epochs.resize(page_count, _epoch);
+        }
+    }
+
+    inline void Component_Container_Base::swap_entities(size_type const a, size_type const b) {
+        if (a == b) {
+            return;
+        }
+
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
+        touch(a);
+        touch(b);
+        using atl::swap;
+        swap(slot_ref(indirect_index(_entities[a])), slot_ref(indirect_index(_entities[b])));
+        swap(_entities[a], _entities[b]);
+        if (_tracks_changes) {
+            swap(_added_ticks[a], _added_ticks[b]);
+            swap(_changed_ticks[a], _changed_ticks[b]);
+        }
+    }
+
+    inline void Component_Container_Base::touch_range(size_type const first, size_type const last) {
+        for (size_type slot = first; slot < last; slot += snapshot_page_size) {
+            touch(slot);
+        }
+
+        if (first < last) {
+            touch(last - 1);
+        }
+    }
+
+    inline void Component_Container_Base::touch_all() {
+        // Pages added after the call are stamped by the structural change that adds them.
+        if (atomic_load_relaxed(&_all_touched_epoch) == _epoch) {
+            return;
+        }
+
+        for (u64& epoch: _page_epochs) {
+            if (atomic_load_relaxed(&epoch) != _epoch) {
+                atomic_store_relaxed(&epoch, _epoch);
+            }
+        }
+        atomic_store_relaxed(&_all_touched_epoch, _epoch);
     }
 
     inline Component_Container_Base::size_type Component_Container_Base::indirect_index(Entity const entity) const {
-        return entity.id;
+        return entity_index(entity);
+    }
+
+    inline Component_Container_Base::size_type Component_Container_Base::find_slot(size_type const index) const {
+        size_type const page = index / indirect_page_size;
+        if (page >= _indirect.size() || _indirect[page] == nullptr) {
+            return npos;
+        }
+        return _indirect[page][index % indirect_page_size];
+    }
+
+    inline Component_Container_Base::size_type& Component_Container_Base::slot_ref(size_type const index) {
+        return _indirect[index / indirect_page_size][index % indirect_page_size];
+    }
+
+    inline void Component_Container_Base::set_slot(size_type const index, size_type const slot) {
+        size_type const page = index / indirect_page_size;
+        if (page >= _indirect.size()) {
+            _indirect.resize(page + 1, nullptr);
+            _indirect_page_counts.resize(page + 1, 0);
+        }
+
+        if (_indirect[page] == nullptr) {
+            _indirect[page] = new size_type[indirect_page_size];
+            for (size_type i = 0; i < indirect_page_size; ++i) {
+                _indirect[page][i] = npos;
+            }
+        }
+
+        size_type& entry = _indirect[page][index % indirect_page_size];
+        if (entry == npos) {
+            _indirect_page_counts[page] += 1;
+        }
+        entry = slot;
     }
 
-    inline void Component_Container_Base::ensure(size_type index) {
-        if (_indirect.size() <= index) {
-            _indirect.resize(index + 1, npos);
+    inline void Component_Container_Base::clear_slot(size_type const index) {
+        size_type const page = index / indirect_page_size;
+        size_type& entry = _indirect[page][index % indirect_page_size];
+        if (entry != npos) {
+            entry = npos;
+            _indirect_page_counts[page] -= 1;
+            if (_indirect_page_counts[page] == 0) {
+                delete[] _indirect[page];
+                _indirect[page] = nullptr;
+            }
+        }
+    }
+
+    template <typename T>
+    void construct_components(T* const dst, i64 const count, T const* const prototype) {
+        if (count <= 0 || atl::is_empty<T>) {
+            return;
+        }
+
+        constexpr bool trivially_copyable = atl::is_trivially_copy_constructible<T> && atl::is_trivially_destructible<T>;
+        if (!prototype) {
+            if constexpr (atl::is_trivially_constructible<T> && trivially_copyable) {
+                memset(dst, 0, count * sizeof(T));
+            } else {
+                i64 i = 0;
+                try {
+                    for (; i < count; ++i) {
+                        ::new (dst + i) T();
+                    }
+                } catch (...) {
+                    atl::destruct(dst, dst + i);
+                    throw;
+                }
+            }
+        } else if constexpr (trivially_copyable) {
+            // Double the copied range with every call to keep the number of calls logarithmic in count.
+            memcpy(dst, prototype, sizeof(T));
+            for (i64 copied = 1; copied < count;) {
+                i64 const n = math::min(copied, count - copied);
+                memcpy(dst + copied, dst, n * sizeof(T));
+                copied += n;
+            }
+        } else {
+            atl::uninitialized_fill_n(dst, count, *prototype);
         }
     }
 
@@ -201,8 +608,13 @@ namespace anton_engine {
         static_assert(atl::is_invocable_r<bool, Predicate, Entity const, Entity const> ||
                       atl::is_invocable_r<bool, Predicate, Component const, Component const>,
                       "Predicate is not invocable with either Entity or Component as the parameter");
-        atl::Vector<i64> indices(_entities.size());
-        atl::iota(indices.begin(), indices.end(), 0);
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
+        atl::Vector<i64, atl::Polymorphic_Allocator> indices(atl::reserve, _entities.size(), &atl::get_frame_allocator());
+        for (i64 i = 0; i < _entities.size(); ++i) {
+            indices.push_back(i);
+        }
         sort(indices.begin(), indices.end(), [&, cmp = predicate](i64 const lhs, i64 const rhs) -> bool {
             if constexpr (atl::is_invocable_r<bool, Predicate, Entity const, Entity const>) {
                 return cmp(atl::as_const(_entities[lhs]), atl::as_const(_entities[rhs]));
@@ -211,15 +623,145 @@ namespace anton_engine {
             }
         });
 
-        using atl::swap;
-        for (i64 i = 0; i < indices.size(); ++i) {
-            i64 const sorted_index = indices[i];
-            if (i != sorted_index) {
-                swap(components[i], components[sorted_index]);
-                swap(_indirect[indirect_index(_entities[i])], _indirect[indirect_index(_entities[sorted_index])]);
-                swap(_entities[i], _entities[sorted_index]);
+        // Apply the permutation in a single gather pass. Swapping slot i with indices[i] would not follow the cycles of the permutation.
+        atl::Vector<Entity> sorted_entities(atl::reserve, _entities.size());
+        atl::Vector<Component> sorted_components(atl::reserve, components.size());
+        for (i64 const index: indices) {
+            sorted_entities.push_back(_entities[index]);
+            sorted_components.push_back(atl::move(components[index]));
+        }
+
+        if (_tracks_changes) {
+            atl::Vector<u64> sorted_added_ticks(atl::reserve, _entities.size());
+            atl::Vector<u64> sorted_changed_ticks(atl::reserve, _entities.size());
+            for (i64 const index: indices) {
+                sorted_added_ticks.push_back(_added_ticks[index]);
+                sorted_changed_ticks.push_back(_changed_ticks[index]);
             }
+            _added_ticks = atl::move(sorted_added_ticks);
+            _changed_ticks = atl::move(sorted_changed_ticks);
         }
+
+        _entities = atl::move(sorted_entities);
+        components = atl::move(sorted_components);
+        for (i64 i = 0; i < _entities.size(); ++i) {
+            slot_ref(indirect_index(_entities[i])) = i;
+        }
+        touch_all();
+    }
+
+    template <typename Component>
+    void Component_Container_Base::remove_marked_entities(atl::Vector<Component>* const components, u64 const* const marked,
+                                                          size_type const marked_count) {
+        auto const is_marked = [marked, marked_count](size_type const index) -> bool {
+            return index < marked_count && ((marked[index / 64] >> (index % 64)) & 1);
+        };
+
+        size_type const size = _entities.size();
+        size_type kept = 0;
+        while (kept < size && !is_marked(indirect_index(_entities[kept]))) {
+            kept += 1;
+        }
+
+        if (kept == size) {
+            return;
+        }
+
+#if ANTON_ECS_ITERATION_DEBUG
+        _structure_version += 1;
+#endif
+        touch_range(kept, size);
+        for (size_type i = kept; i < size; ++i) {
+            size_type const index = indirect_index(_entities[i]);
+            if (is_marked(index)) {
+                clear_slot(index);
+                continue;
+            }
+
+            if (components) {
+                (*components)[kept] = atl::move((*components)[i]);
+            }
+            _entities[kept] = _entities[i];
+            if (_tracks_changes) {
+                _added_ticks[kept] = _added_ticks[i];
+                _changed_ticks[kept] = _changed_ticks[i];
+            }
+            slot_ref(index) = kept;
+            kept += 1;
+        }
+
+        _entities.erase(_entities.begin() + kept, _entities.end());
+        if (_tracks_changes) {
+            _added_ticks.erase(_added_ticks.begin() + kept, _added_ticks.end());
+            _changed_ticks.erase(_changed_ticks.begin() + kept, _changed_ticks.end());
+        }
+        if (components) {
+            components->erase(components->begin() + kept, components->end());
+        }
+    }
+
+    template <typename Component>
+    void Component_Container_Base::update_snapshot_pages(Component_Container_Base const& source, atl::Vector<Component>* const components,
+                                                         atl::Vector<Component> const* const source_components) {
+        size_type const source_size = source._entities.size();
+        // Drop the slots that no longer exist in source.
+        for (size_type i = source_size; i < _entities.size(); ++i) {
+            size_type const index = indirect_index(_entities[i]);
+            if (find_slot(index) == i) {
+                clear_slot(index);
+            }
+        }
+
+        if (_entities.size() > source_size) {
+            _entities.erase(_entities.begin() + source_size, _entities.end());
+            if (components) {
+                components->erase(components->begin() + source_size, components->end());
+            }
+        }
+
+        size_type const page_count = (source_size + snapshot_page_size - 1) / snapshot_page_size;
+        size_type const synced_size = _entities.size();
+        for (size_type page = 0; page < page_count; ++page) {
+            size_type const first = page * snapshot_page_size;
+            size_type const last = math::min(first + snapshot_page_size, source_size);
+            bool const source_modified = page >= source._page_epochs.size() || source._page_epochs[page] >= _synced_epoch;
+            bool const snapshot_modified = page >= _page_epochs.size() || _page_epochs[page] != 0;
+            if (!source_modified && !snapshot_modified && last <= synced_size) {
+                continue;
+            }
+
+            for (size_type i = first; i < last && i < synced_size; ++i) {
+                size_type const index = indirect_index(_entities[i]);
+                if (find_slot(index) == i) {
+                    clear_slot(index);
+                }
+            }
+
+            for (size_type i = first; i < last; ++i) {
+                if (i < synced_size) {
+                    _entities[i] = source._entities[i];
+                    if (components) {
+                        (*components)[i] = (*source_components)[i];
+                    }
+                } else {
+                    _entities.push_back(source._entities[i]);
+                    if (components) {
+                        components->push_back((*source_components)[i]);
+                    }
+                }
+
+                set_slot(indirect_index(_entities[i]), i);
+            }
+        }
+
+        _page_epochs.resize(page_count, 0);
+        for (u64& epoch: _page_epochs) {
+            epoch = 0;
+        }
+        _all_touched_epoch = 0;
+
+        source._epoch += 1;
+        _synced_epoch = source._epoch;
     }
 
     template <typename Component>
@@ -235,10 +777,9 @@ namespace anton_engine {
     inline void deserialize(serialization::Binary_Input_Archive& archive, Component_Container_Base& container) {
         deserialize(archive, container._entities);
         for (i64 i = 0; i < container._entities.size(); i += 1) {
-            auto index = container.indirect_index(container._entities[i]);
-            container.ensure(index);
-            container._indirect[index] = i;
+            container.set_slot(container.indirect_index(container._entities[i]), i);
         }
+        container.cover_page_epochs(container._entities.size());
     }
 
     template <typename C>
@@ -249,6 +790,21 @@ namespace anton_engine {
         anton_engine::serialize(archive, *container);
     }
 
+    template <typename C>
+    inline void Component_Container<C>::update_snapshot(Component_Container_Base const& source, Component_Container_Base*& snapshot) {
+        if (!snapshot) {
+            snapshot = new Component_Container<C>();
+        }
+
+        Component_Container<C> const& s = static_cast<Component_Container<C> const&>(source);
+        Component_Container<C>& c = static_cast<Component_Container<C>&>(*snapshot);
+        if constexpr (atl::is_empty<C>) {
+            c.update_snapshot_pages(source, static_cast<atl::Vector<C>*>(nullptr), static_cast<atl::Vector<C> const*>(nullptr));
+        } else {
+            c.update_snapshot_pages(source, &c._components, &s._components);
+        }
+    }
+
     template <typename C>
     inline void Component_Container<C>::deserialize(serialization::Binary_Input_Archive& archive, Component_Container_Base*& container) {
         container = new Component_Container<C>();
@@ -0,0 +1,91 @@
+#ifndef ENGINE_ECS_COMPONENT_GROUP_HPP_INCLUDE
+#define ENGINE_ECS_COMPONENT_GROUP_HPP_INCLUDE
+
+#include <core/atl/tuple.hpp>
+#include <core/atl/type_traits.hpp>
+#include <core/atl/utility.hpp>
+#include <engine/ecs/component_container.hpp>
+
+namespace anton_engine {
+    // Component_Group
+    // Iterates the entities that have all of the owned Components... attached.
+    // The group owns the containers of Components... and keeps them arranged so that
+    // the entities belonging to the group occupy the first size() slots of every owned
+    // container in the same order. Iteration is therefore a loop over parallel arrays
+    // without any membership checks.
+    //
+    template <typename... Components>
+    class Component_Group {
+        static_assert(sizeof...(Components) > 0, "Why would you do this?");
+
+        friend class ECS;
+
+        Component_Group(i64 const* s, Component_Container<Components>*... c): group_size(s), containers(c...) {}
+
+    public:
+        using size_type = Component_Container_Base::size_type;
+        using iterator = Component_Container_Base::iterator;
+
+        [[nodiscard]] size_type size() const {
+            return *group_size;
+        }
+
+        // Returns: Array of size() entities that belong to the group.
+        [[nodiscard]] Entity const* entities() const {
+            return first_container()->entities();
+        }
+
+        // Returns: Array of size() components of type T ordered the same as entities().
+        template <typename T>
+        [[nodiscard]] T* components() {
+            return atl::get<Component_Container<T>*>(containers)->components(0, *group_size);
+        }
+
+        [[nodiscard]] iterator begin() {
+            return first_container()->entities();
+        }
+
+        [[nodiscard]] iterator end() {
+            return first_container()->entities() + *group_size;
+        }
+
+        template <typename... T>
+        [[nodiscard]] decltype(auto) get(Entity const entity) {
+            if constexpr (sizeof...(T) == 1) {
+                return (..., atl::get<Component_Container<T>*>(containers)->get(entity));
+            } else {
+                return atl::Tuple<T&...>(get<T>(entity)...);
+            }
+        }
+
+        // Provides a convenient way to iterate over all entities and their components.
+        // Requires a callable of form void(Components&...) or void(Entity, Components&...)
+        //
+        template <typename Callable>
+        void each(Callable&& callable) {
+            static_assert(atl::is_invocable<Callable, Entity, Components&...> || atl::is_invocable<Callable, Components&...>);
+            i64 const size = *group_size;
+            Entity const* const entities = first_container()->entities();
+            atl::Tuple<Components*...> const arrays(components<Components>()...);
+            for (i64 i = 0; i < size; ++i) {
+                if constexpr (atl::is_invocable<Callable, Components&...>) {
+                    callable(component_at(atl::get<Components*>(arrays), i)...);
+                } else {
+                    callable(entities[i], component_at(atl::get<Components*>(arrays), i)...);
+                }
+            }
+        }
+
+    private:
+        // Number of entities in the group. Owned by the ECS.
+        i64 const* group_size;
+        atl::Tuple<Component_Container<Components>*...> containers;
+
+        Component_Container_Base* first_container() const {
+            Component_Container_Base* const conts[] = {static_cast<Component_Container_Base*>(atl::get<Component_Container<Components>*>(containers))...};
+            return conts[0];
+        }
+    };
+} // namespace anton_engine
+
+#endif // !ENGINE_ECS_COMPONENT_GROUP_HPP_INCLUDE
@@ -0,0 +1,75 @@
+#ifndef ENGINE_ECS_COMPONENT_QUERY_HPP_INCLUDE
+#define ENGINE_ECS_COMPONENT_QUERY_HPP_INCLUDE
+
+#include <core/atl/tuple.hpp>
+#include <core/atl/type_traits.hpp>
+#include <core/atl/vector.hpp>
+#include <engine/ecs/component_container.hpp>
+
+namespace anton_engine {
+    // Component_Query
+    // Cached list of the entities that have all of Components... attached.
+    // The ECS keeps the list up to date as components are added and removed, therefore iterating
+    // a query visits only the matching entities without examining any other entity.
+    // The order of the entities is unspecified and changes when entities stop matching.
+    //
+    template <typename... Components>
+    class Component_Query {
+        static_assert(sizeof...(Components) > 0, "Why would you do this?");
+
+        friend class ECS;
+
+        Component_Query(atl::Vector<Entity> const* e, Component_Container<Components>*... c): query_entities(e), containers(c...) {}
+
+    public:
+        using size_type = atl::Vector<Entity>::size_type;
+        using iterator = atl::Vector<Entity>::const_iterator;
+
+        [[nodiscard]] size_type size() const {
+            return query_entities->size();
+        }
+
+        [[nodiscard]] Entity const* entities() const {
+            return query_entities->data();
+        }
+
+        [[nodiscard]] iterator begin() const {
+            return query_entities->begin();
+        }
+
+        [[nodiscard]] iterator end() const {
+            return query_entities->end();
+        }
+
+        template <typename... T>
+        [[nodiscard]] decltype(auto) get(Entity const entity) {
+            if constexpr (sizeof...(T) == 1) {
+                return (..., atl::get<Component_Container<T>*>(containers)->get(entity));
+            } else {
+                return atl::Tuple<T&...>(get<T>(entity)...);
+            }
+        }
+
+        // Provides a convenient way to iterate over all entities and their components.
+        // Requires a callable of form void(Components&...) or void(Entity, Components&...)
+        //
+        template <typename Callable>
+        void each(Callable&& callable) {
+            static_assert(atl::is_invocable<Callable, Entity, Components&...> || atl::is_invocable<Callable, Components&...>);
+            for (Entity const entity: *query_entities) {
+                if constexpr (atl::is_invocable<Callable, Components&...>) {
+                    callable(get<Components>(entity)...);
+                } else {
+                    callable(entity, get<Components>(entity)...);
+                }
+            }
+        }
+
+    private:
+        // Matching entities. Owned by the ECS.
+        atl::Vector<Entity> const* query_entities;
+        atl::Tuple<Component_Container<Components>*...> containers;
+    };
+} // namespace anton_engine
+
+#endif // !ENGINE_ECS_COMPONENT_QUERY_HPP_INCLUDE
@@ -1,6 +1,7 @@
 #ifndef ENGINE_ECS_COMPONENT_SERIALIZATION_HPP_INCLUDE
 #define ENGINE_ECS_COMPONENT_SERIALIZATION_HPP_INCLUDE
 
+#include <core/atl/slice.hpp>
 #include <core/atl/vector.hpp>
 #include <core/serialization/archives/binary.hpp>
 #include <core/typeid.hpp>
@@ -20,6 +21,22 @@ namespace anton_engine {
     using get_component_serialization_funcs_t = atl::Vector<Component_Serialization_Funcs>& (*)();
 
     ENGINE_API extern get_component_serialization_funcs_t get_component_serialization_funcs;
+
+    // Version of the format of the archives written by serialize(Binary_Output_Archive&, ECS const&).
+    // Archives written before the version was introduced have version 0.
+    //  1: Hierarchy links the children into a list instead of storing up to 16 of them.
+    constexpr i64 ecs_archive_version = 1;
+
+    // Reads a container of a component whose serialized layout has changed
+    // from an archive whose version is lower than version.
+    struct Component_Migration {
+        u64 identifier;
+        i64 version;
+        deserialize_func deserialize;
+    };
+
+    // Returns: Migrations of the engine components ordered by version.
+    [[nodiscard]] atl::Slice<Component_Migration const> get_component_migrations();
 } // namespace anton_engine
 
 #endif // !ENGINE_ECS_COMPONENT_SERIALIZATION_HPP_INCLUDE
@@ -0,0 +1,30 @@
+#ifndef ENGINE_ECS_COMPONENT_TYPE_HPP_INCLUDE
+#define ENGINE_ECS_COMPONENT_TYPE_HPP_INCLUDE
+
+#include <core/typeid.hpp>
+#include <core/types.hpp>
+
+namespace anton_engine {
+    // register_component_type
+    // Assigns a dense index to the component type identified by family.
+    // Registering the same family more than once returns the same index,
+    // which keeps the indices consistent between the engine and game modules.
+    // Thread-safe.
+    //
+    // Returns: Index of the component type in the range [0, number of registered component types[.
+    //
+    i64 register_component_type(u64 family);
+
+    // component_type_index
+    // The index is registered on the first call and cached, so that subsequent calls cost a single load.
+    //
+    // Returns: Dense index of the component type T.
+    //
+    template <typename T>
+    [[nodiscard]] i64 component_type_index() {
+        static i64 const index = register_component_type(type_identifier<T>());
+        return index;
+    }
+} // namespace anton_engine
+
+#endif // !ENGINE_ECS_COMPONENT_TYPE_HPP_INCLUDE
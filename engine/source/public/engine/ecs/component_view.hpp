@@ -1,12 +1,99 @@
 #ifndef ENGINE_ECS_COMPONENT_VIEW_HPP_INCLUDE
 #define ENGINE_ECS_COMPONENT_VIEW_HPP_INCLUDE
 
+#include <build_config.hpp>
 #include <core/math/math.hpp>
 #include <core/atl/utility.hpp>
+#include <engine/ecs/archetype_storage.hpp>
 #include <engine/ecs/component_container.hpp>
+#include <engine/ecs/component_type.hpp>
+#include <engine/ecs/jobs.hpp>
 #include <core/atl/tuple.hpp>
 
 namespace anton_engine {
+    // Number of entities processed by a single job of parallel_each.
+    constexpr i64 default_parallel_each_grain_size = 1024;
+
+    namespace detail {
+#if ANTON_ECS_ITERATION_DEBUG
+        // Returns: Number of parallel_each callbacks executing on the calling thread.
+        i64& parallel_each_depth();
+#endif
+
+        // Marks the calling thread as executing parallel_each callbacks, which the ECS uses
+        // to reject adding and removing components from within the callbacks.
+        struct Parallel_Each_Scope {
+#if ANTON_ECS_ITERATION_DEBUG
+            Parallel_Each_Scope() {
+                parallel_each_depth() += 1;
+            }
+
+            ~Parallel_Each_Scope() {
+                parallel_each_depth() -= 1;
+            }
+#endif
+        };
+
+        // parallel_each over the chunks of the archetypes of storage that contain the components with type_indices.
+        // The entities are split at chunk boundaries, grain_size is rounded to whole chunks.
+        template <typename... Components, typename Callable>
+        void archetype_parallel_each(Archetype_Storage const* const storage, i64 const* const type_indices, i64 const grain_size, Callable& callable) {
+            struct Chunk_Ref {
+                Archetype_Storage::Archetype const* archetype;
+                i64 chunk;
+            };
+
+            atl::Vector<Chunk_Ref> chunks;
+            i64 rows = 0;
+            for (i64 i = 0; i < storage->archetype_count(); ++i) {
+                Archetype_Storage::Archetype const& archetype = storage->get_archetype(i);
+                if (!Archetype_Storage::matches(archetype, type_indices, sizeof...(Components))) {
+                    continue;
+                }
+
+                for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                    chunks.push_back({&archetype, chunk});
+                }
+                rows += archetype.size;
+            }
+
+            if (chunks.size() == 0) {
+                return;
+            }
+
+            i64 const rows_per_chunk = math::max(rows / chunks.size(), (i64)1);
+#if ANTON_ECS_ITERATION_DEBUG
+            u64 const structure_version = storage->get_structure_version();
+#endif
+            parallel_for(chunks.size(), math::max(grain_size / rows_per_chunk, (i64)1), [&](i64 const first, i64 const last) {
+                Parallel_Each_Scope const scope;
+                for (i64 i = first; i < last; ++i) {
+                    Archetype_Storage::Archetype const& archetype = *chunks[i].archetype;
+                    i64 const chunk = chunks[i].chunk;
+                    Entity const* const entities = Archetype_Storage::chunk_entities(archetype, chunk);
+                    atl::Tuple<Components*...> const arrays(Archetype_Storage::chunk_components<Components>(
+                        archetype, chunk, Archetype_Storage::find_column(archetype, component_type_index<Components>()))...);
+                    i64 const chunk_rows = Archetype_Storage::chunk_rows(archetype, chunk);
+                    for (i64 row = 0; row < chunk_rows; ++row) {
+                        if constexpr (atl::is_invocable<Callable, Components&...>) {
+                            callable(component_at(atl::get<Components*>(arrays), row)...);
+                        } else {
+                            callable(entities[row], component_at(atl::get<Components*>(arrays), row)...);
+                        }
+                    }
+                }
+#if ANTON_ECS_ITERATION_DEBUG
+                ANTON_VERIFY(storage->get_structure_version() == structure_version, "Components have been added or removed during parallel_each.");
+#endif
+            });
+        }
+    } // namespace detail
+
+    // Component_View
+    // Iterates the entities that have all of Components... attached.
+    // If the ECS uses Storage_Mode::archetype, the view walks the chunks of the matching archetypes
+    // instead of the smallest container and does not need to check the membership of each entity.
+    //
     template <typename... Components>
     class Component_View {
         static_assert(sizeof...(Components) > 0, "Why would you do this?");
@@ -14,6 +101,8 @@ namespace anton_engine {
         friend class ECS;
 
         Component_View(Component_Container<Components>*... c): containers(c...) {}
+        Component_View(Archetype_Storage* s)
+            : containers(static_cast<Component_Container<Components>*>(nullptr)...), archetypes(s), type_indices{component_type_index<Components>()...} {}
 
     public:
         using size_type = Component_Container_Base::size_type;
@@ -22,9 +111,12 @@ namespace anton_engine {
             friend class Component_View;
 
             using underlying_iterator_t = typename Component_Container_Base::iterator;
+            using archetype_iterator_t = Archetype_Iterator<sizeof...(Components)>;
 
             // begin and end are iterators into the smallest container
             iterator(atl::Tuple<Component_Container<Components>*...> c, underlying_iterator_t b, underlying_iterator_t e): containers(c), begin(b), end(e) {}
+            iterator(archetype_iterator_t a)
+                : containers(static_cast<Component_Container<Components>*>(nullptr)...), begin(nullptr), end(nullptr), archetype_iterator(a), archetype(true) {}
 
         public:
             using value_type = typename atl::Iterator_Traits<underlying_iterator_t>::value_type;
@@ -34,6 +126,11 @@ namespace anton_engine {
             using iterator_category = atl::Forward_Iterator_Tag;
 
             iterator& operator++() {
+                if (archetype) {
+                    ++archetype_iterator;
+                    return *this;
+                }
+
                 return (++begin != end && !has_all_components(*begin)) ? ++(*this) : *this;
             }
 
@@ -42,15 +139,16 @@ namespace anton_engine {
                 for (; rhs > 0; --rhs) {
                     ++(*this);
                 }
+                return *this;
             }
 
             // Return underlying_iterator_t to call operator-> recursively
             underlying_iterator_t operator->() {
-                return begin;
+                return archetype ? archetype_iterator.operator->() : begin;
             }
 
             reference operator*() {
-                return *begin;
+                return archetype ? *archetype_iterator : *begin;
             }
 
             [[nodiscard]] friend iterator operator+(iterator lhs, i64 const rhs) {
@@ -59,11 +157,11 @@ namespace anton_engine {
             }
 
             [[nodiscard]] friend bool operator==(iterator const& a, iterator const& b) {
-                return a.begin == b.begin;
+                return a.begin == b.begin && a.archetype_iterator == b.archetype_iterator;
             }
 
             [[nodiscard]] friend bool operator!=(iterator const& a, iterator const& b) {
-                return a.begin != b.begin;
+                return !(a == b);
             }
 
         private:
@@ -75,10 +173,25 @@ namespace anton_engine {
             atl::Tuple<Component_Container<Components>*...> containers;
             underlying_iterator_t begin;
             underlying_iterator_t end;
+            archetype_iterator_t archetype_iterator;
+            bool archetype = false;
         };
 
     public:
+        // With Storage_Mode::sparse_set the size of the smallest container, which is an upper bound
+        // of the number of entities in the view. Exact with Storage_Mode::archetype.
         [[nodiscard]] size_type size() const {
+            if (archetypes) {
+                i64 count = 0;
+                for (i64 i = 0; i < archetypes->archetype_count(); ++i) {
+                    Archetype_Storage::Archetype const& archetype = archetypes->get_archetype(i);
+                    if (Archetype_Storage::matches(archetype, type_indices, sizeof...(Components))) {
+                        count += archetype.size;
+                    }
+                }
+                return count;
+            }
+
             i64 sizes[] = {atl::get<Component_Container<Components>*>(containers)->size()...};
             i64 min = sizes[0];
             for(i64 i = 1; i < atl::size(sizes); ++i) {
@@ -88,11 +201,24 @@ namespace anton_engine {
         }
 
         [[nodiscard]] iterator begin() {
+            if (archetypes) {
+                return iterator(typename iterator::archetype_iterator_t(archetypes, type_indices, false));
+            }
+
             auto c = find_smallest_container();
-            return iterator(containers, c->begin(), c->end());
+            auto first = c->begin();
+            // Skip the leading entities that do not have all components.
+            while (first != c->end() && !has_all_components(*first)) {
+                ++first;
+            }
+            return iterator(containers, first, c->end());
         }
 
         [[nodiscard]] iterator end() {
+            if (archetypes) {
+                return iterator(typename iterator::archetype_iterator_t(archetypes, type_indices, true));
+            }
+
             auto c = find_smallest_container();
             return iterator(containers, c->end(), c->end());
         }
@@ -100,6 +226,11 @@ namespace anton_engine {
         template <typename... T>
         [[nodiscard]] decltype(auto) get(Entity const entity) {
             if constexpr (sizeof...(T) == 1) {
+                if (archetypes) {
+                    ANTON_ASSERT(archetypes->has(entity, component_type_index<T...>()), "Attempting to get component of an entity that does not have it");
+                    return (..., *archetypes->try_get<T>(entity));
+                }
+
                 return (..., atl::get<Component_Container<T>*>(containers)->get(entity));
             } else {
                 return atl::Tuple<T&...>(get<T>(entity)...);
@@ -108,11 +239,36 @@ namespace anton_engine {
 
         // Provides a convenient way to iterate over all entities and their components.
         // Requires a callable of form void(Components&...) or void(Entity, Components&...)
-        // May be less efficient than range-based for loop or other alternatives because it prefetches all components
+        // May be less efficient than range-based for loop or other alternatives because it prefetches all components.
+        // With Storage_Mode::archetype the components are read linearly from the chunks of the matching archetypes.
         //
         template <typename Callable>
         void each(Callable&& callable) {
             static_assert(atl::is_invocable<Callable, Entity, Components&...> || atl::is_invocable<Callable, Components&...>);
+            if (archetypes) {
+                for (i64 i = 0; i < archetypes->archetype_count(); ++i) {
+                    Archetype_Storage::Archetype const& archetype = archetypes->get_archetype(i);
+                    if (!Archetype_Storage::matches(archetype, type_indices, sizeof...(Components))) {
+                        continue;
+                    }
+
+                    for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                        Entity const* const entities = Archetype_Storage::chunk_entities(archetype, chunk);
+                        atl::Tuple<Components*...> const arrays(Archetype_Storage::chunk_components<Components>(
+                            archetype, chunk, Archetype_Storage::find_column(archetype, component_type_index<Components>()))...);
+                        i64 const rows = Archetype_Storage::chunk_rows(archetype, chunk);
+                        for (i64 row = 0; row < rows; ++row) {
+                            if constexpr (atl::is_invocable<Callable, Components&...>) {
+                                callable(component_at(atl::get<Components*>(arrays), row)...);
+                            } else {
+                                callable(entities[row], component_at(atl::get<Components*>(arrays), row)...);
+                            }
+                        }
+                    }
+                }
+                return;
+            }
+
             auto smallest_container = find_smallest_container();
             for (Entity const entity: *smallest_container) {
                 if (has_all_components(entity)) {
@@ -125,6 +281,48 @@ namespace anton_engine {
             }
         }
 
+        // Same as each, but splits the entities into ranges of grain_size entities that are processed on the job threads.
+        // callable is invoked concurrently and must not add or remove components of any entity.
+        //
+        template <typename Callable>
+        void parallel_each(Callable&& callable, i64 const grain_size = default_parallel_each_grain_size) {
+            static_assert(atl::is_invocable<Callable, Entity, Components&...> || atl::is_invocable<Callable, Components&...>);
+            if (archetypes) {
+                detail::archetype_parallel_each<Components...>(archetypes, type_indices, grain_size, callable);
+                return;
+            }
+
+            Component_Container_Base* const smallest_container = find_smallest_container();
+            Entity const* const entities = smallest_container->entities();
+            // Marks every page as modified here so that the jobs do not write to the containers.
+            atl::Tuple<Components*...> const arrays(atl::get<Component_Container<Components>*>(containers)->components()...);
+#if ANTON_ECS_ITERATION_DEBUG
+            u64 const structure_versions[] = {atl::get<Component_Container<Components>*>(containers)->get_structure_version()...};
+#endif
+            parallel_for(smallest_container->size(), grain_size, [&](i64 const first, i64 const last) {
+                detail::Parallel_Each_Scope const scope;
+                for (i64 i = first; i < last; ++i) {
+                    Entity const entity = entities[i];
+                    if (!has_all_components(entity)) {
+                        continue;
+                    }
+
+                    if constexpr (atl::is_invocable<Callable, Components&...>) {
+                        callable(component_at(atl::get<Components*>(arrays), atl::get<Component_Container<Components>*>(containers)->get_component_index(entity))...);
+                    } else {
+                        callable(entity,
+                                 component_at(atl::get<Components*>(arrays), atl::get<Component_Container<Components>*>(containers)->get_component_index(entity))...);
+                    }
+                }
+#if ANTON_ECS_ITERATION_DEBUG
+                u64 const current_versions[] = {atl::get<Component_Container<Components>*>(containers)->get_structure_version()...};
+                for (i64 i = 0; i < i64(sizeof...(Components)); ++i) {
+                    ANTON_VERIFY(current_versions[i] == structure_versions[i], "Components have been added or removed during parallel_each.");
+                }
+#endif
+            });
+        }
+
     private:
         bool has_all_components(Entity entity) {
             return (... && atl::get<Component_Container<Components>*>(containers)->has(entity));
@@ -147,6 +345,9 @@ namespace anton_engine {
 
     private:
         atl::Tuple<Component_Container<Components>*...> containers;
+        // Non-null if the ECS uses Storage_Mode::archetype.
+        Archetype_Storage* archetypes = nullptr;
+        i64 type_indices[sizeof...(Components)] = {};
     };
 
     // Specialization of Component_View  for single component type.
@@ -156,24 +357,97 @@ namespace anton_engine {
         friend class ECS;
 
         Component_View(Component_Container<Component>* c): container(c) {}
+        Component_View(Archetype_Storage* s): container(nullptr), archetypes(s), type_index(component_type_index<Component>()) {}
 
     public:
         using size_type = Component_Container_Base::size_type;
-        using iterator = Component_Container_Base::iterator;
+
+        class iterator {
+            friend class Component_View;
+
+            using underlying_iterator_t = typename Component_Container_Base::iterator;
+            using archetype_iterator_t = Archetype_Iterator<1>;
+
+            iterator(underlying_iterator_t i): entity(i) {}
+            iterator(archetype_iterator_t a): entity(nullptr), archetype_iterator(a), archetype(true) {}
+
+        public:
+            using value_type = typename atl::Iterator_Traits<underlying_iterator_t>::value_type;
+            using reference = typename atl::Iterator_Traits<underlying_iterator_t>::reference;
+            using pointer = typename atl::Iterator_Traits<underlying_iterator_t>::pointer;
+            using difference_type = typename atl::Iterator_Traits<underlying_iterator_t>::difference_type;
+            using iterator_category = atl::Forward_Iterator_Tag;
+
+            iterator& operator++() {
+                if (archetype) {
+                    ++archetype_iterator;
+                } else {
+                    ++entity;
+                }
+                return *this;
+            }
+
+            underlying_iterator_t operator->() {
+                return archetype ? archetype_iterator.operator->() : entity;
+            }
+
+            reference operator*() {
+                return archetype ? *archetype_iterator : *entity;
+            }
+
+            [[nodiscard]] friend bool operator==(iterator const& a, iterator const& b) {
+                return a.entity == b.entity && a.archetype_iterator == b.archetype_iterator;
+            }
+
+            [[nodiscard]] friend bool operator!=(iterator const& a, iterator const& b) {
+                return !(a == b);
+            }
+
+        private:
+            underlying_iterator_t entity;
+            archetype_iterator_t archetype_iterator;
+            bool archetype = false;
+        };
 
         [[nodiscard]] size_type size() const {
+            if (archetypes) {
+                i64 count = 0;
+                for (i64 i = 0; i < archetypes->archetype_count(); ++i) {
+                    Archetype_Storage::Archetype const& archetype = archetypes->get_archetype(i);
+                    if (Archetype_Storage::find_column(archetype, type_index) != -1) {
+                        count += archetype.size;
+                    }
+                }
+                return count;
+            }
+
             return container->size();
         }
 
         [[nodiscard]] iterator begin() {
-            return container->Component_Container_Base::begin();
+            if (archetypes) {
+                i64 const types[] = {type_index};
+                return iterator(Archetype_Iterator<1>(archetypes, types, false));
+            }
+
+            return iterator(container->Component_Container_Base::begin());
         }
 
         [[nodiscard]] iterator end() {
-            return container->Component_Container_Base::end();
+            if (archetypes) {
+                i64 const types[] = {type_index};
+                return iterator(Archetype_Iterator<1>(archetypes, types, true));
+            }
+
+            return iterator(container->Component_Container_Base::end());
         }
 
         [[nodiscard]] Component& get(Entity const entity) {
+            if (archetypes) {
+                ANTON_ASSERT(archetypes->has(entity, type_index), "Attempting to get component of an entity that does not have it");
+                return *archetypes->try_get<Component>(entity);
+            }
+
             return container->get(entity);
         }
 
@@ -183,6 +457,30 @@ namespace anton_engine {
         template <typename Callable>
         void each(Callable&& callable) {
             static_assert(atl::is_invocable<Callable, Entity, Component&> || atl::is_invocable<Callable, Component&>);
+            if (archetypes) {
+                for (i64 i = 0; i < archetypes->archetype_count(); ++i) {
+                    Archetype_Storage::Archetype const& archetype = archetypes->get_archetype(i);
+                    i64 const column = Archetype_Storage::find_column(archetype, type_index);
+                    if (column == -1) {
+                        continue;
+                    }
+
+                    for (i64 chunk = 0; chunk < archetype.chunks.size(); ++chunk) {
+                        Entity const* const entities = Archetype_Storage::chunk_entities(archetype, chunk);
+                        Component* const components = Archetype_Storage::chunk_components<Component>(archetype, chunk, column);
+                        i64 const rows = Archetype_Storage::chunk_rows(archetype, chunk);
+                        for (i64 row = 0; row < rows; ++row) {
+                            if constexpr (atl::is_invocable<Callable, Component&>) {
+                                callable(component_at(components, row));
+                            } else {
+                                callable(entities[row], component_at(components, row));
+                            }
+                        }
+                    }
+                }
+                return;
+            }
+
             for (Entity entity: *static_cast<Component_Container_Base*>(container)) {
                 if constexpr (atl::is_invocable<Callable, Component&>) {
                     callable(get(entity));
@@ -192,8 +490,43 @@ namespace anton_engine {
             }
         }
 
+        // Same as each, but splits the entities into ranges of grain_size entities that are processed on the job threads.
+        // callable is invoked concurrently and must not add or remove components of any entity.
+        //
+        template <typename Callable>
+        void parallel_each(Callable&& callable, i64 const grain_size = default_parallel_each_grain_size) {
+            static_assert(atl::is_invocable<Callable, Entity, Component&> || atl::is_invocable<Callable, Component&>);
+            if (archetypes) {
+                detail::archetype_parallel_each<Component>(archetypes, &type_index, grain_size, callable);
+                return;
+            }
+
+            Entity const* const entities = container->entities();
+            // Marks every page as modified here so that the jobs do not write to the container.
+            Component* const components = container->components();
+#if ANTON_ECS_ITERATION_DEBUG
+            u64 const structure_version = container->get_structure_version();
+#endif
+            parallel_for(container->size(), grain_size, [&](i64 const first, i64 const last) {
+                detail::Parallel_Each_Scope const scope;
+                for (i64 i = first; i < last; ++i) {
+                    if constexpr (atl::is_invocable<Callable, Component&>) {
+                        callable(component_at(components, i));
+                    } else {
+                        callable(entities[i], component_at(components, i));
+                    }
+                }
+#if ANTON_ECS_ITERATION_DEBUG
+                ANTON_VERIFY(container->get_structure_version() == structure_version, "Components have been added or removed during parallel_each.");
+#endif
+            });
+        }
+
     private:
         Component_Container<Component>* container;
+        // Non-null if the ECS uses Storage_Mode::archetype.
+        Archetype_Storage* archetypes = nullptr;
+        i64 type_index = -1;
     };
 } // namespace anton_engine
 
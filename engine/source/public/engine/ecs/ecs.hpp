@@ -2,9 +2,16 @@
 #define ENGINE_ENTITY_COMPONENT_SYSTEM_HPP_INCLUDE
 
 #include <core/atl/algorithm.hpp>
+#include <core/atl/allocator.hpp>
+#include <core/atl/slice.hpp>
 #include <core/atl/type_traits.hpp>
 #include <core/atl/vector.hpp>
+#include <core/handle.hpp>
+#include <engine/ecs/archetype_storage.hpp>
 #include <engine/ecs/component_container.hpp>
+#include <engine/ecs/component_group.hpp>
+#include <engine/ecs/component_query.hpp>
+#include <engine/ecs/component_type.hpp>
 #include <engine/ecs/component_view.hpp>
 #include <engine/ecs/entity.hpp>
 #include <engine.hpp>
@@ -14,13 +21,56 @@
 #include <core/atl/tuple.hpp>
 
 namespace anton_engine {
+    enum class Snapshot_Mode {
+        // Deep copy of the containers. The snapshot is independent of the ECS it has been taken from.
+        copy,
+        // The snapshot shares storage with a persistent copy owned by the ECS that is updated
+        // incrementally, copying only the pages that have changed since the previous snapshot.
+        // The snapshot is valid until the next shared snapshot of the same components is taken
+        // or until the ECS is destroyed.
+        shared,
+    };
+
+    enum class Storage_Mode {
+        // Every component type is stored in its own sparse set container.
+        sparse_set,
+        // Entities with the same set of components are packed together in chunks (see Archetype_Storage).
+        // Views over several components iterate the chunks linearly without per-entity membership checks,
+        // but adding or removing components moves the entity between archetypes.
+        // Contiguous component arrays (entities, components), sort and deserialization are not available.
+        // Snapshots are always deep copies stored in sparse set containers.
+        archetype,
+    };
+
+    class ECS;
+
+    enum class Observer_Event : u8 {
+        // Component has been added to an entity.
+        construct,
+        // Component is about to be removed from an entity, either by remove_component or by destroying the entity.
+        destroy,
+        // Component has been patched or marked dirty.
+        update,
+    };
+
+    // Called with the ECS that notifies the observer, the entity whose component the event concerns
+    // and the user data the observer has been registered with.
+    using Observer_Callback = void (*)(ECS&, Entity, void* user_data);
+
     class ECS {
+        struct Observer;
+
     public:
+        using Observer_Handle = Handle<Observer>;
+
         ECS() = default;
+        explicit ECS(Storage_Mode);
         ECS(ECS const&);
         ECS(ECS&&);
         ~ECS();
 
+        [[nodiscard]] Storage_Mode get_storage_mode() const;
+
         // Returns: Array of entities that have Component associated with them
         template <typename Component>
         [[nodiscard]] Entity const* entities() const;
@@ -29,13 +79,35 @@ namespace anton_engine {
         template <typename Component>
         [[nodiscard]] Component const* components() const;
 
-        // Create entity without any attached components
+        // Returns: Number of entities that have Component associated with them
+        template <typename Component>
+        [[nodiscard]] i64 count() const;
+
+        // Create entity without any attached components.
+        // Indices of destroyed entities are reused with an incremented generation.
         Entity create();
 
         // Create entity with Components... components attached.
         // Components... must be default constructible.
         template <typename... Components>
         auto create();
+
+        // Create count entities with copies of templates attached.
+        // Every container is grown once and the components are written in bulk.
+        // The entities get consecutive indices and do not reuse the indices of destroyed entities.
+        // Returns: The first created entity or null_entity if count is 0.
+        //          The i-th created entity is make_entity(entity_index(first) + i, 0).
+        template <typename... Components>
+        Entity create_many(i64 count, Components const&... templates);
+
+        // Create count entities with value-initialized Components... attached
+        // and call initializer(i64 i, Entity, Components&...) for the i-th created entity.
+        // The construct observers are notified after all entities have been initialized.
+        // initializer must not create or destroy entities nor add or remove components.
+        template <typename... Components, typename Initializer,
+                  typename = atl::enable_if<atl::is_invocable<Initializer, i64, Entity, Components&...>>>
+        Entity create_many(i64 count, Initializer&& initializer);
+
         void destroy(Entity);
         template <typename T, typename... Ctor_Args>
         T& add_component(Entity, Ctor_Args&&... args);
@@ -46,17 +118,79 @@ namespace anton_engine {
         template <typename... Ts>
         decltype(auto) try_get_component(Entity);
         template <typename... Ts>
+        decltype(auto) try_get_component(Entity) const;
+        // With Storage_Mode::sparse_set tests the component signature of the entity,
+        // which takes a single AND for the first 64 component types.
+        template <typename... Ts>
         [[nodiscard]] bool has_component(Entity);
 
+        // Change tracking
+        // Containers that track changes stamp the components with the current change tick when they are added
+        // and when they are patched or marked dirty, which lets a consumer visit only the components that have
+        // changed since it last looked. A consumer calls advance_change_tick, visits the components changed after
+        // the tick it has recorded the previous time and records the returned tick.
+        // Components modified without patch or mark_dirty are not considered changed.
+
+        // Makes the container of T track changes. Not available with Storage_Mode::archetype.
+        template <typename T>
+        void track_changes();
+        [[nodiscard]] u64 get_change_tick() const;
+        // Starts a new change tick. Must not be called while systems are updated concurrently.
+        // Returns: The previous change tick, which is the greatest tick the changes made so far have been stamped with.
+        u64 advance_change_tick();
+
+        // Calls callable(T&) with the component T of entity, marks it as changed and notifies the on_update observers.
+        template <typename T, typename Callable>
+        T& patch(Entity, Callable&& callable);
+        // Marks the component T of entity as changed and notifies the on_update observers.
+        template <typename T>
+        void mark_dirty(Entity);
+
+        // Calls callable(Entity, T&) for every entity whose component T has been added after tick.
+        // callable must not add or remove components T.
+        template <typename T, typename Callable>
+        void each_added(u64 tick, Callable&& callable);
+        // Calls callable(Entity, T&) for every entity whose component T has been added or changed after tick.
+        // callable must not add or remove components T.
+        template <typename T, typename Callable>
+        void each_changed(u64 tick, Callable&& callable);
+
+        // Observers
+        // Observers are called synchronously on the thread that makes the change. on_destroy observers are called
+        // while the component is still accessible. Observers must not add or remove components of the entity
+        // they are notified about.
+        template <typename T>
+        Observer_Handle on_construct(Observer_Callback callback, void* user_data = nullptr);
+        template <typename T>
+        Observer_Handle on_destroy(Observer_Callback callback, void* user_data = nullptr);
+        template <typename T>
+        Observer_Handle on_update(Observer_Callback callback, void* user_data = nullptr);
+        void remove_observer(Observer_Handle);
+
         template <typename Component, typename Sort, typename Predicate>
         void sort(Sort, Predicate);
 
         template <typename... Ts>
         Component_View<Ts...> view();
 
+        // Returns a group owning the containers of Ts... creating it if it does not exist yet.
+        // The group keeps the entities that have all of Ts... at the beginning of every owned container,
+        // which makes iterating them as cheap as iterating a single container.
+        // A container may be owned by only one group. Owned containers cannot be sorted.
+        // Not available with Storage_Mode::archetype.
+        template <typename... Ts>
+        Component_Group<Ts...> group();
+
+        // Returns a query of the entities that have all of Ts... attached, creating it if it does not exist yet.
+        // Queries are cached by the ECS and updated incrementally as components are added and removed,
+        // which makes repeated queries cheap. Every query slightly slows down adding and removing components.
+        // Not available with Storage_Mode::archetype.
+        template <typename... Ts>
+        Component_Query<Ts...> query();
+
         // Ts... are the components to copy
         template <typename... Ts>
-        ECS snapshot() const;
+        ECS snapshot(Snapshot_Mode mode = Snapshot_Mode::copy) const;
 
         atl::Vector<Entity> const& get_entities() const;
         atl::Vector<Entity> const& get_entities_to_remove() const;
@@ -69,19 +203,110 @@ namespace anton_engine {
     private:
         struct Components_Container_Data {
             u64 family;
+            i64 type_index;
             Component_Container_Base* container = nullptr;
+            // Persistent copy of container that shared snapshots are served from.
+            mutable Component_Container_Base* snapshot_cache = nullptr;
             void (*remove)(Component_Container_Base&, Entity);
+            // Removes the entities whose indices are set in a bitset of the given number of bits.
+            void (*remove_marked)(Component_Container_Base&, u64 const*, i64);
             Component_Container_Base* (*make_snapshot)(Component_Container_Base const&);
+            void (*update_snapshot)(Component_Container_Base const&, Component_Container_Base*&);
+            void (*swap_slots)(Component_Container_Base&, i64, i64);
+            // false if container is borrowed from another ECS (shared snapshots).
+            bool owns_container = true;
+            // Index of the group that owns the container or -1.
+            i64 group = -1;
+        };
+
+        struct Observer {
+            u64 id;
+            i64 type_index;
+            Observer_Event event;
+            Observer_Callback callback;
+            void* user_data;
+        };
+
+        struct Query_Data {
+            // Signature bits of the components an entity must have to match.
+            atl::Vector<u64> mask;
+            atl::Vector<Entity> entities;
+            // Position of every entity in entities indexed by entity index. -1 if the entity does not match.
+            atl::Vector<i64> positions;
+        };
+
+        struct Group_Data {
+            // Indices of the owned containers in containers.
+            atl::Vector<i64> containers;
+            // Number of entities that have all of the owned components.
+            // Those entities occupy the first size slots of every owned container in the same order.
+            i64 size = 0;
         };
 
         atl::Vector<Entity> _entities;
         atl::Vector<Entity> entities_to_remove;
+        // Destroyed entities whose indices may be reused.
+        atl::Vector<Entity> free_entities;
         atl::Vector<Components_Container_Data> containers;
+        // Maps component type index to the index of its container in containers. -1 if there is no container.
+        atl::Vector<i64> container_table;
         Integer_Sequence_Generator id_generator;
+        // Non-null if the ECS uses Storage_Mode::archetype, in which case containers is empty.
+        Archetype_Storage* archetypes = nullptr;
+        atl::Vector<Group_Data*> groups;
+        atl::Vector<Query_Data*> queries;
+        // Component signatures indexed by entity index (Storage_Mode::sparse_set only). A signature occupies
+        // signature_stride words and has bit i set if the entity has the component with type index i.
+        atl::Vector<u64> signatures;
+        // Entity whose signature is stored at each index or null_entity. Used to reject stale handles.
+        atl::Vector<Entity> signature_owners;
+        i64 signature_stride = 1;
+        atl::Vector<Observer> observers;
+        // Bitmask of the observed Observer_Events of every component type index.
+        atl::Vector<u8> observed_events;
+        u64 next_observer_id = 0;
+        // Tick that added and changed components are stamped with.
+        u64 change_tick = 1;
 
         template <typename... Container_Data>
-        ECS(atl::Vector<Entity> const&, atl::Vector<Entity> const&, Integer_Sequence_Generator, Container_Data...);
+        ECS(Snapshot_Mode, atl::Vector<Entity> const&, atl::Vector<Entity> const&, atl::Vector<Entity> const&, Integer_Sequence_Generator,
+            Container_Data const&...);
 
+        void set_container_index(i64 type_index, i64 container_index);
+        // prototypes are nullptr for value-initialized components. initializer(i64 i, Entity, Components&...) is called
+        // for every created entity after its components have been constructed and before the construct observers run.
+        template <typename... Components, typename Initializer>
+        Entity create_many_from(i64 count, Initializer& initializer, Components const*... prototypes);
+        // Appends count components to the container of T without updating the signatures and groups.
+        // Returns: Pointer to the first appended component. The components are consecutive unless T is empty.
+        template <typename T>
+        T* add_components(Entity const* entities, i64 count, T const* prototype);
+        // Sets the signature bit of T for entities and moves them into the group of T.
+        template <typename T>
+        void register_components(Entity const* entities, i64 count);
+        // Returns: Signature of entity or nullptr if entity has no signature.
+        [[nodiscard]] u64 const* find_signature(Entity) const;
+        // Gives entity an empty signature.
+        void claim_signature(Entity);
+        // Removes entity from the queries and clears its signature.
+        void release_signature(Entity);
+        void set_signature_bit(Entity, i64 type_index);
+        void clear_signature_bit(Entity, i64 type_index);
+        // Recomputes the signatures from the containers.
+        void rebuild_signatures();
+        [[nodiscard]] bool matches_query(Query_Data const&, Entity) const;
+        Query_Data* find_or_create_query(i64 const* types, i64 count);
+        Observer_Handle add_observer(i64 type_index, Observer_Event, Observer_Callback, void* user_data);
+        [[nodiscard]] bool is_observed(i64 type_index, Observer_Event) const;
+        void notify(i64 type_index, Observer_Event, Entity);
+        // Calls the on_destroy observers for the components of entities that are about to be destroyed.
+        void notify_destroyed(atl::Slice<Entity const> entities);
+        // Moves entity to the owned part of the containers of group if it has all of the owned components.
+        void enter_group(i64 group, Entity);
+        // Moves entity out of the owned part of the containers of group if it belongs to the group.
+        void leave_group(i64 group, Entity);
+        template <typename T>
+        Components_Container_Data* ensure_container_data();
         template <typename T>
         Component_Container<T>* ensure_container();
         template <typename T>
@@ -92,35 +317,90 @@ namespace anton_engine {
         Components_Container_Data* find_container_data();
         template <typename T>
         Components_Container_Data const* find_container_data() const;
+        // Copies the components T from archetypes into a container of snapshot.
+        template <typename T>
+        void copy_archetype_components(ECS& snapshot) const;
     };
 
     ECS& get_ecs();
+
+    namespace detail {
+#if ANTON_ECS_ACCESS_DEBUG
+        // Verifies that the system updated on the calling thread has declared access to the component with type_index,
+        // with writes if write is true. Does nothing outside of systems and for systems that do not declare their access.
+        void verify_component_access(i64 type_index, bool write);
+#endif
+    } // namespace detail
 } // namespace anton_engine
 
 namespace anton_engine {
     inline ECS::ECS(ECS const& other)
-        : _entities(other._entities), entities_to_remove(other.entities_to_remove), containers(other.containers), id_generator(other.id_generator) {
+        : _entities(other._entities), entities_to_remove(other.entities_to_remove), free_entities(other.free_entities), containers(other.containers),
+          container_table(other.container_table), id_generator(other.id_generator),
+          archetypes(other.archetypes ? new Archetype_Storage(*other.archetypes) : nullptr), groups(atl::reserve, other.groups.size()),
+          queries(atl::reserve, other.queries.size()), signatures(other.signatures), signature_owners(other.signature_owners),
+          signature_stride(other.signature_stride), change_tick(other.change_tick) {
         for (Components_Container_Data& data: containers) {
             data.container = data.make_snapshot(*data.container);
+            data.snapshot_cache = nullptr;
+            data.owns_container = true;
+        }
+
+        for (Group_Data const* const group: other.groups) {
+            groups.push_back(new Group_Data(*group));
+        }
+
+        for (Query_Data const* const query: other.queries) {
+            queries.push_back(new Query_Data(*query));
         }
     }
 
     inline ECS::ECS(ECS&& other)
-        : _entities(atl::move(other._entities)), entities_to_remove(atl::move(other.entities_to_remove)),
-          containers(atl::move(other.containers)), id_generator(other.id_generator) {}
+        : _entities(atl::move(other._entities)), entities_to_remove(atl::move(other.entities_to_remove)), free_entities(atl::move(other.free_entities)),
+          containers(atl::move(other.containers)), container_table(atl::move(other.container_table)), id_generator(other.id_generator),
+          archetypes(other.archetypes), groups(atl::move(other.groups)), queries(atl::move(other.queries)), signatures(atl::move(other.signatures)),
+          signature_owners(atl::move(other.signature_owners)), signature_stride(other.signature_stride), observers(atl::move(other.observers)),
+          observed_events(atl::move(other.observed_events)), next_observer_id(other.next_observer_id), change_tick(other.change_tick) {
+        other.archetypes = nullptr;
+    }
+
+    inline Storage_Mode ECS::get_storage_mode() const {
+        return archetypes ? Storage_Mode::archetype : Storage_Mode::sparse_set;
+    }
 
     template <typename Component>
     [[nodiscard]] inline Entity const* ECS::entities() const {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<Component>(), false);
+#endif
+        ANTON_VERIFY(!archetypes, "Contiguous arrays of entities are not available with Storage_Mode::archetype.");
         auto const* c = find_container<Component>();
         return c ? c->entities() : nullptr;
     }
 
     template <typename Component>
     [[nodiscard]] inline Component const* ECS::components() const {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<Component>(), false);
+#endif
+        ANTON_VERIFY(!archetypes, "Contiguous arrays of components are not available with Storage_Mode::archetype.");
         auto const* c = find_container<Component>();
         return c ? c->components() : nullptr;
     }
 
+    template <typename Component>
+    [[nodiscard]] inline i64 ECS::count() const {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<Component>(), false);
+#endif
+        if (archetypes) {
+            return archetypes->count<Component>();
+        }
+
+        auto const* c = find_container<Component>();
+        return c ? c->size() : 0;
+    }
+
     template <typename... Components>
     inline auto ECS::create() {
         if constexpr (sizeof...(Components) == 0) {
@@ -131,25 +411,281 @@ namespace anton_engine {
         }
     }
 
+    template <typename... Components>
+    inline Entity ECS::create_many(i64 const count, Components const&... templates) {
+        auto initializer = [](i64, Entity, Components&...) {};
+        return create_many_from<Components...>(count, initializer, &templates...);
+    }
+
+    template <typename... Components, typename Initializer, typename>
+    inline Entity ECS::create_many(i64 const count, Initializer&& initializer) {
+        return create_many_from<Components...>(count, initializer, static_cast<Components const*>(nullptr)...);
+    }
+
+    template <typename... Components, typename Initializer>
+    inline Entity ECS::create_many_from(i64 const count, Initializer& initializer, Components const*... prototypes) {
+#if ANTON_ECS_ITERATION_DEBUG
+        ANTON_VERIFY(detail::parallel_each_depth() == 0, "Entities must not be created during parallel_each.");
+#endif
+        if (count <= 0) {
+            return null_entity;
+        }
+
+        u64 const first_index = id_generator.next(count);
+        i64 const first = _entities.size();
+        _entities.reserve(first + count);
+        for (i64 i = 0; i < count; ++i) {
+            _entities.push_back(make_entity(first_index + i, 0));
+            if (!archetypes) {
+                claim_signature(make_entity(first_index + i, 0));
+            }
+        }
+
+        // The initializer writes through the consecutive slots the components have been constructed in.
+        // Calls initializer for the entities [offset, offset + run) whose components start at slot of arrays.
+        auto const initialize = [&initializer, first_index](i64 const offset, i64 const run, i64 const slot, Components* const... arrays) {
+            for (i64 i = 0; i < run; ++i) {
+                initializer(offset + i, make_entity(first_index + offset + i, 0), component_at(arrays, slot + i)...);
+            }
+        };
+
+        Entity const* const entities = _entities.data() + first;
+        if (archetypes) {
+            // The trailing nullptr keeps the arrays non-empty when there are no components.
+            Component_Type_Info const* const infos[] = {component_type_info<Components>()..., nullptr};
+            void const* const prototype_pointers[] = {static_cast<void const*>(prototypes)..., nullptr};
+            Archetype_Storage::Row_Range const range = archetypes->create_many(entities, count, infos, prototype_pointers, sizeof...(Components));
+            Archetype_Storage::Archetype const& archetype = archetypes->get_archetype(range.archetype);
+            for (i64 i = 0; i < count;) {
+                i64 const row = range.first_row + i;
+                i64 const chunk = row / archetype.capacity;
+                i64 const chunk_row = row % archetype.capacity;
+                i64 const run = math::min(count - i, archetype.capacity - chunk_row);
+                initialize(i, run, chunk_row,
+                           Archetype_Storage::chunk_components<Components>(
+                               archetype, chunk, Archetype_Storage::find_column(archetype, component_type_index<Components>()))...);
+                i += run;
+            }
+        } else {
+            initialize(0, count, 0, add_components<Components>(entities, count, prototypes)...);
+            (..., register_components<Components>(_entities.data() + first, count));
+        }
+
+        i64 const types[] = {component_type_index<Components>()..., -1};
+        for (i64 t = 0; t < static_cast<i64>(sizeof...(Components)); ++t) {
+            if (is_observed(types[t], Observer_Event::construct)) {
+                for (i64 i = 0; i < count; ++i) {
+                    notify(types[t], Observer_Event::construct, make_entity(first_index + i, 0));
+                }
+            }
+        }
+        return make_entity(first_index, 0);
+    }
+
+    template <typename T>
+    inline T* ECS::add_components(Entity const* const entities, i64 const count, T const* const prototype) {
+        Component_Container<T>* const container = static_cast<Component_Container<T>*>(ensure_container_data<T>()->container);
+        i64 const first = container->add_many(entities, count, prototype);
+        if constexpr (atl::is_empty<T>) {
+            return container->components();
+        } else {
+            return container->components(first, first + count) + first;
+        }
+    }
+
+    template <typename T>
+    inline void ECS::register_components(Entity const* const entities, i64 const count) {
+        Components_Container_Data const& data = *find_container_data<T>();
+        for (i64 i = 0; i < count; ++i) {
+            set_signature_bit(entities[i], data.type_index);
+        }
+
+        if (data.group != -1) {
+            for (i64 i = 0; i < count; ++i) {
+                enter_group(data.group, entities[i]);
+            }
+        }
+    }
+
+    template <typename T>
+    inline void ECS::track_changes() {
+        ANTON_VERIFY(!archetypes, "Change tracking is not available with Storage_Mode::archetype.");
+        ensure_container<T>()->enable_change_tracking(change_tick);
+    }
+
+    inline u64 ECS::get_change_tick() const {
+        return change_tick;
+    }
+
+    inline u64 ECS::advance_change_tick() {
+        u64 const previous = change_tick;
+        change_tick += 1;
+        for (Components_Container_Data& data: containers) {
+            if (data.container->tracks_changes()) {
+                data.container->set_change_tick(change_tick);
+            }
+        }
+        return previous;
+    }
+
+    template <typename T, typename Callable>
+    inline T& ECS::patch(Entity const entity, Callable&& callable) {
+        callable(get_component<T>(entity));
+        mark_dirty<T>(entity);
+        return get_component<T>(entity);
+    }
+
+    template <typename T>
+    inline void ECS::mark_dirty(Entity const entity) {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<T>(), true);
+#endif
+        if (!archetypes) {
+            Component_Container<T>* const container = find_container<T>();
+            ANTON_ASSERT(container && container->has(entity), "Attempting to mark dirty a component that has not been added");
+            container->mark_changed(entity);
+        }
+
+        if (is_observed(component_type_index<T>(), Observer_Event::update)) {
+            notify(component_type_index<T>(), Observer_Event::update, entity);
+        }
+    }
+
+    template <typename T, typename Callable>
+    inline void ECS::each_added(u64 const tick, Callable&& callable) {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<T>(), false);
+#endif
+        Component_Container<T>* const container = find_container<T>();
+        if (!container) {
+            return;
+        }
+
+        ANTON_VERIFY(container->tracks_changes(), "Changes of the component are not tracked.");
+        u64 const* const ticks = container->added_ticks();
+        for (i64 i = 0; i < container->size(); ++i) {
+            if (ticks[i] > tick) {
+                callable(container->entities()[i], component_at(container->components(i, i + 1), i));
+            }
+        }
+    }
+
+    template <typename T, typename Callable>
+    inline void ECS::each_changed(u64 const tick, Callable&& callable) {
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<T>(), false);
+#endif
+        Component_Container<T>* const container = find_container<T>();
+        if (!container) {
+            return;
+        }
+
+        ANTON_VERIFY(container->tracks_changes(), "Changes of the component are not tracked.");
+        u64 const* const ticks = container->changed_ticks();
+        for (i64 i = 0; i < container->size(); ++i) {
+            if (ticks[i] > tick) {
+                callable(container->entities()[i], component_at(container->components(i, i + 1), i));
+            }
+        }
+    }
+
+    template <typename T>
+    inline ECS::Observer_Handle ECS::on_construct(Observer_Callback const callback, void* const user_data) {
+        return add_observer(component_type_index<T>(), Observer_Event::construct, callback, user_data);
+    }
+
+    template <typename T>
+    inline ECS::Observer_Handle ECS::on_destroy(Observer_Callback const callback, void* const user_data) {
+        return add_observer(component_type_index<T>(), Observer_Event::destroy, callback, user_data);
+    }
+
+    template <typename T>
+    inline ECS::Observer_Handle ECS::on_update(Observer_Callback const callback, void* const user_data) {
+        return add_observer(component_type_index<T>(), Observer_Event::update, callback, user_data);
+    }
+
+    inline bool ECS::is_observed(i64 const type_index, Observer_Event const event) const {
+        return type_index < observed_events.size() && (observed_events[type_index] & (1 << static_cast<u8>(event)));
+    }
+
     inline void ECS::destroy(Entity const entity) {
         entities_to_remove.push_back(entity);
     }
 
     template <typename T, typename... Ctor_Args>
     inline T& ECS::add_component(Entity const entity, Ctor_Args&&... args) {
-        Component_Container<T>& components = *ensure_container<T>();
-        return components.add(entity, atl::forward<Ctor_Args>(args)...);
+#if ANTON_ECS_ITERATION_DEBUG
+        ANTON_VERIFY(detail::parallel_each_depth() == 0, "Components must not be added during parallel_each.");
+#endif
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<T>(), true);
+#endif
+        bool const observed = is_observed(component_type_index<T>(), Observer_Event::construct);
+        if (archetypes) {
+            T& component = archetypes->add<T>(entity, atl::forward<Ctor_Args>(args)...);
+            if (!observed) {
+                return component;
+            }
+
+            // Observers may move the entity to another archetype.
+            notify(component_type_index<T>(), Observer_Event::construct, entity);
+            return *archetypes->try_get<T>(entity);
+        }
+
+        Components_Container_Data& data = *ensure_container_data<T>();
+        T& component = static_cast<Component_Container<T>*>(data.container)->add(entity, atl::forward<Ctor_Args>(args)...);
+        set_signature_bit(entity, component_type_index<T>());
+        if (data.group == -1 && !observed) {
+            return component;
+        }
+
+        // Entering the group moves the component.
+        if (data.group != -1) {
+            enter_group(data.group, entity);
+        }
+
+        if (observed) {
+            notify(component_type_index<T>(), Observer_Event::construct, entity);
+        }
+        return find_container<T>()->get(entity);
     }
 
     template <typename T>
     inline void ECS::remove_component(Entity const entity) {
-        Component_Container<T>& components = *ensure_container<T>();
-        components.remove(entity);
+#if ANTON_ECS_ITERATION_DEBUG
+        ANTON_VERIFY(detail::parallel_each_depth() == 0, "Components must not be removed during parallel_each.");
+#endif
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<T>(), true);
+#endif
+        if (is_observed(component_type_index<T>(), Observer_Event::destroy)) {
+            notify(component_type_index<T>(), Observer_Event::destroy, entity);
+        }
+
+        if (archetypes) {
+            archetypes->remove<T>(entity);
+            return;
+        }
+
+        Components_Container_Data& data = *ensure_container_data<T>();
+        if (data.group != -1) {
+            leave_group(data.group, entity);
+        }
+        clear_signature_bit(entity, component_type_index<T>());
+        static_cast<Component_Container<T>*>(data.container)->remove(entity);
     }
 
     template <typename... Ts>
     inline decltype(auto) ECS::get_component(Entity const entity) {
         if constexpr (sizeof...(Ts) == 1) {
+#if ANTON_ECS_ACCESS_DEBUG
+            detail::verify_component_access(component_type_index<Ts...>(), false);
+#endif
+            if (archetypes) {
+                ANTON_ASSERT(archetypes->has(entity, component_type_index<Ts...>()), "Attempting to get component of an entity that does not have it");
+                return *archetypes->try_get<Ts...>(entity);
+            }
+
             Component_Container<Ts...>* components = ensure_container<Ts...>();
             return components->get(entity);
         } else {
@@ -160,6 +696,13 @@ namespace anton_engine {
     template <typename... Ts>
     inline decltype(auto) ECS::try_get_component(Entity const entity) {
         if constexpr (sizeof...(Ts) == 1) {
+#if ANTON_ECS_ACCESS_DEBUG
+            detail::verify_component_access(component_type_index<Ts...>(), false);
+#endif
+            if (archetypes) {
+                return archetypes->try_get<Ts...>(entity);
+            }
+
             Component_Container<Ts...>* components = ensure_container<Ts...>();
             return components->try_get(entity);
         } else {
@@ -167,30 +710,140 @@ namespace anton_engine {
         }
     }
 
+    template <typename... Ts>
+    inline decltype(auto) ECS::try_get_component(Entity const entity) const {
+        if constexpr (sizeof...(Ts) == 1) {
+#if ANTON_ECS_ACCESS_DEBUG
+            detail::verify_component_access(component_type_index<Ts...>(), false);
+#endif
+            if (archetypes) {
+                return atl::as_const(*archetypes).try_get<Ts...>(entity);
+            }
+
+            Component_Container<Ts...> const* components = find_container<Ts...>();
+            return components ? components->try_get(entity) : nullptr;
+        } else {
+            return atl::make_tuple(try_get_component<Ts>(entity)...);
+        }
+    }
+
     template <typename... Ts>
     inline bool ECS::has_component(Entity const entity) {
         static_assert(sizeof...(Ts) > 0, "Empty parameter pack");
-        auto const containers = atl::make_tuple(find_container<Ts>()...);
-        return (... && (atl::get<Component_Container<Ts>*>(containers) ? atl::get<Component_Container<Ts>*>(containers)->has(entity) : false));
+        if (archetypes) {
+            return (... && archetypes->has(entity, component_type_index<Ts>()));
+        }
+
+        u64 const* const signature = find_signature(entity);
+        if (!signature) {
+            return false;
+        }
+
+        i64 const types[] = {component_type_index<Ts>()...};
+        u64 mask = 0;
+        bool first_word = true;
+        for (i64 const type: types) {
+            first_word = first_word && type < 64;
+            mask |= u64(1) << (type % 64);
+        }
+
+        if (first_word) {
+            return (signature[0] & mask) == mask;
+        }
+
+        for (i64 const type: types) {
+            if (type >= signature_stride * 64 || !((signature[type / 64] >> (type % 64)) & 1)) {
+                return false;
+            }
+        }
+        return true;
     }
 
     template <typename Component, typename Sort, typename Predicate>
     inline void ECS::sort(Sort sort, Predicate predicate) {
-        Component_Container<Component>* const container = find_container<Component>();
-        if (container) {
-            container->sort(sort, predicate);
+#if ANTON_ECS_ACCESS_DEBUG
+        detail::verify_component_access(component_type_index<Component>(), true);
+#endif
+        ANTON_VERIFY(!archetypes, "Sorting components is not available with Storage_Mode::archetype.");
+        if (Components_Container_Data* const data = find_container_data<Component>()) {
+            ANTON_VERIFY(data->group == -1, "Cannot sort a container owned by a group.");
+            static_cast<Component_Container<Component>*>(data->container)->sort(sort, predicate);
         }
     }
 
     template <typename... Ts>
     inline Component_View<Ts...> ECS::view() {
+#if ANTON_ECS_ACCESS_DEBUG
+        (..., detail::verify_component_access(component_type_index<Ts>(), false));
+#endif
+        if (archetypes) {
+            return Component_View<Ts...>(archetypes);
+        }
+
         return Component_View<Ts...>(ensure_container<Ts>()...);
     }
 
     template <typename... Ts>
-    inline ECS ECS::snapshot() const {
+    inline Component_Group<Ts...> ECS::group() {
+        ANTON_VERIFY(!archetypes, "Groups are not available with Storage_Mode::archetype.");
+        // Creating containers may reallocate containers. Look the data up once all of them exist.
+        (..., ensure_container_data<Ts>());
+        Components_Container_Data* const data[] = {find_container_data<Ts>()...};
+        i64 const group = data[0]->group;
+        for (Components_Container_Data const* const d: data) {
+            ANTON_VERIFY(d->group == group, "Component is already owned by another group.");
+        }
+
+        if (group != -1) {
+            ANTON_VERIFY(groups[group]->containers.size() == sizeof...(Ts), "Component is already owned by another group.");
+            return Component_Group<Ts...>(&groups[group]->size, static_cast<Component_Container<Ts>*>(find_container_data<Ts>()->container)...);
+        }
+
+        Group_Data* const group_data = groups.emplace_back(new Group_Data);
+        i64 const group_index = groups.size() - 1;
+        Component_Container_Base* smallest = data[0]->container;
+        for (Components_Container_Data* const d: data) {
+            d->group = group_index;
+            group_data->containers.push_back(d - containers.data());
+            if (d->container->size() < smallest->size()) {
+                smallest = d->container;
+            }
+        }
+
+        // enter_group may only swap the examined entity with one at a lower slot, therefore visiting the slots in order reaches every entity.
+        for (i64 i = 0; i < smallest->size(); ++i) {
+            enter_group(group_index, smallest->entities()[i]);
+        }
+
+        return Component_Group<Ts...>(&group_data->size, static_cast<Component_Container<Ts>*>(find_container_data<Ts>()->container)...);
+    }
+
+    template <typename... Ts>
+    inline Component_Query<Ts...> ECS::query() {
+        ANTON_VERIFY(!archetypes, "Queries are not available with Storage_Mode::archetype.");
+        (..., ensure_container_data<Ts>());
+        i64 const types[] = {component_type_index<Ts>()...};
+        Query_Data const* const query_data = find_or_create_query(types, sizeof...(Ts));
+        return Component_Query<Ts...>(&query_data->entities, find_container<Ts>()...);
+    }
+
+    template <typename... Ts>
+    inline ECS ECS::snapshot(Snapshot_Mode const mode) const {
+        if (archetypes) {
+            // Archetypes have no persistent copy to share. Deep copy the components into sparse set containers,
+            // which keeps the snapshot usable by code that requires contiguous component arrays.
+            ECS snapshot;
+            snapshot._entities = _entities;
+            snapshot.entities_to_remove = entities_to_remove;
+            snapshot.free_entities = free_entities;
+            snapshot.id_generator = id_generator;
+            (..., copy_archetype_components<Ts>(snapshot));
+            snapshot.rebuild_signatures();
+            return snapshot;
+        }
+
         ANTON_VERIFY((... && (find_container_data<Ts>() != nullptr)), "Cannot create a snapshot of component that has not been added.");
-        return ECS(_entities, entities_to_remove, id_generator, *find_container_data<Ts>()...);
+        return ECS(mode, _entities, entities_to_remove, free_entities, id_generator, *find_container_data<Ts>()...);
     }
 
     inline atl::Vector<Entity> const& ECS::get_entities() const {
@@ -202,37 +855,178 @@ namespace anton_engine {
     }
 
     inline void ECS::remove_requested_entities() {
-        for (auto& container_data: containers) {
-            for (Entity const entity: entities_to_remove) {
-                if (container_data.container->has(entity)) {
-                    container_data.remove(*container_data.container, entity);
-                }
+#if ANTON_ECS_ITERATION_DEBUG
+        ANTON_VERIFY(detail::parallel_each_depth() == 0, "Entities must not be removed during parallel_each.");
+#endif
+        if (entities_to_remove.size() == 0) {
+            return;
+        }
+
+        i64 index_count = 0;
+        for (Entity const entity: entities_to_remove) {
+            index_count = math::max(index_count, static_cast<i64>(entity_index(entity)) + 1);
+        }
+
+        // Generation of the live entity at each requested index. At most one entity is alive per index,
+        // therefore a request is honoured exactly when its generation matches, which skips duplicate
+        // requests and stale handles without comparing the requests against each other.
+        // The temporaries live only until the end of the frame, hence they come from the frame allocator.
+        constexpr u32 not_alive = 0xFFFFFFFF;
+        atl::Vector<u32, atl::Polymorphic_Allocator> live(atl::reserve, index_count, &atl::get_frame_allocator());
+        live.resize(index_count, not_alive);
+        for (Entity const entity: _entities) {
+            u64 const index = entity_index(entity);
+            if (static_cast<i64>(index) < index_count) {
+                live[index] = entity_generation(entity);
             }
         }
 
+        // Mark the indices of the requested entities that are alive.
+        atl::Vector<u64, atl::Polymorphic_Allocator> marked(atl::reserve, (index_count + 63) / 64, &atl::get_frame_allocator());
+        marked.resize((index_count + 63) / 64, 0);
         for (Entity const entity: entities_to_remove) {
-            auto iter = atl::find(_entities.begin(), _entities.end(), entity);
-            _entities.erase_unsorted(iter);
+            u64 const index = entity_index(entity);
+            if (live[index] == entity_generation(entity)) {
+                marked[index / 64] |= u64(1) << (index % 64);
+            }
         }
 
+        auto const is_marked = [&marked, index_count](Entity const entity) -> bool {
+            u64 const index = entity_index(entity);
+            return static_cast<i64>(index) < index_count && ((marked[index / 64] >> (index % 64)) & 1);
+        };
+
+        // Remove the marked entities from _entities in a single pass.
+        atl::Vector<Entity, atl::Polymorphic_Allocator> removed(&atl::get_frame_allocator());
+        i64 kept = 0;
+        for (i64 i = 0; i < _entities.size(); ++i) {
+            Entity const entity = _entities[i];
+            if (is_marked(entity)) {
+                removed.push_back(entity);
+                // Retire the index once its generations are exhausted.
+                if (entity_generation(entity) < max_entity_generation) {
+                    free_entities.push_back(entity);
+                }
+            } else {
+                _entities[kept] = entity;
+                kept += 1;
+            }
+        }
+        _entities.erase(_entities.begin() + kept, _entities.end());
         entities_to_remove.clear();
+
+        if (removed.size() == 0) {
+            return;
+        }
+
+        notify_destroyed(removed);
+        if (archetypes) {
+            for (Entity const entity: removed) {
+                archetypes->destroy(entity);
+            }
+            return;
+        }
+
+        // Owned containers are compacted without reordering, therefore the group shrinks by the number of
+        // removed entities in its owned part and the entities that remain in it stay at the front.
+        for (Group_Data* const group: groups) {
+            Entity const* const entities = containers[group->containers[0]].container->entities();
+            i64 removed_from_group = 0;
+            for (i64 i = 0; i < group->size; ++i) {
+                removed_from_group += is_marked(entities[i]);
+            }
+            group->size -= removed_from_group;
+        }
+
+        for (Entity const entity: removed) {
+            release_signature(entity);
+        }
+
+        for (auto& container_data: containers) {
+            Component_Container_Base& container = *container_data.container;
+            // A single sweep over the container is cheaper than looking every removed entity up unless only
+            // a small fraction of the container is removed. The owned containers of groups must be swept
+            // to keep the order the group sizes have been computed for.
+            if (container_data.group != -1 || container.size() <= 8 * removed.size()) {
+                container_data.remove_marked(container, marked.data(), index_count);
+            } else {
+                for (Entity const entity: removed) {
+                    if (container.has(entity)) {
+                        container_data.remove(container, entity);
+                    }
+                }
+            }
+        }
     }
 
     template <typename... Container_Data>
-    inline ECS::ECS(atl::Vector<Entity> const& e, atl::Vector<Entity> const& er, Integer_Sequence_Generator g, Container_Data... data)
-        : _entities(e), entities_to_remove(er), containers(atl::reserve, sizeof...(Container_Data)), id_generator(g) {
+    inline ECS::ECS(Snapshot_Mode const mode, atl::Vector<Entity> const& e, atl::Vector<Entity> const& er, atl::Vector<Entity> const& fe,
+                    Integer_Sequence_Generator g, Container_Data const&... data)
+        : _entities(e), entities_to_remove(er), free_entities(fe), containers(atl::reserve, sizeof...(Container_Data)), id_generator(g) {
         static_assert((... && atl::is_same<Container_Data, Components_Container_Data>),
                       "Template argument Container_Data is not Components_Container_Data.");
-        (..., containers.emplace_back(data.family, data.make_snapshot(*data.container), data.remove, data.make_snapshot));
+        if (mode == Snapshot_Mode::copy) {
+            (..., containers.emplace_back(data.family, data.type_index, data.make_snapshot(*data.container), nullptr, data.remove, data.remove_marked,
+                                          data.make_snapshot, data.update_snapshot, data.swap_slots, true, -1));
+        } else {
+            (..., data.update_snapshot(*data.container, data.snapshot_cache));
+            (..., containers.emplace_back(data.family, data.type_index, data.snapshot_cache, nullptr, data.remove, data.remove_marked,
+                                          data.make_snapshot, data.update_snapshot, data.swap_slots, false, -1));
+        }
+
+        for (i64 i = 0; i < containers.size(); ++i) {
+            set_container_index(containers[i].type_index, i);
+        }
+
+        rebuild_signatures();
+    }
+
+    inline void ECS::set_container_index(i64 const type_index, i64 const container_index) {
+        if (type_index >= container_table.size()) {
+            container_table.resize(type_index + 1, -1);
+        }
+        container_table[type_index] = container_index;
+    }
+
+    inline void ECS::enter_group(i64 const group, Entity const entity) {
+        Group_Data& group_data = *groups[group];
+        for (i64 const index: group_data.containers) {
+            Component_Container_Base const& container = *containers[index].container;
+            if (!container.has(entity) || container.get_component_index(entity) < group_data.size) {
+                return;
+            }
+        }
+
+        for (i64 const index: group_data.containers) {
+            Components_Container_Data& data = containers[index];
+            data.swap_slots(*data.container, data.container->get_component_index(entity), group_data.size);
+        }
+        group_data.size += 1;
+    }
+
+    inline void ECS::leave_group(i64 const group, Entity const entity) {
+        Group_Data& group_data = *groups[group];
+        Component_Container_Base const& first = *containers[group_data.containers[0]].container;
+        if (!first.has(entity) || first.get_component_index(entity) >= group_data.size) {
+            return;
+        }
+
+        group_data.size -= 1;
+        for (i64 const index: group_data.containers) {
+            Components_Container_Data& data = containers[index];
+            data.swap_slots(*data.container, data.container->get_component_index(entity), group_data.size);
+        }
     }
 
     template <typename T>
     inline Component_Container<T>* ECS::ensure_container() {
-        u64 const type = type_identifier<T>();
-        for (auto& data: containers) {
-            if (data.family == type) {
-                return static_cast<Component_Container<T>*>(data.container);
-            }
+        return static_cast<Component_Container<T>*>(ensure_container_data<T>()->container);
+    }
+
+    template <typename T>
+    inline ECS::Components_Container_Data* ECS::ensure_container_data() {
+        if (Components_Container_Data* const data = find_container_data<T>()) {
+            return data;
         }
 
         auto& data = containers.emplace_back();
@@ -242,54 +1036,67 @@ namespace anton_engine {
             containers.pop_back();
             throw;
         }
-        data.family = type;
+        data.family = type_identifier<T>();
+        data.type_index = component_type_index<T>();
         data.remove = [](Component_Container_Base& container, Entity const entity) { static_cast<Component_Container<T>&>(container).remove(entity); };
+        data.remove_marked = [](Component_Container_Base& container, u64 const* const marked, i64 const marked_count) {
+            static_cast<Component_Container<T>&>(container).remove_marked(marked, marked_count);
+        };
         data.make_snapshot = [](Component_Container_Base const& container) -> Component_Container_Base* {
             Component_Container<T> const& c = static_cast<Component_Container<T> const&>(container);
             return new Component_Container<T>(c);
         };
-        return static_cast<Component_Container<T>*>(data.container);
+        data.update_snapshot = Component_Container<T>::update_snapshot;
+        data.swap_slots = [](Component_Container_Base& container, i64 const a, i64 const b) {
+            static_cast<Component_Container<T>&>(container).swap_slots(a, b);
+        };
+        set_container_index(data.type_index, containers.size() - 1);
+        return &data;
     }
 
     template <typename T>
     inline Component_Container<T> const* ECS::find_container() const {
-        u64 const type = type_identifier<T>();
-        for (auto& data: containers) {
-            if (data.family == type) {
-                return static_cast<Component_Container<T> const*>(data.container);
-            }
-        }
-        return nullptr;
+        Components_Container_Data const* const data = find_container_data<T>();
+        return data ? static_cast<Component_Container<T> const*>(data->container) : nullptr;
     }
 
     template <typename T>
     inline Component_Container<T>* ECS::find_container() {
-        u64 const type = type_identifier<T>();
-        for (auto& data: containers) {
-            if (data.family == type) {
-                return static_cast<Component_Container<T>*>(data.container);
-            }
-        }
-        return nullptr;
+        Components_Container_Data* const data = find_container_data<T>();
+        return data ? static_cast<Component_Container<T>*>(data->container) : nullptr;
     }
 
     template <typename T>
     inline ECS::Components_Container_Data* ECS::find_container_data() {
-        u64 const type = type_identifier<T>();
-        for (auto& data: containers) {
-            if (data.family == type) {
-                return &data;
+        i64 const type_index = component_type_index<T>();
+        if (type_index < container_table.size()) {
+            i64 const container_index = container_table[type_index];
+            if (container_index != -1) {
+                return &containers[container_index];
             }
         }
         return nullptr;
     }
 
+    template <typename T>
+    inline void ECS::copy_archetype_components(ECS& snapshot) const {
+        Component_Container<T>* const container = snapshot.ensure_container<T>();
+        archetypes->for_each<T>([container](Entity const entity, T const& component) {
+            if constexpr (atl::is_empty<T>) {
+                container->add(entity);
+            } else {
+                container->add(entity, component);
+            }
+        });
+    }
+
     template <typename T>
     inline ECS::Components_Container_Data const* ECS::find_container_data() const {
-        u64 const type = type_identifier<T>();
-        for (auto& data: containers) {
-            if (data.family == type) {
-                return &data;
+        i64 const type_index = component_type_index<T>();
+        if (type_index < container_table.size()) {
+            i64 const container_index = container_table[type_index];
+            if (container_index != -1) {
+                return &containers[container_index];
             }
         }
         return nullptr;
@@ -1,7 +1,9 @@
 #ifndef ENGINE_ECS_ENTITY_HPP_INCLUDE
 #define ENGINE_ECS_ENTITY_HPP_INCLUDE
 
+#include <core/atl/detail/functors.hpp>
 #include <core/atl/utility.hpp>
+#include <core/hashing/wyhash.hpp>
 #include <core/types.hpp>
 #include <core/serialization/serialization.hpp>
 
@@ -13,6 +15,11 @@ namespace anton_engine {
 
     constexpr Entity null_entity{static_cast<u64>(-1)};
 
+    // The last generation ECS::create hands out for an index. Indices whose entity is destroyed at this generation
+    // are retired instead of recycled, so stale handles never become valid again and no entity equals null_entity.
+    // Generation 0xFFFFFFFF is never given to a live entity and is reserved for the placeholders of Command_Buffer.
+    constexpr u64 max_entity_generation = 0xFFFFFFFE;
+
     [[nodiscard]] constexpr u64 entity_index(Entity const entity) {
         return entity.id & 0xFFFFFFFF;
     }
@@ -21,6 +28,10 @@ namespace anton_engine {
         return (entity.id >> 32) & 0xFFFFFFFF;
     }
 
+    [[nodiscard]] constexpr Entity make_entity(u64 const index, u64 const generation) {
+        return Entity{((generation & 0xFFFFFFFF) << 32) | (index & 0xFFFFFFFF)};
+    }
+
     [[nodiscard]] constexpr bool operator==(Entity const& lhs, Entity const& rhs) {
         return lhs.id == rhs.id;
     }
@@ -32,8 +43,21 @@ namespace anton_engine {
     constexpr void swap(Entity& e1, Entity& e2) {
         atl::swap(e1.id, e2.id);
     }
+
+    [[nodiscard]] constexpr u64 hash(Entity const entity) {
+        return wyhash_u64(entity.id);
+    }
 } // namespace anton_engine
 
+namespace anton_engine::atl {
+    template<>
+    struct Default_Hash<Entity> {
+        u64 operator()(Entity const entity) const {
+            return hash(entity);
+        }
+    };
+} // namespace anton_engine::atl
+
 ANTON_DEFAULT_SERIALIZABLE(anton_engine::Entity)
 
 #endif // !ENGINE_ECS_ENTITY_HPP_INCLUDE
@@ -1,6 +1,9 @@
 #ifndef ENGINE_ECS_JOBS_HPP_INCLUDE
 #define ENGINE_ECS_JOBS_HPP_INCLUDE
 
+#include <core/assert.hpp>
+#include <core/atl/utility.hpp>
+#include <core/atl/vector.hpp>
 #include <core/types.hpp>
 
 namespace anton_engine {
@@ -11,6 +14,104 @@ namespace anton_engine {
         virtual void execute() = 0;
     };
 
-    i64 schedule_job(Job*);
+    // Function_Job
+    // Adapts a callable to the Job interface.
+    //
+    template <typename Callable>
+    class Function_Job: public Job {
+    public:
+        Function_Job(Callable c): callable(atl::move(c)) {}
+
+        void execute() override {
+            callable();
+        }
+
+    private:
+        Callable callable;
+    };
+
+    // Job_Handle
+    // Identifies a scheduled job. The handle remains valid after the job has completed
+    // and keeps reporting the job as completed.
+    //
+    struct Job_Handle {
+        u32 slot;
+        u32 generation;
+    };
+
+    constexpr Job_Handle null_job_handle{static_cast<u32>(-1), 0};
+
+    [[nodiscard]] constexpr bool operator==(Job_Handle const lhs, Job_Handle const rhs) {
+        return lhs.slot == rhs.slot && lhs.generation == rhs.generation;
+    }
+
+    [[nodiscard]] constexpr bool operator!=(Job_Handle const lhs, Job_Handle const rhs) {
+        return !(lhs == rhs);
+    }
+
+    // schedule_job
+    // Queues job for execution on the worker threads. The job object is not owned by the scheduler
+    // and must outlive the execution of the job. May be called from the main thread or from within jobs.
+    //
+    // parent: Job that does not complete until job completes. Must not have completed yet.
+    //
+    // Returns: Handle that can be waited on.
+    //
+    Job_Handle schedule_job(Job* job, Job_Handle parent = null_job_handle);
+
+    // add_continuation
+    // Queues continuation for execution once predecessor and all of its children have completed.
+    // If predecessor has already completed, continuation is queued immediately.
+    //
+    // Returns: Handle of continuation.
+    //
+    Job_Handle add_continuation(Job_Handle predecessor, Job* continuation);
+
+    // wait_for_job
+    // Blocks until job and all of its children have completed.
+    // The calling thread executes queued jobs while it waits.
+    //
+    void wait_for_job(Job_Handle job);
+
+    [[nodiscard]] bool is_job_completed(Job_Handle job);
+
+    // Returns: Handle of the job executing on the calling thread or null_job_handle if there is none.
+    [[nodiscard]] Job_Handle get_current_job();
+
+    // Returns: Number of threads executing jobs including the main thread.
+    [[nodiscard]] i64 get_job_thread_count();
+
+    // parallel_for
+    // Splits [0, count[ into ranges of grain_size elements and calls callable(first, last) for every range
+    // on the job threads. The calling thread processes the first range itself and then helps with the rest.
+    // Returns after all ranges have been processed.
+    //
+    template <typename Callable>
+    void parallel_for(i64 const count, i64 const grain_size, Callable&& callable) {
+        ANTON_ASSERT(grain_size > 0, "grain_size must be greater than 0.");
+        if (count <= grain_size || get_job_thread_count() <= 1) {
+            if (count > 0) {
+                callable(i64(0), count);
+            }
+            return;
+        }
+
+        auto make_range = [&callable](i64 const first, i64 const last) { return [&callable, first, last]() { callable(first, last); }; };
+        using Range_Job = Function_Job<decltype(make_range(0, 0))>;
+        i64 const range_count = (count + grain_size - 1) / grain_size;
+        // Reserved up front so that the jobs do not move once scheduled.
+        atl::Vector<Range_Job> jobs(atl::reserve, range_count - 1);
+        atl::Vector<Job_Handle> handles(atl::reserve, range_count - 1);
+        for (i64 first = grain_size; first < count; first += grain_size) {
+            i64 const last = count - first > grain_size ? first + grain_size : count;
+            jobs.emplace_back(make_range(first, last));
+            handles.push_back(schedule_job(&jobs[jobs.size() - 1]));
+        }
+
+        callable(i64(0), grain_size);
+        for (Job_Handle const handle: handles) {
+            wait_for_job(handle);
+        }
+    }
 } // namespace anton_engine
 #endif // !ENGINE_ECS_JOBS_HPP_INCLUDE
@@ -1,13 +1,79 @@
 #ifndef ENGINE_ECS_SYSTEM_HPP_INCLUDE
 #define ENGINE_ECS_SYSTEM_HPP_INCLUDE
 
+#include <core/atl/vector.hpp>
+#include <core/types.hpp>
+#include <engine/ecs/component_type.hpp>
+#include <engine/ecs/ecs.hpp>
+
 namespace anton_engine {
+    // System
+    // Systems declare the components they access in update() by calling reads and writes in the constructor
+    // or in start(). The schedule is built once all systems have been started, later declarations are ignored.
+    // Systems whose accesses do not conflict are updated concurrently on the job threads. Systems that write
+    // a component another system reads or writes are updated in the order in which they have been created.
+    // A system that does not declare any access is assumed to access everything and is never updated
+    // concurrently with other systems.
+    //
+    // While updated concurrently, systems must not create or destroy entities, add or remove components
+    // or access components they have not declared. Components declared with reads may be looked up through
+    // non-const member functions, but must not be modified. With ANTON_ECS_ACCESS_DEBUG the ECS verifies
+    // that a system accesses only the declared components and that it does not add, remove, sort, patch
+    // or mark dirty components it has declared with reads. Writes through references cannot be detected.
+    //
     class System {
     public:
+        struct Component_Access {
+            i64 type_index;
+            bool write;
+            // Creates the container of the component before the systems are updated so that
+            // concurrently running systems do not create it.
+            void (*prepare)(ECS&);
+        };
+
         virtual ~System() {}
 
         virtual void start() {}
         virtual void update() = 0;
+
+        [[nodiscard]] bool declares_access() const {
+            return access_declared;
+        }
+
+        [[nodiscard]] atl::Vector<Component_Access> const& get_component_access() const {
+            return component_access;
+        }
+
+    protected:
+        // Calling reads or writes without any components declares that the system does not access any components.
+        template <typename... Components>
+        void reads() {
+            access_declared = true;
+            (..., declare_access<Components>(false));
+        }
+
+        template <typename... Components>
+        void writes() {
+            access_declared = true;
+            (..., declare_access<Components>(true));
+        }
+
+    private:
+        atl::Vector<Component_Access> component_access;
+        bool access_declared = false;
+
+        template <typename T>
+        void declare_access(bool const write) {
+            i64 const type_index = component_type_index<T>();
+            for (Component_Access& access: component_access) {
+                if (access.type_index == type_index) {
+                    access.write = access.write || write;
+                    return;
+                }
+            }
+
+            component_access.push_back({type_index, write, [](ECS& ecs) { ecs.view<T>(); }});
+        }
     };
 } // namespace anton_engine
 
@@ -1,8 +1,8 @@
 #ifndef ENGINE_INPUT_INPUT_HPP_INCLUDE
 #define ENGINE_INPUT_INPUT_HPP_INCLUDE
 
+#include <core/name.hpp>
 #include <core/types.hpp>
-#include <core/atl/string_view.hpp>
 #include <engine/key.hpp>
 
 namespace anton_engine::input {
@@ -35,12 +35,12 @@ namespace anton_engine::input {
     // raw_value_scale - Scale by which to multiply raw value obtained from input devices.
     // accumulation_speed - How fast to accumulate axis value in units/s.
     // snap - If raw value changes sign, should we reset to 0 or continue from current value?
-    void add_axis(atl::String_View name, Key, f32 raw_value_scale, f32 accumulation_speed, bool snap);
-    void add_action(atl::String_View name, Key);
+    void add_axis(Name name, Key, f32 raw_value_scale, f32 accumulation_speed, bool snap);
+    void add_action(Name name, Key);
 
-    [[nodiscard]] f32 get_axis(atl::String_View axis);
-    [[nodiscard]] f32 get_axis_raw(atl::String_View axis);
-    [[nodiscard]] Action_State get_action(atl::String_View action);
+    [[nodiscard]] f32 get_axis(Name axis);
+    [[nodiscard]] f32 get_axis_raw(Name axis);
+    [[nodiscard]] Action_State get_action(Name action);
     [[nodiscard]] Key_State get_key_state(Key);
     // [[nodiscard]] Any_Key_State get_any_key_state();
 } // namespace anton_engine::input
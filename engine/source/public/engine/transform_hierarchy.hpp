@@ -0,0 +1,65 @@
+#ifndef ENGINE_TRANSFORM_HIERARCHY_HPP_INCLUDE
+#define ENGINE_TRANSFORM_HIERARCHY_HPP_INCLUDE
+
+#include <core/atl/vector.hpp>
+#include <core/math/matrix4.hpp>
+#include <core/types.hpp>
+#include <engine/components/transform.hpp>
+#include <engine/ecs/ecs.hpp>
+#include <engine/ecs/entity.hpp>
+
+namespace anton_engine {
+    // Transform_Hierarchy
+    // Computes the world matrices of the entities with Transform and stores them in their World_Transform components.
+    // The entities are kept in a flat array sorted by depth, in which every entity comes after its parent,
+    // along with the index of the parent of each entity. That lets update compute the world matrices
+    // in a single forward pass that recomputes only the subtrees whose local transforms have changed.
+    // The changed transforms are found through the change tracking of the ECS, therefore code that modifies
+    // a Transform must do so with ECS::patch or call ECS::mark_dirty afterwards.
+    // The flat array is rebuilt when Transform or Hierarchy components are added or removed
+    // or the hierarchy is modified with set_parent.
+    // Requires ECS with Storage_Mode::sparse_set.
+    //
+    class Transform_Hierarchy {
+    public:
+        explicit Transform_Hierarchy(ECS& ecs);
+        Transform_Hierarchy(Transform_Hierarchy const&) = delete;
+        Transform_Hierarchy& operator=(Transform_Hierarchy const&) = delete;
+        ~Transform_Hierarchy();
+
+        // Attaches child to parent, adding the Hierarchy components if necessary.
+        // null_entity detaches child from its parent.
+        // parent must not be a descendant of child.
+        void set_parent(Entity child, Entity parent);
+
+        // Recomputes the world matrices of the entities whose local transforms have changed and of their descendants.
+        // Adds World_Transform to the entities with Transform that do not have it yet.
+        void update();
+
+        // Returns: World matrix of entity computed by the last update or identity if entity has not been updated.
+        [[nodiscard]] Matrix4 get_world_matrix(Entity entity) const;
+
+    private:
+        ECS* ecs;
+        ECS::Observer_Handle observers[4];
+
+        // Entities sorted by depth in the hierarchy.
+        atl::Vector<Entity> nodes;
+        // Index of the parent of the node or -1 for roots.
+        atl::Vector<i64> parents;
+        atl::Vector<Matrix4> world_matrices;
+        atl::Vector<u8> dirty;
+        // Index of the node of an entity indexed by the index of the entity or -1.
+        atl::Vector<i64> node_indices;
+        // Change tick recorded by the last update.
+        u64 last_change_tick = 0;
+        bool structure_changed = true;
+
+        [[nodiscard]] i64 find_node(Entity entity) const;
+        void rebuild();
+        static void on_structure_changed(ECS&, Entity, void* user_data);
+        static void on_hierarchy_destroyed(ECS&, Entity, void* user_data);
+    };
+} // namespace anton_engine
+
+#endif // !ENGINE_TRANSFORM_HIERARCHY_HPP_INCLUDE
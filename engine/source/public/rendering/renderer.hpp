@@ -84,8 +84,8 @@ namespace anton_engine::rendering {
     void add_draw_command(Draw_Persistent_Geometry_Command);
     void commit_draw();
 
-    // objects - snapshot of ecs containing Static_Mesh_Components and Transforms
-    void render_scene(ECS objects, Transform camera_transform, Matrix4 view, Matrix4 projection);
+    // objects - snapshot of ecs containing Static_Mesh_Components, Transforms and optionally World_Transforms
+    void render_scene(ECS const& objects, Transform camera_transform, Matrix4 view, Matrix4 projection);
 
     // Render a quad taking up the whole viewport
     // Intended for rendering textures to the screen or applying postprocessing effects
@@ -1,8 +1,8 @@
 #ifndef SHADERS_SHADER_HPP_INCLUDE
 #define SHADERS_SHADER_HPP_INCLUDE
 
+#include <core/name.hpp>
 #include <core/types.hpp>
-#include <core/atl/string_view.hpp>
 #include <core/atl/type_traits.hpp>
 #include <core/atl/flat_hash_map.hpp>
 #include <core/math/vector2.hpp>
@@ -28,14 +28,14 @@ namespace anton_engine {
         void use();
         void detach(Shader_File const&);
 
-        void set_int(atl::String_View, i32);
-        void set_uint(atl::String_View, u32);
-        void set_float(atl::String_View, f32);
-        void set_vec2(atl::String_View, Vector2);
-        void set_vec3(atl::String_View, Vector3);
-        void set_vec3(atl::String_View, Color);
-        void set_vec4(atl::String_View, Color);
-        void set_matrix4(atl::String_View, Matrix4 const&);
+        void set_int(Name, i32);
+        void set_uint(Name, u32);
+        void set_float(Name, f32);
+        void set_vec2(Name, Vector2);
+        void set_vec3(Name, Vector3);
+        void set_vec3(Name, Color);
+        void set_vec4(Name, Color);
+        void set_matrix4(Name, Matrix4 const&);
 
         u32 get_shader_native_handle() const {
             return program;
@@ -45,7 +45,8 @@ namespace anton_engine {
         friend void delete_shader(Shader&);
 
     private:
-        atl::Flat_Hash_Map<u64, i32> uniform_cache;
+        // Locations of the active uniforms keyed by their names.
+        atl::Flat_Hash_Map<Name, i32> uniform_cache;
         u32 program = 0;
     };
 
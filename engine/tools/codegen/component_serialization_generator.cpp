@@ -89,7 +89,7 @@ int main(int argc, char** argv) {
                    << indent(2) << "static atl::Vector<Component_Serialization_Funcs> serialization_funcs{atl::variadic_construct,\n";
     i32 component_index = 1;
     for (auto& [include_directory, name]: components) {
-        generated_file << indent(3) << "Component_Serialization_Funcs{Type_Family::family_id<" << name << ">(), &Component_Container<" << name
+        generated_file << indent(3) << "Component_Serialization_Funcs{type_identifier<" << name << ">(), &Component_Container<" << name
                        << ">::serialize, &Component_Container<" << name << ">::deserialize}";
         if (component_index < components.size()) {
             generated_file << ",\n";